@@ -0,0 +1,92 @@
+#pragma once
+
+#include "core/api/engine_api.h"
+#include "core/engine.h"
+
+
+/*!
+    @file bench.h
+    @brief Scene-level benchmark suite (`golias_bench`).
+
+    Every scenario builds a scene of `count` entities, runs `warmup_frames` unmeasured frames and then
+    `frames` measured frames with a fixed timestep and no frame pacing. Frame time, per-zone time (from the
+    Profiler, so every flecs system is included) and `operator new` calls are collected per frame and
+    reported as mean/p50/p95/p99 in CSV and JSON.
+
+    @version 0.0.1
+*/
+
+
+/*!
+    @brief Command line options of `golias_bench`.
+*/
+struct BenchOptions {
+    Backend backend         = Backend::AUTO;
+    std::string backend_str = "sdl";
+    std::string scenario    = "all";
+    std::string output      = "user://bench";
+    std::string model_path  = "res://sprites/obj/godette/godette.glb";
+    int count               = 0; /// 0 uses the scenario default
+    int frames              = 600;
+    int warmup_frames       = 60;
+    double fixed_delta      = 1.0 / 60.0;
+};
+
+/*!
+    @brief mean/p50/p95/p99 of a series of samples.
+*/
+struct BenchStats {
+    double mean = 0.0;
+    double p50  = 0.0;
+    double p95  = 0.0;
+    double p99  = 0.0;
+    double max  = 0.0;
+
+    static BenchStats from_samples(std::vector<double> samples);
+};
+
+/*!
+    @brief Per-frame time of a profiler zone (summed over every thread and call in the frame).
+*/
+struct BenchZone {
+    std::string name;
+    BenchStats stats_ms;
+};
+
+struct BenchResult {
+    std::string scenario;
+    std::string backend;
+    int count  = 0;
+    int frames = 0;
+
+    BenchStats frame_ms;
+    BenchStats allocations; /// `operator new` calls per frame
+    Uint64 total_allocations = 0;
+
+    std::vector<BenchZone> zones;
+};
+
+/*!
+    @brief A canned scene. `setup` returns false if the scenario cannot run (e.g. missing asset).
+*/
+struct BenchScenario {
+    const char* name        = "";
+    const char* description = "";
+    int default_count       = 1000;
+
+    std::function<bool(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options)> setup;
+
+    /// Optional, called before every frame (measured or not)
+    std::function<void(flecs::world& world, int frame)> on_frame;
+};
+
+const std::vector<BenchScenario>& get_bench_scenarios();
+
+/*!
+    @brief Number of `operator new` calls since the start of the process.
+*/
+Uint64 get_allocation_count();
+
+bool write_bench_csv(const std::vector<BenchResult>& results, const std::string& path);
+
+bool write_bench_json(const std::vector<BenchResult>& results, const std::string& path);
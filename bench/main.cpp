@@ -0,0 +1,277 @@
+#include "bench.h"
+#include <SDL3/SDL_main.h>
+
+#include <atomic>
+#include <new>
+
+
+#pragma region ALLOCATION_COUNTER
+
+static std::atomic<Uint64> g_allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+Uint64 get_allocation_count() {
+    return g_allocation_count.load(std::memory_order_relaxed);
+}
+
+#pragma endregion
+
+
+namespace {
+
+    void print_usage() {
+        SDL_Log("Usage: golias_bench [options]");
+        SDL_Log("  --backend <sdl|gl|null>   renderer backend (default sdl)");
+        SDL_Log("  --scenario <name|all>     scenario to run (default all)");
+        SDL_Log("  --count <n>               entities per scenario (default: per scenario)");
+        SDL_Log("  --frames <n>              measured frames (default 600)");
+        SDL_Log("  --warmup <n>              unmeasured frames before measuring (default 60)");
+        SDL_Log("  --model <path>            model for the `models` scenario");
+        SDL_Log("  --output <path>           output prefix, writes <path>.csv and <path>.json (default user://bench)");
+
+        for (const auto& scenario : get_bench_scenarios()) {
+            SDL_Log("  scenario %-14s %s (default N=%d)", scenario.name, scenario.description, scenario.default_count);
+        }
+    }
+
+    bool parse_options(int argc, char* argv[], BenchOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const char* value     = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (arg == "--help" || arg == "-h") {
+                return false;
+            }
+
+            if (!value) {
+                SDL_Log("Missing value for %s", arg.c_str());
+                return false;
+            }
+
+            if (arg == "--backend") {
+                options.backend_str = value;
+                if (options.backend_str == "sdl") {
+                    options.backend = Backend::AUTO;
+                } else if (options.backend_str == "gl") {
+                    options.backend = Backend::GL_COMPATIBILITY;
+                } else if (options.backend_str == "null") {
+                    options.backend = Backend::NONE;
+                } else {
+                    SDL_Log("Unknown backend %s", value);
+                    return false;
+                }
+            } else if (arg == "--scenario") {
+                options.scenario = value;
+            } else if (arg == "--count") {
+                options.count = SDL_atoi(value);
+            } else if (arg == "--frames") {
+                options.frames = SDL_max(1, SDL_atoi(value));
+            } else if (arg == "--warmup") {
+                options.warmup_frames = SDL_max(0, SDL_atoi(value));
+            } else if (arg == "--model") {
+                options.model_path = value;
+            } else if (arg == "--output") {
+                options.output = value;
+            } else {
+                SDL_Log("Unknown option %s", arg.c_str());
+                return false;
+            }
+
+            i++;
+        }
+
+        return true;
+    }
+
+    /*!
+        Sums the duration of every zone name recorded during the frame. Nested zones with the same name
+        (recursion) would be counted twice, none of the engine zones nest that way.
+    */
+    void collect_frame_zones(std::unordered_map<std::string, std::vector<double>>& zone_samples, int frame_index) {
+        std::unordered_map<const char*, double> frame_ms;
+
+        Profiler::get_instance().for_each_event([&](const std::string& thread_name, const ProfileEvent& event) {
+            if (event.name) {
+                frame_ms[event.name] += static_cast<double>(event.end_ns - event.start_ns) / 1e6;
+            }
+        });
+        Profiler::get_instance().clear();
+
+        for (const auto& [name, ms] : frame_ms) {
+            auto& samples = zone_samples[name];
+
+            // Zones missing in earlier frames count as 0 ms there
+            samples.resize(static_cast<size_t>(frame_index), 0.0);
+            samples.push_back(ms);
+        }
+    }
+
+    BenchResult run_scenario(const BenchScenario& scenario, const BenchOptions& options) {
+        auto& world     = GEngine->get_world();
+        const int count = options.count > 0 ? options.count : scenario.default_count;
+
+        BenchResult result;
+        result.scenario = scenario.name;
+        result.backend  = options.backend_str;
+        result.count    = count;
+
+        world.each([](flecs::entity e, tags::Scene) { e.remove<tags::ActiveScene>(); });
+
+        auto scene = world.entity("BenchScene").add<tags::Scene>().add<tags::ActiveScene>();
+
+        if (!scenario.setup(world, scene, count, options)) {
+            LOG_WARN("Bench: skipping scenario %s", scenario.name);
+            scene.destruct();
+            return result;
+        }
+
+        LOG_INFO("Bench: running %s (N=%d, %d warmup + %d frames, backend %s)", scenario.name, count, options.warmup_frames, options.frames,
+                 options.backend_str.c_str());
+
+        std::vector<double> frame_ms;
+        std::vector<double> allocations;
+        std::unordered_map<std::string, std::vector<double>> zone_samples;
+
+        frame_ms.reserve(options.frames);
+        allocations.reserve(options.frames);
+
+        const Uint64 freq = SDL_GetPerformanceFrequency();
+
+        for (int frame = 0; frame < options.warmup_frames + options.frames && GEngine->is_running; frame++) {
+            if (scenario.on_frame) {
+                scenario.on_frame(world, frame);
+            }
+
+            const bool is_measured = frame >= options.warmup_frames;
+
+            Profiler::get_instance().clear();
+
+            const Uint64 allocations_before = get_allocation_count();
+            const Uint64 start              = SDL_GetPerformanceCounter();
+
+            engine_core_loop();
+
+            const Uint64 end               = SDL_GetPerformanceCounter();
+            const Uint64 allocations_after = get_allocation_count();
+
+            if (!is_measured) {
+                continue;
+            }
+
+            frame_ms.push_back(static_cast<double>(end - start) * 1000.0 / static_cast<double>(freq));
+            allocations.push_back(static_cast<double>(allocations_after - allocations_before));
+            result.total_allocations += allocations_after - allocations_before;
+
+            collect_frame_zones(zone_samples, static_cast<int>(frame_ms.size()) - 1);
+        }
+
+        result.frames      = static_cast<int>(frame_ms.size());
+        result.frame_ms    = BenchStats::from_samples(frame_ms);
+        result.allocations = BenchStats::from_samples(allocations);
+
+        for (auto& [name, samples] : zone_samples) {
+            samples.resize(frame_ms.size(), 0.0);
+            result.zones.push_back({name, BenchStats::from_samples(samples)});
+        }
+
+        std::sort(result.zones.begin(), result.zones.end(), [](const BenchZone& a, const BenchZone& b) { return a.stats_ms.mean > b.stats_ms.mean; });
+
+        LOG_INFO("Bench: %s -> mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, %.1f allocations/frame", scenario.name, result.frame_ms.mean,
+                 result.frame_ms.p50, result.frame_ms.p95, result.frame_ms.p99, result.allocations.mean);
+
+        scene.destruct();
+
+        // Let deferred deletes and script `_exit` callbacks run outside the next measurement
+        engine_core_loop();
+
+        return result;
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    GEngine->backend_override = options.backend;
+
+    if (!GEngine->initialize(1280, 720, "Golias Bench")) {
+        SDL_Log("Failed to initialize engine");
+        return 1;
+    }
+
+    // Measure the raw frame cost: no pacing, no vsync, a fixed simulation step
+    GEngine->get_frame_pacer().set_target_fps(0);
+    GEngine->get_frame_pacer().set_background_fps(0);
+    GEngine->get_frame_pacer().set_vsync(false);
+    GEngine->get_config().set_vsync_mode(VSyncMode::DISABLED);
+
+    if (options.backend != Backend::NONE) {
+        GEngine->get_renderer()->set_vsync(VSyncMode::DISABLED);
+    }
+    GEngine->get_timer().fixed_frame_delta = options.fixed_delta;
+    GEngine->get_timer().fixed_delta       = options.fixed_delta;
+
+    Profiler::get_instance().set_enabled(true);
+
+    // Consume the OnStart frame with an empty world
+    engine_core_loop();
+
+    std::vector<BenchResult> results;
+
+    for (const auto& scenario : get_bench_scenarios()) {
+        if (options.scenario != "all" && options.scenario != scenario.name) {
+            continue;
+        }
+
+        BenchResult result = run_scenario(scenario, options);
+
+        if (result.frames > 0) {
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (results.empty()) {
+        SDL_Log("No scenario was run (%s)", options.scenario.c_str());
+        return 1;
+    }
+
+    const std::string prefix = options.output + "_" + options.backend_str;
+
+    const bool is_written = write_bench_csv(results, prefix + ".csv") && write_bench_json(results, prefix + ".json");
+
+    return is_written ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#include "bench.h"
+
+
+BenchStats BenchStats::from_samples(std::vector<double> samples) {
+    BenchStats stats;
+
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (const double sample : samples) {
+        sum += sample;
+    }
+
+    // Nearest-rank percentile
+    const auto percentile = [&](double q) {
+        const size_t rank = static_cast<size_t>(SDL_ceil(q * static_cast<double>(samples.size())));
+        return samples[SDL_clamp(rank, static_cast<size_t>(1), samples.size()) - 1];
+    };
+
+    stats.mean = sum / static_cast<double>(samples.size());
+    stats.p50  = percentile(0.50);
+    stats.p95  = percentile(0.95);
+    stats.p99  = percentile(0.99);
+    stats.max  = samples.back();
+    return stats;
+}
+
+
+namespace {
+
+    void append_stats_csv(std::string& out, const BenchStats& stats) {
+        char line[160];
+        SDL_snprintf(line, sizeof(line), "%.4f,%.4f,%.4f,%.4f,%.4f", stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+        out += line;
+    }
+
+    nlohmann::json stats_to_json(const BenchStats& stats) {
+        return {{"mean", stats.mean}, {"p50", stats.p50}, {"p95", stats.p95}, {"p99", stats.p99}, {"max", stats.max}};
+    }
+
+    bool write_file(const std::string& path, const std::string& content) {
+        FileAccess file(path, ModeFlags::WRITE);
+
+        if (!file.is_open() || !file.store_string(content)) {
+            LOG_ERROR("Bench: failed to write %s", path.c_str());
+            return false;
+        }
+
+        LOG_INFO("Bench: results written to %s", file.get_absolute_path().c_str());
+        return true;
+    }
+
+} // namespace
+
+
+bool write_bench_csv(const std::vector<BenchResult>& results, const std::string& path) {
+    // One row per (scenario, zone), the "frame" and "allocations" rows carry the totals
+    std::string csv = "scenario,backend,count,frames,metric,mean,p50,p95,p99,max\n";
+
+    for (const auto& result : results) {
+        char prefix[256];
+        SDL_snprintf(prefix, sizeof(prefix), "%s,%s,%d,%d,", result.scenario.c_str(), result.backend.c_str(), result.count, result.frames);
+
+        csv += prefix;
+        csv += "frame_ms,";
+        append_stats_csv(csv, result.frame_ms);
+        csv += '\n';
+
+        csv += prefix;
+        csv += "allocations,";
+        append_stats_csv(csv, result.allocations);
+        csv += '\n';
+
+        for (const auto& zone : result.zones) {
+            csv += prefix;
+            csv += '"' + zone.name + "\",";
+            append_stats_csv(csv, zone.stats_ms);
+            csv += '\n';
+        }
+    }
+
+    return write_file(path, csv);
+}
+
+bool write_bench_json(const std::vector<BenchResult>& results, const std::string& path) {
+    nlohmann::json root = nlohmann::json::array();
+
+    for (const auto& result : results) {
+        nlohmann::json zones = nlohmann::json::object();
+        for (const auto& zone : result.zones) {
+            zones[zone.name] = stats_to_json(zone.stats_ms);
+        }
+
+        root.push_back({
+            {"scenario", result.scenario},
+            {"backend", result.backend},
+            {"count", result.count},
+            {"frames", result.frames},
+            {"frame_ms", stats_to_json(result.frame_ms)},
+            {"allocations_per_frame", stats_to_json(result.allocations)},
+            {"total_allocations", result.total_allocations},
+            {"zones_ms", zones},
+        });
+    }
+
+    return write_file(path, root.dump(2));
+}
@@ -0,0 +1,179 @@
+#include "bench.h"
+
+
+namespace {
+
+    constexpr const char* BENCH_SCRIPT_PATH = "user://bench_process.lua";
+
+    // Typical per-frame script work: read input, move the entity, a bit of math
+    constexpr const char* BENCH_SCRIPT = R"(
+local speed = 40
+local t = 0
+
+function _process(dt)
+    t = t + dt
+    local direction = Input.get_vector("move_left", "move_right", "move_up", "move_down")
+    self.transform.position.x = self.transform.position.x + (direction.x + math.sin(t)) * speed * dt
+    self.transform.position.y = self.transform.position.y + (direction.y + math.cos(t)) * speed * dt
+end
+)";
+
+    glm::vec2 grid_position(int i, int count, float spacing) {
+        const int columns = SDL_max(1, static_cast<int>(SDL_ceil(SDL_sqrt(static_cast<double>(count)))));
+        return {static_cast<float>(i % columns) * spacing, static_cast<float>(i / columns) * spacing};
+    }
+
+    void add_camera_2d(flecs::world& world, flecs::entity scene) {
+        world.entity().set<Camera2D>({}).add<tags::MainCamera>().child_of(scene);
+    }
+
+    void add_camera_3d(flecs::world& world, flecs::entity scene) {
+        world.entity().set<Transform3D>({.position = {0, 40, 120}, .rotation = {-0.3f, 0, 0}}).add<Camera3D>().child_of(scene);
+    }
+
+    void add_sprites(flecs::world& world, flecs::entity parent, int count) {
+        for (int i = 0; i < count; i++) {
+            world.entity()
+                .set<Transform2D>({grid_position(i, count, 8.0f), {0.25f, 0.25f}, static_cast<float>(i % 360)})
+                .set<Sprite2D>({"bench_icons", {static_cast<float>((i % 4) * 64), 0, 64, 64}})
+                .child_of(parent);
+        }
+    }
+
+    bool setup_sprites(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options) {
+        if (!GEngine->get_renderer()->load_texture("bench_icons", "res://ui/icons/icons_64.png")) {
+            LOG_ERROR("Bench: failed to load res://ui/icons/icons_64.png");
+            return false;
+        }
+
+        add_camera_2d(world, scene);
+        add_sprites(world, scene, count);
+        return true;
+    }
+
+    bool setup_shapes(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options) {
+        add_camera_2d(world, scene);
+
+        for (int i = 0; i < count; i++) {
+            const auto type = i % 3 == 0 ? ShapeType::RECTANGLE : (i % 3 == 1 ? ShapeType::CIRCLE : ShapeType::TRIANGLE);
+
+            world.entity()
+                .set<Transform2D>({grid_position(i, count, 10.0f), {1, 1}, 0})
+                .set<Shape2D>({type, {random_number<float>(0.0f, 1.0f), random_number<float>(0.0f, 1.0f), 1.0f, 1.0f}, i % 2 == 0, {8, 8}, 4})
+                .child_of(scene);
+        }
+
+        return true;
+    }
+
+    bool setup_labels(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options) {
+        add_camera_2d(world, scene);
+
+        for (int i = 0; i < count; i++) {
+            const std::string text = "Label " + std::to_string(i) + (i % 10 == 0 ? " 💀" : "");
+
+            world.entity().set<Transform2D>({grid_position(i, count, 24.0f), {1, 1}, 0}).set<Label2D>({text}).child_of(scene);
+        }
+
+        return true;
+    }
+
+    bool setup_cubes(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options) {
+        add_camera_3d(world, scene);
+
+        for (int i = 0; i < count; i++) {
+            const float angle  = static_cast<float>(i) / static_cast<float>(count) * 360.0f;
+            const float radius = 20.0f + static_cast<float>(i % 80);
+
+            world.entity()
+                .set<MeshInstance3D>({.size = glm::vec3(1.0f), .material = {.albedo = {0.8f, 0.4f, 0.2f}}})
+                .set<Transform3D>({.position = {SDL_cosf(glm::radians(angle)) * radius, 0.0f, SDL_sinf(glm::radians(angle)) * radius},
+                                   .rotation = {0, angle, 0},
+                                   .scale    = {1.0f, 1.0f, 1.0f}})
+                .child_of(scene);
+        }
+
+        return true;
+    }
+
+    bool setup_models(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options) {
+        if (!FileAccess(options.model_path, ModeFlags::READ).is_open()) {
+            LOG_WARN("Bench: model %s not found, pass --model <path>", options.model_path.c_str());
+            return false;
+        }
+
+        add_camera_3d(world, scene);
+
+        for (int i = 0; i < count; i++) {
+            const glm::vec2 position = grid_position(i, count, 3.0f);
+
+            world.entity()
+                .set<Model>({.path = options.model_path})
+                .set<Animation3D>({.time = static_cast<float>(i) * 0.1f})
+                .set<Transform3D>({.position = {position.x, 0.0f, position.y}, .rotation = {0, 0, 0}, .scale = {1.0f, 1.0f, 1.0f}})
+                .child_of(scene);
+        }
+
+        return true;
+    }
+
+    bool setup_scripts(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options) {
+        if (!FileAccess(BENCH_SCRIPT_PATH, ModeFlags::WRITE).store_string(BENCH_SCRIPT)) {
+            LOG_ERROR("Bench: failed to write %s", BENCH_SCRIPT_PATH);
+            return false;
+        }
+
+        add_camera_2d(world, scene);
+
+        for (int i = 0; i < count; i++) {
+            auto e = world.entity()
+                         .set<Transform2D>({grid_position(i, count, 10.0f), {1, 1}, 0})
+                         .set<Shape2D>({ShapeType::RECTANGLE, {0, 1, 0, 1}, true, {4, 4}})
+                         .set<Script>({BENCH_SCRIPT_PATH})
+                         .child_of(scene);
+
+            // `LoadScripts_OnStart` only runs on the first frame, which the bench already consumed
+            setup_scripts_system(e, e.ensure<Script>());
+        }
+
+        return true;
+    }
+
+    bool setup_scene_switch(flecs::world& world, flecs::entity scene, int count, const BenchOptions& options) {
+        if (!GEngine->get_renderer()->load_texture("bench_icons", "res://ui/icons/icons_64.png")) {
+            return false;
+        }
+
+        // Two sub-scenes under the benchmark scene, `on_frame` flips between them
+        auto scene_a = world.entity("BenchSceneA").add<tags::Scene>().add<tags::ActiveScene>().child_of(scene);
+        auto scene_b = world.entity("BenchSceneB").add<tags::Scene>().add(flecs::Disabled).child_of(scene);
+
+        add_camera_2d(world, scene_a);
+        add_camera_2d(world, scene_b);
+        add_sprites(world, scene_a, count / 2);
+        add_sprites(world, scene_b, count / 2);
+        return true;
+    }
+
+    void switch_scene(flecs::world& world, int frame) {
+        if (frame % 10 == 0) {
+            change_scene(frame % 20 == 0 ? "BenchScene::BenchSceneA" : "BenchScene::BenchSceneB");
+        }
+    }
+
+} // namespace
+
+
+const std::vector<BenchScenario>& get_bench_scenarios() {
+    static const std::vector<BenchScenario> scenarios = {
+        {"sprites", "N Sprite2D sharing one texture", 10000, setup_sprites, nullptr},
+        {"shapes", "N Shape2D (rectangles, circles, triangles)", 10000, setup_shapes, nullptr},
+        {"labels", "N Label2D, 10% with emoji", 2000, setup_labels, nullptr},
+        {"cubes", "N MeshInstance3D cubes", 10000, setup_cubes, nullptr},
+        {"models", "N animated models (--model)", 50, setup_models, nullptr},
+        {"scripts", "N Lua scripts with _process", 1000, setup_scripts, nullptr},
+        {"scene_switch", "Two scenes of N/2 sprites, switched every 10 frames", 10000, setup_scene_switch, switch_scene},
+    };
+
+    return scenarios;
+}
@@ -50,13 +50,9 @@ bool entity_is_valid(flecs::entity& e) {
 
 
 glm::vec2 get_mouse_position() {
-    float x, y;
-    SDL_GetMouseState(&x, &y);
-    return {x,y};
+    return GEngine->get_input().get_mouse_position();
 }
 
 bool is_key_pressed(int key_code) {
-
-    const bool* state = SDL_GetKeyboardState(NULL);
-    return state[key_code] != 0;
+    return GEngine->get_input().is_key_held(static_cast<SDL_Scancode>(key_code));
 }
\ No newline at end of file
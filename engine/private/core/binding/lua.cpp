@@ -167,7 +167,106 @@ void push_input_to_lua(lua_State* L) {
     input["is_key_pressed"] = [](int sdl_key_code) -> bool {
         return is_key_pressed(sdl_key_code);
     };
-    
+
+    input["is_key_just_pressed"] = [](int scancode) -> bool {
+        return GEngine->get_input().is_key_pressed(static_cast<SDL_Scancode>(scancode));
+    };
+
+    input["is_key_just_released"] = [](int scancode) -> bool {
+        return GEngine->get_input().is_key_released(static_cast<SDL_Scancode>(scancode));
+    };
+
+    input["is_mouse_button_held"] = [](int button) -> bool {
+        return GEngine->get_input().is_mouse_button_held(static_cast<Uint8>(button));
+    };
+
+    input["get_mouse_delta"] = [](sol::this_state s) -> sol::table {
+        sol::state_view lua(s);
+        const glm::vec2 delta = GEngine->get_input().get_mouse_delta();
+        sol::table result     = lua.create_table();
+        result["x"]           = delta.x;
+        result["y"]           = delta.y;
+        return result;
+    };
+
+    input["get_wheel_delta"] = [](sol::this_state s) -> sol::table {
+        sol::state_view lua(s);
+        const glm::vec2 delta = GEngine->get_input().get_wheel_delta();
+        sol::table result     = lua.create_table();
+        result["x"]           = delta.x;
+        result["y"]           = delta.y;
+        return result;
+    };
+
+    // Actions: pressed/released are edges of this frame, held is the level
+    input["is_action_pressed"] = [](const std::string& action) -> bool {
+        return GEngine->get_input().is_action_pressed(action);
+    };
+
+    input["is_action_held"] = [](const std::string& action) -> bool {
+        return GEngine->get_input().is_action_held(action);
+    };
+
+    input["is_action_released"] = [](const std::string& action) -> bool {
+        return GEngine->get_input().is_action_released(action);
+    };
+
+    input["get_axis"] = [](const std::string& negative, const std::string& positive) -> float {
+        return GEngine->get_input().get_axis(negative, positive);
+    };
+
+    input["get_vector"] = [](sol::this_state s, const std::string& left, const std::string& right, const std::string& up,
+                             const std::string& down) -> sol::table {
+        sol::state_view lua(s);
+        const glm::vec2 direction = GEngine->get_input().get_vector(left, right, up, down);
+        sol::table result         = lua.create_table();
+        result["x"]               = direction.x;
+        result["y"]               = direction.y;
+        return result;
+    };
+
+    // Input.subscribe("jump", function(is_pressed) ... end)
+    // Handlers live in this script's registry, the engine only keeps the lua_State to wake it
+    input["subscribe"] = [](sol::this_state s, const std::string& action, sol::protected_function handler) -> bool {
+        lua_State* L = sol::main_thread(s, s);
+        sol::state_view lua(L);
+
+        if (!GEngine->get_input().has_action(action)) {
+            LOG_ERROR("Input.subscribe: unknown action %s", action.c_str());
+            return false;
+        }
+
+        sol::table handlers = lua.registry()["__input_handlers"].get_or_create<sol::table>();
+        sol::table list     = handlers[action].get_or_create<sol::table>();
+
+        list.add(handler);
+
+        if (list.size() > 1) {
+            return true;
+        }
+
+        return GEngine->get_input().subscribe(action, L, [L](const std::string& name, bool is_pressed) {
+            sol::state_view lua(L);
+            sol::optional<sol::table> list = lua.registry()["__input_handlers"][name];
+
+            if (!list) {
+                return;
+            }
+
+            PROFILE_SCOPE("Lua::Input.subscribe");
+
+            for (const auto& [_, value] : *list) {
+                sol::protected_function fn             = value;
+                const sol::protected_function_result r = fn(is_pressed);
+
+                if (!r.valid()) {
+                    const sol::error err = r;
+                    LOG_ERROR("Error in input handler of action %s: %s", name.c_str(), err.what());
+                }
+            }
+        });
+    };
+
     lua["Input"] = input;
 }
 
@@ -1,11 +1,14 @@
 #include "core/component/components.h"
 
+#include "core/engine.h"
+
 
 Script::~Script() {
     if (lua_state) {
 
         lua_getglobal(lua_state, "_exit");
         if (lua_isfunction(lua_state, -1)) {
+            PROFILE_SCOPE("Lua::_exit");
             if (lua_pcall(lua_state, 0, 0, 0) != LUA_OK) {
                 const char* err = lua_tostring(lua_state, -1);
                 LOG_ERROR("Error running `_exit` in script %s: %s", path.c_str(), err);
@@ -13,6 +16,10 @@ Script::~Script() {
             }
         }
 
+        if (GEngine) {
+            GEngine->get_input().unsubscribe(lua_state);
+        }
+
         lua_close(lua_state);
         lua_state = nullptr;
     }
@@ -0,0 +1,191 @@
+#include "core/component/logic/particle_pool.h"
+
+#include "core/ember_utils.h"
+
+
+void ParticlePool::set_capacity(size_t capacity) {
+    // Streams are padded to whole SIMD registers
+    _capacity = capacity;
+    _stride   = (capacity + 3) & ~static_cast<size_t>(3);
+    _count    = 0;
+
+    _data.assign(_stride * STREAM_COUNT, 0.0f);
+    _data.shrink_to_fit();
+
+    _bounds_min = glm::vec3(FLT_MAX);
+    _bounds_max = glm::vec3(-FLT_MAX);
+}
+
+void ParticlePool::clear() {
+    _count = 0;
+}
+
+float* ParticlePool::stream(Stream stream) {
+    return _data.data() + stream * _stride;
+}
+
+const float* ParticlePool::get_stream(Stream stream) const {
+    return _data.data() + stream * _stride;
+}
+
+bool ParticlePool::emit(glm::vec3 position, glm::vec3 velocity, float lifetime) {
+    if (_count >= _capacity) {
+        return false;
+    }
+
+    const size_t i = _count++;
+
+    stream(POSITION_X)[i]       = position.x;
+    stream(POSITION_Y)[i]       = position.y;
+    stream(POSITION_Z)[i]       = position.z;
+    stream(VELOCITY_X)[i]       = velocity.x;
+    stream(VELOCITY_Y)[i]       = velocity.y;
+    stream(VELOCITY_Z)[i]       = velocity.z;
+    stream(AGE)[i]              = 0.0f;
+    stream(INVERSE_LIFETIME)[i] = lifetime > 0.0f ? 1.0f / lifetime : FLT_MAX;
+
+    return true;
+}
+
+void ParticlePool::update(float dt, glm::vec3 acceleration, float damping, glm::vec4 color_start, glm::vec4 color_end) {
+    _bounds_min = glm::vec3(FLT_MAX);
+    _bounds_max = glm::vec3(-FLT_MAX);
+
+    if (_count == 0) {
+        return;
+    }
+
+    float* position[3] = {stream(POSITION_X), stream(POSITION_Y), stream(POSITION_Z)};
+    float* velocity[3] = {stream(VELOCITY_X), stream(VELOCITY_Y), stream(VELOCITY_Z)};
+    float* color[4]    = {stream(COLOR_R), stream(COLOR_G), stream(COLOR_B), stream(COLOR_A)};
+    float* age         = stream(AGE);
+    float* inverse     = stream(INVERSE_LIFETIME);
+
+    const float keep            = SDL_max(1.0f - damping * dt, 0.0f);
+    const glm::vec3 impulse     = acceleration * dt;
+    const glm::vec4 color_delta = color_end - color_start;
+
+    size_t i = 0;
+
+#if defined(EMBER_HAS_SSE2)
+    {
+        const __m128 dt4   = _mm_set1_ps(dt);
+        const __m128 keep4 = _mm_set1_ps(keep);
+        const __m128 one4  = _mm_set1_ps(1.0f);
+
+        __m128 min4[3], max4[3];
+
+        for (int axis = 0; axis < 3; axis++) {
+            min4[axis] = _mm_set1_ps(FLT_MAX);
+            max4[axis] = _mm_set1_ps(-FLT_MAX);
+        }
+
+        for (; i + 4 <= _count; i += 4) {
+            for (int axis = 0; axis < 3; axis++) {
+                const __m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocity[axis] + i), keep4), _mm_set1_ps(impulse[axis]));
+                const __m128 p = _mm_add_ps(_mm_loadu_ps(position[axis] + i), _mm_mul_ps(v, dt4));
+
+                _mm_storeu_ps(velocity[axis] + i, v);
+                _mm_storeu_ps(position[axis] + i, p);
+
+                min4[axis] = _mm_min_ps(min4[axis], p);
+                max4[axis] = _mm_max_ps(max4[axis], p);
+            }
+
+            const __m128 a = _mm_add_ps(_mm_loadu_ps(age + i), dt4);
+            const __m128 t = _mm_min_ps(_mm_mul_ps(a, _mm_loadu_ps(inverse + i)), one4);
+            _mm_storeu_ps(age + i, a);
+
+            for (int channel = 0; channel < 4; channel++) {
+                const __m128 c = _mm_add_ps(_mm_set1_ps(color_start[channel]), _mm_mul_ps(_mm_set1_ps(color_delta[channel]), t));
+                _mm_storeu_ps(color[channel] + i, c);
+            }
+        }
+
+        for (int axis = 0; axis < 3; axis++) {
+            alignas(16) float lanes_min[4], lanes_max[4];
+            _mm_store_ps(lanes_min, min4[axis]);
+            _mm_store_ps(lanes_max, max4[axis]);
+
+            for (int lane = 0; lane < 4; lane++) {
+                _bounds_min[axis] = SDL_min(_bounds_min[axis], lanes_min[lane]);
+                _bounds_max[axis] = SDL_max(_bounds_max[axis], lanes_max[lane]);
+            }
+        }
+    }
+#endif
+
+    // Scalar tail (and every particle on targets without SSE2)
+    for (; i < _count; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            velocity[axis][i] = velocity[axis][i] * keep + impulse[axis];
+            position[axis][i] += velocity[axis][i] * dt;
+
+            _bounds_min[axis] = SDL_min(_bounds_min[axis], position[axis][i]);
+            _bounds_max[axis] = SDL_max(_bounds_max[axis], position[axis][i]);
+        }
+
+        age[i] += dt;
+        const float t = SDL_min(age[i] * inverse[i], 1.0f);
+
+        for (int channel = 0; channel < 4; channel++) {
+            color[channel][i] = color_start[channel] + color_delta[channel] * t;
+        }
+    }
+
+    // Expired particles are replaced by the last live one, the streams stay dense
+    for (size_t j = 0; j < _count;) {
+        if (age[j] * inverse[j] < 1.0f) {
+            j++;
+            continue;
+        }
+
+        const size_t last = --_count;
+
+        for (int s = 0; s < STREAM_COUNT; s++) {
+            float* values = stream(static_cast<Stream>(s));
+            values[j]     = values[last];
+        }
+    }
+}
+
+size_t ParticlePool::size() const {
+    return _count;
+}
+
+size_t ParticlePool::get_capacity() const {
+    return _capacity;
+}
+
+glm::vec3 ParticlePool::get_bounds_min() const {
+    return _bounds_min;
+}
+
+glm::vec3 ParticlePool::get_bounds_max() const {
+    return _bounds_max;
+}
+
+float next_particle_random(Uint32& state) {
+    // A zero state would stay zero
+    if (state == 0) {
+        state = 0x9E3779B9u;
+    }
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+}
+
+Uint32 seed_particle_random(Uint64 value) {
+    // MurmurHash3 finalizer, entity ids differ by a few low bits
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+
+    const Uint32 seed = static_cast<Uint32>(value ^ (value >> 32));
+    return seed != 0 ? seed : 0x9E3779B9u;
+}
@@ -0,0 +1,380 @@
+#include "core/component/logic/render_list_2d.h"
+
+#include "core/component/logic/system_logic.h"
+#include "core/component/logic/tilemap_2d.h"
+
+
+void RenderList2D::attach(flecs::world& world) {
+    _world = world.c_ptr();
+
+    // Any structural change touching a drawable marks the entity, the entry is rebuilt on the next sync.
+    // Disabled entities are matched too, otherwise deleting one would never be noticed.
+    const auto observe = [&](flecs::id_t id, const char* name) {
+        world.observer(name)
+            .with(id)
+            .event(flecs::OnAdd)
+            .event(flecs::OnRemove)
+            .query_flags(EcsQueryMatchDisabled | EcsQueryMatchPrefab)
+            .each([this](flecs::entity e) { mark_pending(e); });
+    };
+
+    observe(world.id<Transform2D>(), "RenderList2D_Transform2D_Observer");
+    observe(world.id<Shape2D>(), "RenderList2D_Shape2D_Observer");
+    observe(world.id<Sprite2D>(), "RenderList2D_Sprite2D_Observer");
+    observe(world.id<Label2D>(), "RenderList2D_Label2D_Observer");
+    observe(world.id<TileMap2D>(), "RenderList2D_TileMap2D_Observer");
+    observe(world.id<ParticleEmitter2D>(), "RenderList2D_ParticleEmitter2D_Observer");
+    observe(flecs::Disabled, "RenderList2D_Disabled_Observer");
+
+    // A resized drawable keeps its transform, only its bounds are refreshed on the next sync
+    const auto observe_set = [&](flecs::id_t id, const char* name) {
+        world.observer(name)
+            .with(id)
+            .event(flecs::OnSet)
+            .query_flags(EcsQueryMatchDisabled | EcsQueryMatchPrefab)
+            .each([this](flecs::entity e) { _stale_bounds.push_back(e.id()); });
+    };
+
+    observe_set(world.id<Shape2D>(), "RenderList2D_Shape2D_Set_Observer");
+    observe_set(world.id<Sprite2D>(), "RenderList2D_Sprite2D_Set_Observer");
+    observe_set(world.id<TileMap2D>(), "RenderList2D_TileMap2D_Set_Observer");
+}
+
+void RenderList2D::mark_pending(flecs::entity e) {
+    _pending.push_back(e.id());
+}
+
+bool RenderList2D::is_before(const Entry& a, const Entry& b) {
+    if (a.z_index != b.z_index) {
+        return a.z_index < b.z_index;
+    }
+
+    return a.sequence < b.sequence;
+}
+
+bool RenderList2D::make_entry(flecs::entity e, Uint64 sequence, Entry& entry) const {
+    // Same entities the old per-frame query matched: enabled, not a prefab, with a Transform2D
+    if (!e.is_alive() || !e.has<Transform2D>() || e.has(flecs::Disabled) || e.has(flecs::Prefab)) {
+        return false;
+    }
+
+    Uint8 drawables = 0;
+    drawables |= e.has<Shape2D>() ? DRAW_SHAPE : 0;
+    drawables |= e.has<Sprite2D>() ? DRAW_SPRITE : 0;
+    drawables |= e.has<Label2D>() ? DRAW_LABEL : 0;
+    drawables |= e.has<TileMap2D>() ? DRAW_TILEMAP : 0;
+    drawables |= e.has<ParticleEmitter2D>() ? DRAW_PARTICLES : 0;
+
+    if (drawables == 0) {
+        return false;
+    }
+
+    entry           = {};
+    entry.entity    = e;
+    entry.sequence  = sequence;
+    entry.drawables = drawables;
+    entry.transform = e.get_ref<Transform2D>();
+    entry.z_index   = entry.transform->z_index;
+
+    if (drawables & DRAW_SHAPE) {
+        entry.shape = e.get_ref<Shape2D>();
+    }
+
+    if (drawables & DRAW_SPRITE) {
+        entry.sprite = e.get_ref<Sprite2D>();
+    }
+
+    if (drawables & DRAW_LABEL) {
+        entry.label = e.get_ref<Label2D>();
+    }
+
+    if (drawables & DRAW_TILEMAP) {
+        entry.tilemap = e.get_ref<TileMap2D>();
+    }
+
+    if (drawables & DRAW_PARTICLES) {
+        entry.particles = e.get_ref<ParticleEmitter2D>();
+    }
+
+    return true;
+}
+
+Rect2D RenderList2D::compute_bounds(Entry& entry) {
+    // A label's size is only known once laid out by the renderer
+    if (entry.drawables & DRAW_LABEL) {
+        return {glm::vec2(-FLT_MAX), glm::vec2(FLT_MAX)};
+    }
+
+    const Transform2D& t = *entry.transform.get();
+    const float cosr     = SDL_cosf(t.world_rotation);
+    const float sinr     = SDL_sinf(t.world_rotation);
+
+    glm::vec2 corners[14];
+    size_t count = 0;
+
+    // Same placement as the renderers: scaled, rotated, then moved to the world position
+    const auto add_local_rect = [&](glm::vec2 min, glm::vec2 max) {
+        for (const glm::vec2 point : {min, glm::vec2(max.x, min.y), max, glm::vec2(min.x, max.y)}) {
+            const glm::vec2 scaled = point * t.world_scale;
+            corners[count++]       = t.world_position + glm::vec2(scaled.x * cosr - scaled.y * sinr, scaled.x * sinr + scaled.y * cosr);
+        }
+    };
+
+    if (entry.drawables & DRAW_TILEMAP) {
+        const Rect2D local   = get_tilemap_local_bounds(*entry.tilemap.get());
+        entry.tilemap_extent = local.max;
+        add_local_rect(local.min, local.max);
+    }
+
+    if (entry.drawables & DRAW_SHAPE) {
+        const Shape2D& shape = *entry.shape.get();
+
+        switch (shape.type) {
+        case ShapeType::RECTANGLE:
+            add_local_rect(-shape.size / 2.0f, shape.size / 2.0f);
+            break;
+        case ShapeType::TRIANGLE: {
+            const glm::vec2 half = {shape.size.x / 2.0f, SDL_sqrtf(3.0f) / 4.0f * shape.size.x};
+            add_local_rect(-half, half);
+            break;
+        }
+        case ShapeType::CIRCLE:
+            // Positioned by the top-left corner of its bounds
+            add_local_rect({0.0f, 0.0f}, glm::vec2(shape.radius * 2.0f));
+            break;
+        case ShapeType::LINE:
+            add_local_rect(glm::min(glm::vec2(0.0f), shape.end), glm::max(glm::vec2(0.0f), shape.end));
+            break;
+        case ShapeType::POLYGON:
+            if (!shape.vertices.empty()) {
+                const Rect2D local = Rect2D::from_points(shape.vertices.data(), shape.vertices.size());
+                add_local_rect(local.min, local.max);
+            }
+            break;
+        }
+    }
+
+    if (entry.drawables & DRAW_SPRITE) {
+        const Sprite2D& sprite = *entry.sprite.get();
+
+        // The quad center is offset along the world axes, only its extents rotate
+        const glm::vec2 half   = glm::abs(glm::vec2(sprite.source.z, sprite.source.w) * t.world_scale) * 0.5f;
+        const glm::vec2 center = t.world_position + glm::vec2(sprite.source.z, sprite.source.w) * t.world_scale * 0.5f;
+        const glm::vec2 extent = {half.x * SDL_fabsf(cosr) + half.y * SDL_fabsf(sinr), half.x * SDL_fabsf(sinr) + half.y * SDL_fabsf(cosr)};
+
+        corners[count++] = center - extent;
+        corners[count++] = center + extent;
+    }
+
+    if (entry.drawables & DRAW_PARTICLES) {
+        const ParticleEmitter2D& emitter = *entry.particles.get();
+        const ParticlePool& pool         = emitter.pool;
+
+        // Particles are in world space, the emitter is included so an empty one is found too
+        const glm::vec2 half = glm::vec2(emitter.size * 0.5f);
+
+        corners[count++] = t.world_position - half;
+        corners[count++] = t.world_position + half;
+
+        if (pool.size() > 0) {
+            corners[count++] = glm::vec2(pool.get_bounds_min()) - half;
+            corners[count++] = glm::vec2(pool.get_bounds_max()) + half;
+        }
+    }
+
+    if (count == 0) {
+        return {t.world_position, t.world_position};
+    }
+
+    // Outlines are drawn 1px wide around the shape
+    Rect2D bounds = Rect2D::from_points(corners, count);
+    bounds.min -= 1.0f;
+    bounds.max += 1.0f;
+    return bounds;
+}
+
+void RenderList2D::sync() {
+    _resorted.clear();
+
+    std::sort(_pending.begin(), _pending.end());
+    _pending.erase(std::unique(_pending.begin(), _pending.end()), _pending.end());
+    std::sort(_stale_bounds.begin(), _stale_bounds.end());
+
+    bool is_order_changed = false;
+
+    // Single compaction pass: drop pending entries, pull out entries whose z_index changed, refresh moved bounds
+    size_t write = 0;
+    for (size_t read = 0; read < _entries.size(); ++read) {
+        Entry& entry = _entries[read];
+
+        const Transform2D* transform = nullptr;
+
+        if (_pending.empty() || !std::binary_search(_pending.begin(), _pending.end(), entry.entity.id())) {
+            transform = entry.transform.try_get();
+        }
+
+        if (!transform) {
+            _spatial_hash.remove(entry.proxy);
+            is_order_changed = true;
+            continue;
+        }
+
+        bool is_stale = !_stale_bounds.empty() && std::binary_search(_stale_bounds.begin(), _stale_bounds.end(), entry.entity.id());
+
+        // `load_tilemap` and `resize_tilemap` edit the map in place, no OnSet tells us
+        if (entry.drawables & DRAW_TILEMAP) {
+            is_stale = is_stale || get_tilemap_local_bounds(*entry.tilemap.get()).max != entry.tilemap_extent;
+        }
+
+        if (transform->world_version != entry.bounds_version || (entry.drawables & DRAW_PARTICLES) || is_stale) {
+            entry.bounds_version = transform->world_version;
+            _spatial_hash.update(entry.proxy, compute_bounds(entry));
+        }
+
+        if (transform->z_index != entry.z_index) {
+            entry.z_index = transform->z_index;
+            _resorted.push_back(std::move(entry));
+            continue;
+        }
+
+        if (write != read) {
+            _entries[write] = std::move(entry);
+        }
+        write++;
+    }
+    _entries.resize(write);
+
+    for (const flecs::entity_t id : _pending) {
+        const flecs::entity e(_world, id);
+        const auto it = _sequences.find(id);
+
+        // Keep the original sequence when a drawable is added to an entity already in the list
+        const Uint64 sequence = it != _sequences.end() ? it->second : _next_sequence++;
+
+        Entry entry;
+        if (make_entry(e, sequence, entry)) {
+            entry.bounds_version = entry.transform->world_version;
+            entry.proxy          = _spatial_hash.insert(compute_bounds(entry), id);
+
+            _sequences[id] = sequence;
+            _resorted.push_back(std::move(entry));
+        } else if (it != _sequences.end()) {
+            _sequences.erase(it);
+        }
+    }
+    _pending.clear();
+    _stale_bounds.clear();
+
+    if (!_resorted.empty()) {
+        std::sort(_resorted.begin(), _resorted.end(), is_before);
+
+        _merge_buffer.clear();
+        _merge_buffer.reserve(_entries.size() + _resorted.size());
+        std::merge(std::make_move_iterator(_entries.begin()), std::make_move_iterator(_entries.end()), std::make_move_iterator(_resorted.begin()),
+                   std::make_move_iterator(_resorted.end()), std::back_inserter(_merge_buffer), is_before);
+
+        _entries.swap(_merge_buffer);
+        _resorted.clear();
+        is_order_changed = true;
+    }
+
+    if (!is_order_changed) {
+        return;
+    }
+
+    _proxy_entries.resize(_spatial_hash.get_capacity());
+
+    for (size_t i = 0; i < _entries.size(); i++) {
+        _proxy_entries[_entries[i].proxy] = static_cast<Uint32>(i);
+    }
+}
+
+void RenderList2D::draw_entry(Entry& entry, const Rect2D& view) {
+    Transform2D& t = *entry.transform.get();
+
+    if (entry.drawables & DRAW_TILEMAP) {
+        render_tilemaps_system(t, *entry.tilemap.get(), view);
+    }
+
+    if (entry.drawables & DRAW_SHAPE) {
+        render_primitives_system(t, *entry.shape.get());
+    }
+
+    if (entry.drawables & DRAW_SPRITE) {
+        render_sprites_system(t, *entry.sprite.get());
+    }
+
+    if (entry.drawables & DRAW_PARTICLES) {
+        render_particles_2d_system(*entry.particles.get());
+    }
+
+    if (entry.drawables & DRAW_LABEL) {
+        render_labels_system(t, *entry.label.get());
+    }
+}
+
+void RenderList2D::draw() {
+    PROFILE_SCOPE("RenderList2D::draw");
+
+    const Rect2D everything = {glm::vec2(-FLT_MAX), glm::vec2(FLT_MAX)};
+
+    for (Entry& entry : _entries) {
+        draw_entry(entry, everything);
+    }
+}
+
+void RenderList2D::draw(const Rect2D& view) {
+    PROFILE_SCOPE("RenderList2D::draw_culled");
+
+    collect(view, _visible);
+
+    for (const Uint32 index : _visible) {
+        draw_entry(_entries[index], view);
+    }
+}
+
+void RenderList2D::collect(const Rect2D& rect, std::vector<Uint32>& indices) const {
+    indices.clear();
+
+    _spatial_hash.query(rect, [&](Uint32 handle) { indices.push_back(_proxy_entries[handle]); });
+
+    // Entries are stored in z order, sorting the indices restores it for the few visible ones
+    std::sort(indices.begin(), indices.end());
+}
+
+void RenderList2D::query_rect(const Rect2D& rect, std::vector<flecs::entity>& entities) const {
+    collect(rect, _visible);
+
+    for (const Uint32 index : _visible) {
+        entities.push_back(_entries[index].entity);
+    }
+}
+
+void RenderList2D::query_point(glm::vec2 point, std::vector<flecs::entity>& entities) const {
+    query_rect({point, point}, entities);
+}
+
+const SpatialHash2D& RenderList2D::get_spatial_hash() const {
+    return _spatial_hash;
+}
+
+size_t RenderList2D::size() const {
+    return _entries.size();
+}
+
+std::vector<flecs::entity> RenderList2D::get_draw_order() const {
+    std::vector<flecs::entity> order;
+    order.reserve(_entries.size());
+
+    for (const auto& entry : _entries) {
+        order.push_back(entry.entity);
+    }
+
+    return order;
+}
+
+std::vector<flecs::entity> RenderList2D::get_draw_order(const Rect2D& view) const {
+    std::vector<flecs::entity> order;
+    query_rect(view, order);
+    return order;
+}
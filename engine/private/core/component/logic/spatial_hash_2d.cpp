@@ -0,0 +1,170 @@
+#include "core/component/logic/spatial_hash_2d.h"
+
+
+SpatialHash2D::SpatialHash2D(float cell_size) : _cell_size(SDL_max(cell_size, 1.0f)), _inverse_cell_size(1.0f / SDL_max(cell_size, 1.0f)) {
+}
+
+Uint64 SpatialHash2D::get_cell_key(int x, int y) {
+    return (static_cast<Uint64>(static_cast<Uint32>(x)) << 32) | static_cast<Uint32>(y);
+}
+
+SpatialHash2D::CellRange SpatialHash2D::get_cells(const Rect2D& bounds) const {
+    // Clamped so far away or invalid bounds cannot overflow the cell coordinates
+    constexpr float limit = 1 << 30;
+
+    // NaN fails every compare of the clamp, it spans the whole range instead (an oversized item no query overlaps)
+    const auto cell = [&](float value, float nan_value) {
+        const float scaled = value * _inverse_cell_size;
+        return static_cast<int>(SDL_floorf(SDL_isnanf(scaled) ? nan_value : SDL_clamp(scaled, -limit, limit)));
+    };
+
+    return {cell(bounds.min.x, -limit), cell(bounds.min.y, -limit), cell(bounds.max.x, limit), cell(bounds.max.y, limit)};
+}
+
+Uint32 SpatialHash2D::insert(const Rect2D& bounds, Uint64 user_data) {
+    Uint32 handle;
+
+    if (!_free_handles.empty()) {
+        handle = _free_handles.back();
+        _free_handles.pop_back();
+    } else {
+        handle = static_cast<Uint32>(_items.size());
+        _items.emplace_back();
+        _query_stamps.push_back(0);
+    }
+
+    Item& item     = _items[handle];
+    item.bounds    = bounds;
+    item.cells     = get_cells(bounds);
+    item.user_data = user_data;
+    item.is_alive  = true;
+
+    link(handle);
+    _count++;
+    return handle;
+}
+
+void SpatialHash2D::update(Uint32 handle, const Rect2D& bounds) {
+    if (handle >= _items.size() || !_items[handle].is_alive) {
+        return;
+    }
+
+    Item& item  = _items[handle];
+    item.bounds = bounds;
+
+    const CellRange cells = get_cells(bounds);
+
+    if (cells == item.cells) {
+        return;
+    }
+
+    unlink(handle);
+    item.cells = cells;
+    link(handle);
+}
+
+void SpatialHash2D::remove(Uint32 handle) {
+    if (handle >= _items.size() || !_items[handle].is_alive) {
+        return;
+    }
+
+    unlink(handle);
+
+    _items[handle].is_alive = false;
+    _free_handles.push_back(handle);
+    _count--;
+}
+
+void SpatialHash2D::clear() {
+    _cells.clear();
+    _items.clear();
+    _free_handles.clear();
+    _oversized.clear();
+    _query_stamps.clear();
+    _count = 0;
+}
+
+void SpatialHash2D::link(Uint32 handle) {
+    Item& item = _items[handle];
+
+    item.is_oversized = item.cells.get_count() > MAX_ITEM_CELLS;
+
+    if (item.is_oversized) {
+        _oversized.push_back(handle);
+        return;
+    }
+
+    for (int y = item.cells.min_y; y <= item.cells.max_y; y++) {
+        for (int x = item.cells.min_x; x <= item.cells.max_x; x++) {
+            _cells[get_cell_key(x, y)].push_back(handle);
+        }
+    }
+}
+
+void SpatialHash2D::unlink(Uint32 handle) {
+    const Item& item = _items[handle];
+
+    const auto erase = [handle](std::vector<Uint32>& handles) {
+        const auto it = std::find(handles.begin(), handles.end(), handle);
+
+        if (it != handles.end()) {
+            *it = handles.back();
+            handles.pop_back();
+        }
+    };
+
+    if (item.is_oversized) {
+        erase(_oversized);
+        return;
+    }
+
+    for (int y = item.cells.min_y; y <= item.cells.max_y; y++) {
+        for (int x = item.cells.min_x; x <= item.cells.max_x; x++) {
+            const auto it = _cells.find(get_cell_key(x, y));
+
+            if (it == _cells.end()) {
+                continue;
+            }
+
+            erase(it->second);
+
+            if (it->second.empty()) {
+                _cells.erase(it);
+            }
+        }
+    }
+}
+
+Uint32 SpatialHash2D::next_query_stamp() const {
+    // On wrap around, old stamps could collide with the new ones
+    if (++_query_stamp == 0) {
+        std::fill(_query_stamps.begin(), _query_stamps.end(), 0);
+        _query_stamp = 1;
+    }
+
+    return _query_stamp;
+}
+
+void SpatialHash2D::query_point(glm::vec2 point, std::vector<Uint32>& handles) const {
+    query(Rect2D{point, point}, [&](Uint32 handle) { handles.push_back(handle); });
+}
+
+const Rect2D& SpatialHash2D::get_bounds(Uint32 handle) const {
+    return _items[handle].bounds;
+}
+
+Uint64 SpatialHash2D::get_user_data(Uint32 handle) const {
+    return _items[handle].user_data;
+}
+
+size_t SpatialHash2D::size() const {
+    return _count;
+}
+
+size_t SpatialHash2D::get_capacity() const {
+    return _items.size();
+}
+
+float SpatialHash2D::get_cell_size() const {
+    return _cell_size;
+}
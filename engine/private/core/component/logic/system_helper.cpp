@@ -1,5 +1,9 @@
 #include "core/component/logic/system_helper.h"
 
+#include "core/renderer/shape_tessellation.h"
+
+#include <glm/gtx/euler_angles.hpp>
+
 
 const aiNodeAnim* find_node_anim(const aiAnimation* animation, const std::string& nodeName) {
     for (unsigned int i = 0; i < animation->mNumChannels; i++) {
@@ -150,3 +154,117 @@ int sort_by_z_index(flecs::entity_t e1, const Transform2D* t1, flecs::entity_t e
 }
 
 
+
+
+glm::mat3 compose_transform_2d(glm::vec2 position, glm::vec2 scale, float rotation) {
+    const float c = SDL_cosf(rotation);
+    const float s = SDL_sinf(rotation);
+
+    // Column-major: columns are the scaled, rotated axes and the translation
+    return glm::mat3(c * scale.x, s * scale.x, 0.0f, -s * scale.y, c * scale.y, 0.0f, position.x, position.y, 1.0f);
+}
+
+bool propagate_transform_2d(Transform2D& t, const Transform2D* parent, const Interpolation2D* previous, float alpha,
+                            flecs::entity_t parent_id) {
+    glm::vec2 position = t.position;
+    glm::vec2 scale    = t.scale;
+    float rotation     = t.rotation;
+
+    if (previous && previous->is_valid) {
+        position = glm::mix(previous->position, t.position, alpha);
+        scale    = glm::mix(previous->scale, t.scale, alpha);
+        rotation = mix_angle(previous->rotation, t.rotation, alpha);
+    }
+
+    const Uint32 parent_version = parent ? parent->world_version : 0;
+
+    // Static entities stop here: a few compares, no math and no writes
+    if (!t.is_dirty && parent_id == t.parent_id && parent_version == t.parent_version && position == t.propagated_position && scale == t.propagated_scale &&
+        rotation == t.propagated_rotation) {
+        return false;
+    }
+
+    const glm::mat3 local = compose_transform_2d(position, scale, rotation);
+    t.world_matrix        = parent ? parent->world_matrix * local : local;
+
+    const glm::vec2 x_axis = t.world_matrix[0];
+    const glm::vec2 y_axis = t.world_matrix[1];
+
+    // A mirrored basis (negative determinant) is reported as a negative y scale
+    const float determinant = x_axis.x * y_axis.y - x_axis.y * y_axis.x;
+
+    t.world_position = t.world_matrix[2];
+    t.world_scale    = {glm::length(x_axis), determinant < 0.0f ? -glm::length(y_axis) : glm::length(y_axis)};
+    t.world_rotation = SDL_atan2f(x_axis.y, x_axis.x);
+
+    t.propagated_position = position;
+    t.propagated_scale    = scale;
+    t.propagated_rotation = rotation;
+    t.parent_id           = parent_id;
+    t.parent_version      = parent_version;
+    t.is_dirty            = false;
+    t.world_version++;
+    return true;
+}
+
+const std::vector<int>& get_polygon_triangles(Shape2D& shape) {
+    // One compare per frame instead of an O(n^2) ear clipping
+    if (shape.vertices != shape.triangulated_vertices) {
+        if (!triangulate_polygon(shape.vertices, shape.triangles) && shape.vertices.size() >= 3) {
+            LOG_WARN("Shape2D polygon of %zu vertices is degenerate or self-intersecting", shape.vertices.size());
+        }
+
+        shape.triangulated_vertices = shape.vertices;
+    }
+
+    return shape.triangles;
+}
+
+float mix_angle(float from, float to, float alpha) {
+    // Delta wrapped to [-pi, pi], blended backwards from `to` so alpha 1 gives it exactly
+    float delta = SDL_fmodf(to - from, glm::two_pi<float>());
+
+    if (delta > glm::pi<float>()) {
+        delta -= glm::two_pi<float>();
+    } else if (delta < -glm::pi<float>()) {
+        delta += glm::two_pi<float>();
+    }
+
+    return to - delta * (1.0f - alpha);
+}
+
+Transform2D interpolate_transform_2d(const Transform2D& current, const Interpolation2D& previous, float alpha) {
+    if (!previous.is_valid) {
+        return current;
+    }
+
+    Transform2D t = current;
+    t.position    = glm::mix(previous.position, current.position, alpha);
+    t.scale       = glm::mix(previous.scale, current.scale, alpha);
+    t.rotation    = mix_angle(previous.rotation, current.rotation, alpha);
+    return t;
+}
+
+Transform3D interpolate_transform_3d(const Transform3D& current, const Interpolation3D& previous, float alpha) {
+    if (!previous.is_valid) {
+        return current;
+    }
+
+    Transform3D t;
+    t.position = glm::mix(previous.previous.position, current.position, alpha);
+    t.rotation = current.rotation;
+    t.scale    = glm::mix(previous.previous.scale, current.scale, alpha);
+
+    if (previous.previous.rotation != current.rotation) {
+        // Same order as `Transform3D::get_model_matrix`: X, then Y, then Z
+        const auto to_quat = [](const glm::vec3& euler) {
+            return glm::angleAxis(euler.x, glm::vec3(1, 0, 0)) * glm::angleAxis(euler.y, glm::vec3(0, 1, 0)) *
+                   glm::angleAxis(euler.z, glm::vec3(0, 0, 1));
+        };
+
+        const glm::quat rotation = glm::slerp(to_quat(previous.previous.rotation), to_quat(current.rotation), alpha);
+        glm::extractEulerAngleXYZ(glm::mat4_cast(rotation), t.rotation.x, t.rotation.y, t.rotation.z);
+    }
+
+    return t;
+}
@@ -2,8 +2,28 @@
 
 #include "core/binding/lua.h"
 #include "core/component/logic/system_helper.h"
+#include "core/component/logic/tilemap_2d.h"
 #include "core/engine.h"
 
+namespace {
+
+    /// Whole particles due this frame, the fraction is kept for the next one
+    int take_emit_count(float& accumulator, float rate, float dt) {
+        accumulator += rate * dt;
+
+        const int count = static_cast<int>(accumulator);
+        accumulator -= static_cast<float>(count);
+
+        return count;
+    }
+
+    /// Uniform in [base - variation, base + variation]
+    float vary(float base, float variation, Uint32& random_state) {
+        return base + (next_particle_random(random_state) * 2.0f - 1.0f) * variation;
+    }
+
+} // namespace
+
 #pragma region 2D SYSTEMS
 
 void render_world_2d_system(flecs::entity e, Camera2D& camera) {
@@ -11,26 +31,15 @@ void render_world_2d_system(flecs::entity e, Camera2D& camera) {
         return;
     }
 
-    auto& world = GEngine->get_world();
-
-    auto q = world.query_builder<Transform2D>().order_by(sort_by_z_index).build();
+    // Persistent z-sorted list, only re-sorted when entities or z_index changed
+    RenderList2D& render_list = GEngine->get_render_list_2d();
 
-    q.each([&](flecs::entity e, Transform2D& t) {
-        update_transforms_system(e, t);
+    render_list.sync();
 
+    const auto& viewport = GEngine->get_config().get_viewport();
 
-        if (e.has<Shape2D>()) {
-            render_primitives_system(t, e.get_mut<Shape2D>());
-        }
-
-        if (e.has<Sprite2D>()) {
-            render_sprites_system(t, e.get_mut<Sprite2D>());
-        }
-
-        if (e.has<Label2D>()) {
-            render_labels_system(t, e.get_mut<Label2D>());
-        }
-    });
+    GEngine->get_renderer()->set_view_2d(camera.get_view());
+    render_list.draw(camera.get_visible_rect(viewport.width, viewport.height));
 }
 
 void render_primitives_system(Transform2D& t, Shape2D& s) {
@@ -48,7 +57,11 @@ void render_primitives_system(Transform2D& t, Shape2D& s) {
         GEngine->get_renderer()->draw_line(t, s.end, s.color);
         break;
     case ShapeType::POLYGON:
-        GEngine->get_renderer()->draw_polygon(t, s.vertices, s.color, s.filled);
+        if (s.filled) {
+            GEngine->get_renderer()->draw_polygon_triangles(t, s.vertices, get_polygon_triangles(s), s.color);
+        } else {
+            GEngine->get_renderer()->draw_polygon(t, s.vertices, s.color, false);
+        }
         break;
     }
 }
@@ -62,44 +75,168 @@ void render_labels_system(Transform2D& t, Label2D& l) {
 void render_sprites_system(Transform2D& t, Sprite2D& sprite) {
 
     if (!sprite.texture_name.empty()) {
+        Renderer* renderer = GEngine->get_renderer();
+
+        // Atlased images draw from their shared page, `source` stays relative to the original image
+        if (const AtlasRegion* region = renderer->get_texture_atlas().find(sprite.texture_name)) {
+            const glm::vec4 source = {region->rect.x + sprite.source.x, region->rect.y + sprite.source.y, sprite.source.z, sprite.source.w};
+            const glm::vec4 dest   = {0, 0, source.z, source.w};
+
+            renderer->draw_texture(t, region->page.get(), dest, source, sprite.flip_h, sprite.flip_v, sprite.color);
+            return;
+        }
 
-        auto texture = GEngine->get_renderer()->load_texture(sprite.texture_name);
+        auto texture = renderer->load_texture(sprite.texture_name);
         if (texture) {
             glm::vec4 source = sprite.source;
 
             glm::vec4 dest = {0, 0, source.z, source.w};
 
-            GEngine->get_renderer()->draw_texture(t, texture.get(), dest, source, sprite.flip_h, sprite.flip_v, sprite.color);
+            renderer->draw_texture(t, texture.get(), dest, source, sprite.flip_h, sprite.flip_v, sprite.color);
         }
     }
 }
 
+void render_tilemaps_system(Transform2D& t, TileMap2D& map, const Rect2D& view) {
+    if (map.texture_name.empty() || map.chunks.empty()) {
+        return;
+    }
 
-void update_transforms_system(flecs::entity e, Transform2D& t) {
-    auto parent = e.parent();
-    if (parent.is_valid() && parent.has<Transform2D>()) {
-        const Transform2D& parent_t = parent.get<Transform2D>();
+    Renderer* renderer = GEngine->get_renderer();
 
-        // Update world position, scale and rotation based on parent's transform
-        t.world_position = parent_t.world_position + t.position;
+    // Same lookup as the sprites: an atlas region first, then a texture of its own
+    Texture* texture = nullptr;
+    glm::vec4 source;
 
-        t.world_scale = parent_t.world_scale * t.scale;
+    if (const AtlasRegion* region = renderer->get_texture_atlas().find(map.texture_name)) {
+        texture = region->page.get();
+        source  = region->rect;
+    } else if (const auto loaded = renderer->load_texture(map.texture_name)) {
+        texture = loaded.get();
+        source  = {0, 0, loaded->width, loaded->height};
+    }
 
-        t.world_rotation = parent_t.world_rotation + t.rotation;
-    } else {
-        // No parent with Transform2D, so local is world
-        t.world_position = t.position;
-        t.world_scale    = t.scale;
-        t.world_rotation = t.rotation;
+    if (!texture) {
+        return;
+    }
+
+    const glm::vec2 texture_size = {texture->width, texture->height};
+
+    if (source != map.built_source || texture_size != map.built_texture_size || map.tile_size != map.built_tile_size) {
+        map.built_source       = source;
+        map.built_texture_size = texture_size;
+        map.built_tile_size    = map.tile_size;
+
+        for (TileChunk2D& chunk : map.chunks) {
+            chunk.is_dirty = true;
+        }
+    }
+
+    map.frame++;
+
+    glm::ivec2 min, max;
+
+    if (get_visible_chunks(map, t, view, min, max)) {
+        for (int y = min.y; y <= max.y; y++) {
+            for (int x = min.x; x <= max.x; x++) {
+                TileChunk2D& chunk = map.chunks[static_cast<size_t>(y) * map.chunks_x + x];
+
+                if (chunk.tile_count == 0) {
+                    continue;
+                }
+
+                if (chunk.is_dirty) {
+                    build_tile_chunk(map, x, y, source, texture_size);
+                }
+
+                chunk.last_drawn_frame = map.frame;
+                renderer->draw_texture_quads(t, texture, chunk.positions, chunk.uvs, map.color);
+            }
+        }
     }
 
-    // LOG_INFO("Entity: %s, Local Pos: (%.2f, %.2f), World Pos: (%.2f, %.2f)", e.name().c_str(), t.position.x, t.position.y, t.world_position.x,
-    //          t.world_position.y);
+    // Off-screen chunks give their quads back, they are rebuilt when they come into view again
+    if (map.frame % TILE_CHUNK_EVICT_FRAMES == 0) {
+        for (TileChunk2D& chunk : map.chunks) {
+            if (!chunk.positions.empty() && map.frame - chunk.last_drawn_frame > TILE_CHUNK_EVICT_FRAMES) {
+                chunk.positions = {};
+                chunk.uvs       = {};
+                chunk.is_dirty  = true;
+            }
+        }
+    }
+}
+
+void update_particles_2d_system(flecs::entity e, const Transform2D& t, ParticleEmitter2D& emitter) {
+    ParticlePool& pool = emitter.pool;
+
+    // Emitters sharing a configuration would otherwise emit the exact same pattern
+    if (emitter.random_state == 0) {
+        emitter.random_state = seed_particle_random(e.id());
+    }
+
+    if (pool.get_capacity() != emitter.max_particles) {
+        pool.set_capacity(emitter.max_particles);
+    }
+
+    // Not drawn last frame: frozen until the render pass sees it again
+    if (!emitter.is_visible) {
+        return;
+    }
+
+    emitter.is_visible = false;
+
+    const float dt  = static_cast<float>(GEngine->get_timer().delta);
+    const int count = take_emit_count(emitter.emit_accumulator, emitter.is_emitting ? emitter.rate : 0.0f, dt);
+
+    for (int i = 0; i < count; i++) {
+        const float angle    = vary(emitter.direction, emitter.spread, emitter.random_state);
+        const float speed    = vary(emitter.speed, emitter.speed_variation, emitter.random_state);
+        const float lifetime = vary(emitter.lifetime, emitter.lifetime_variation, emitter.random_state);
+
+        if (!pool.emit({t.world_position, 0.0f}, glm::vec3(SDL_cosf(angle), SDL_sinf(angle), 0.0f) * speed, lifetime)) {
+            emitter.emit_accumulator = 0.0f;
+            break;
+        }
+    }
+
+    pool.update(dt, {emitter.gravity, 0.0f}, emitter.damping, emitter.color_start, emitter.color_end);
+}
+
+void render_particles_2d_system(ParticleEmitter2D& emitter) {
+    emitter.is_visible = true;
+
+    if (emitter.pool.size() == 0) {
+        return;
+    }
+
+    Renderer* renderer = GEngine->get_renderer();
+
+    // Same lookup as the sprites: an atlas region first, then a texture of its own
+    Texture* texture = nullptr;
+    glm::vec4 uv     = {0, 0, 1, 1};
+
+    if (!emitter.texture_name.empty()) {
+        if (const AtlasRegion* region = renderer->get_texture_atlas().find(emitter.texture_name)) {
+            texture              = region->page.get();
+            const glm::vec2 page = {texture->width, texture->height};
+            uv                   = {region->rect.x / page.x, region->rect.y / page.y, region->rect.z / page.x, region->rect.w / page.y};
+        } else if (const auto loaded = renderer->load_texture(emitter.texture_name)) {
+            texture = loaded.get();
+        }
+    }
+
+    renderer->draw_particles_2d(emitter.pool, texture, uv, emitter.size);
+}
+
+void update_transforms_system(Transform2D& t, const Interpolation2D* previous, const Transform2D* parent, flecs::entity_t parent_id) {
+    // Entities simulated in the fixed step are drawn between their last two states
+    propagate_transform_2d(t, parent, previous, GEngine->get_timer().get_fixed_alpha(), parent_id);
 }
 #pragma endregion
 
 #pragma region 3D SYSTEMS
-void update_animation(Model& model, Animation3D& anim, float deltaTime) {
+void update_animation(const Model& model, Animation3D& anim, float deltaTime) {
     if (!model.scene || !model.scene->HasAnimations() || !anim.is_playing) {
         return;
     }
@@ -156,6 +293,14 @@ void update_animation(Model& model, Animation3D& anim, float deltaTime) {
     }
 }
 
+Transform3D get_render_transform_3d(flecs::entity e, const Transform3D& t) {
+    if (const Interpolation3D* previous = e.try_get<Interpolation3D>()) {
+        return interpolate_transform_3d(t, *previous, GEngine->get_timer().get_fixed_alpha());
+    }
+
+    return t;
+}
+
 void render_world_3d_system(flecs::entity e, Camera3D& camera) {
 
 
@@ -166,69 +311,130 @@ void render_world_3d_system(flecs::entity e, Camera3D& camera) {
 
     const auto& window = GEngine->get_config().get_window();
 
-    // Render all 3D models in the scene (non-animated)
-    GEngine->get_world().each([&](flecs::entity e, Transform3D& t, Model& model) {
-        
-        if (e.has<Animation3D>()) {
-            return;
-        }
+    // Models and meshes were already submitted by the (multi-threaded) submit systems
+    GEngine->get_world().each([&](flecs::entity e, Transform3D& t, const Camera3D& cam) {
+        const glm::mat4 view       = cam.get_view(t);
+        const glm::mat4 projection = cam.get_projection(window.width, window.height);
 
-        if (!model.is_loaded && !model.path.empty()) {
-            auto loaded = GEngine->get_renderer()->load_model(model.path.c_str());
-            if (loaded) {
-                model.importer = loaded->importer;
-                model.scene = loaded->scene;
-                model.global_inverse_transform = loaded->global_inverse_transform;
-                model.meshes = loaded->meshes;
-                model.is_loaded = true;
-            } else {
-                LOG_ERROR("Failed to load model: %s", model.path.c_str());
-                model.path.clear();
-                return;
-            }
-        }
-        
-        if (model.is_loaded){
-            GEngine->get_renderer()->draw_model(t, &model);
-        }
+        // Same view as `prepare_view_3d_system` unless a system moved the camera since
+        GEngine->get_renderer()->set_view_3d(view, projection);
+        GEngine->get_renderer()->flush(view, projection);
     });
+}
 
-    // Render all MeshInstance3D components
-    GEngine->get_world().each(
-        [&](flecs::entity e, Transform3D& t, const MeshInstance3D& cube) { GEngine->get_renderer()->draw_mesh(t, cube); });
+void load_model_system(flecs::entity e, Model& model) {
+    if (model.is_loaded || model.path.empty()) {
+        return;
+    }
 
-    GEngine->get_world().each([&](flecs::entity e, Transform3D& t, const Camera3D& cam) {
-        GEngine->get_renderer()->flush(cam.get_view(t), cam.get_projection(window.width, window.height));
-    });
+    auto loaded = GEngine->get_renderer()->load_model(model.path.c_str());
+    if (loaded) {
+        model.importer                 = loaded->importer;
+        model.scene                    = loaded->scene;
+        model.global_inverse_transform = loaded->global_inverse_transform;
+        model.bounds                   = loaded->bounds;
+        model.animation_bounds         = loaded->animation_bounds;
+        model.meshes                   = loaded->meshes;
+        model.is_loaded                = true;
+    } else {
+        LOG_ERROR("Failed to load model: %s", model.path.c_str());
+        model.path.clear();
+    }
 }
 
-void animation_system(flecs::entity e, Model& model, Animation3D& anim, Transform3D& transform) {
+void prepare_view_3d_system(const Transform3D& t, const Camera3D& camera) {
+    const auto& window = GEngine->get_config().get_window();
 
-    if (!model.is_loaded && !model.path.empty()) {
-        auto loaded = GEngine->get_renderer()->load_model(model.path.c_str());
-        if (loaded) {
-            model.importer                 = loaded->importer;
-            model.scene                    = loaded->scene;
-            model.global_inverse_transform = loaded->global_inverse_transform;
-            model.meshes                   = loaded->meshes;
-            model.is_loaded                   = true;
-        } else {
-            LOG_ERROR("Failed to load animated model: %s", model.path.c_str());
-            model.path.clear();
-            return;
+    GEngine->get_renderer()->set_view_3d(camera.get_view(t), camera.get_projection(window.width, window.height));
+}
+
+void submit_models_system(flecs::entity e, const Transform3D& t, const Model& model) {
+    if (!model.is_loaded) {
+        return;
+    }
+
+    if (const Animation3D* anim = e.try_get<Animation3D>()) {
+        if (!anim->bone_transforms.empty()) {
+            GEngine->get_renderer()->draw_animated_model(get_render_transform_3d(e, t), &model, anim->bone_transforms.data(),
+                                                         anim->bone_transforms.size(), anim->current_animation, e.world().get_stage_id());
         }
+        return;
     }
 
-    if (!model.scene) {
+    // Each worker submits into its own stage, no lock
+    GEngine->get_renderer()->draw_model(get_render_transform_3d(e, t), &model, e.has<tags::Static>(), e.world().get_stage_id());
+}
+
+void submit_meshes_system(flecs::entity e, const Transform3D& t, const MeshInstance3D& mesh) {
+    GEngine->get_renderer()->draw_mesh(get_render_transform_3d(e, t), mesh, nullptr, e.has<tags::Static>(), e.world().get_stage_id());
+}
+
+void animation_system(flecs::entity e, const Model& model, Animation3D& anim) {
+    if (!model.is_loaded || !model.scene) {
         return;
     }
 
     update_animation(model, anim, GEngine->get_timer().delta);
+}
+
+void update_particles_3d_system(flecs::entity e, const Transform3D& t, ParticleEmitter3D& emitter) {
+    ParticlePool& pool = emitter.pool;
 
+    if (emitter.random_state == 0) {
+        emitter.random_state = seed_particle_random(e.id());
+    }
 
-    if (!anim.bone_transforms.empty()) {
-        GEngine->get_renderer()->draw_animated_model(transform, &model, anim.bone_transforms.data(), anim.bone_transforms.size());
+    if (pool.get_capacity() != emitter.max_particles) {
+        pool.set_capacity(emitter.max_particles);
     }
+
+    Renderer* renderer = GEngine->get_renderer();
+
+    // Bounds of the last update, the emitter included so an empty one is found too
+    const glm::vec3 padding = glm::vec3(emitter.size * 0.5f);
+    const glm::vec3 min     = glm::min(pool.get_bounds_min(), t.position) - padding;
+    const glm::vec3 max     = glm::max(pool.get_bounds_max(), t.position) + padding;
+
+    emitter.is_visible = renderer->is_box_visible_3d(min, max);
+
+    if (!emitter.is_visible) {
+        return;
+    }
+
+    const float dt  = static_cast<float>(GEngine->get_timer().delta);
+    const int count = take_emit_count(emitter.emit_accumulator, emitter.is_emitting ? emitter.rate : 0.0f, dt);
+
+    if (count > 0) {
+        const float length   = glm::length(emitter.direction);
+        const glm::vec3 axis = length > 0.0f ? emitter.direction / length : glm::vec3(0, 1, 0);
+
+        // Basis around the cone axis
+        const glm::vec3 reference = SDL_fabsf(axis.y) < 0.99f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+        const glm::vec3 tangent   = glm::normalize(glm::cross(reference, axis));
+        const glm::vec3 bitangent = glm::cross(axis, tangent);
+
+        const float cos_spread = SDL_cosf(emitter.spread);
+
+        for (int i = 0; i < count; i++) {
+            // Uniform over the spherical cap of the cone
+            const float cos_theta = 1.0f - next_particle_random(emitter.random_state) * (1.0f - cos_spread);
+            const float sin_theta = SDL_sqrtf(SDL_max(0.0f, 1.0f - cos_theta * cos_theta));
+            const float phi       = next_particle_random(emitter.random_state) * glm::two_pi<float>();
+
+            const glm::vec3 direction = axis * cos_theta + (tangent * SDL_cosf(phi) + bitangent * SDL_sinf(phi)) * sin_theta;
+            const float speed         = vary(emitter.speed, emitter.speed_variation, emitter.random_state);
+            const float lifetime      = vary(emitter.lifetime, emitter.lifetime_variation, emitter.random_state);
+
+            if (!pool.emit(t.position, direction * speed, lifetime)) {
+                emitter.emit_accumulator = 0.0f;
+                break;
+            }
+        }
+    }
+
+    pool.update(dt, emitter.gravity, emitter.damping, emitter.color_start, emitter.color_end);
+
+    renderer->draw_particles_3d(pool, emitter.size);
 }
 
 #pragma endregion
@@ -365,7 +571,11 @@ void setup_scripts_system(flecs::entity e, Script& script) {
     const std::string& lua_script = lua_file.get_file_as_str();
 
     // Load & execute script file
-    if (luaL_loadstring(script.lua_state, lua_script.c_str()) || lua_pcall(script.lua_state, 0, 0, 0)) {
+    PROFILE_BEGIN("Lua::load_script");
+    const bool has_failed = luaL_loadstring(script.lua_state, lua_script.c_str()) || lua_pcall(script.lua_state, 0, 0, 0);
+    PROFILE_END();
+
+    if (has_failed) {
         const char* err = lua_tostring(script.lua_state, -1);
         LOG_ERROR("Failed to load script %s: %s", script.path.c_str(), err);
         lua_pop(script.lua_state, 1);
@@ -376,9 +586,14 @@ void setup_scripts_system(flecs::entity e, Script& script) {
 
     push_entity_to_lua(script.lua_state, e);
 
+    lua_getglobal(script.lua_state, "_input");
+    script.has_input = lua_isfunction(script.lua_state, -1);
+    lua_pop(script.lua_state, 1);
+
     // Call _ready() if it exists
     lua_getglobal(script.lua_state, "_ready");
     if (lua_isfunction(script.lua_state, -1)) {
+        PROFILE_SCOPE("Lua::_ready");
         if (lua_pcall(script.lua_state, 0, 0, 0) != LUA_OK) {
             const char* err = lua_tostring(script.lua_state, -1);
             LOG_ERROR("Error in _ready() of %s: %s", script.path.c_str(), err);
@@ -391,24 +606,23 @@ void setup_scripts_system(flecs::entity e, Script& script) {
     }
 }
 
-void process_event_scripts_system(const Script& script, const SDL_Event& event) {
-    if (!script.ready_called || !script.lua_state) {
+void process_event_scripts_system(const Script& script, const std::vector<SDL_Event>& events) {
+    if (!script.ready_called || !script.lua_state || !script.has_input) {
         return;
     }
 
-    lua_getglobal(script.lua_state, "_input");
+    PROFILE_SCOPE("Lua::_input");
 
-    if (!lua_isfunction(script.lua_state, -1)) {
-        lua_pop(script.lua_state, 1);
-        return;
-    }
+    for (const SDL_Event& event : events) {
+        lua_getglobal(script.lua_state, "_input");
 
-    push_sdl_event_to_lua(script.lua_state, event);
+        push_sdl_event_to_lua(script.lua_state, event);
 
-    if (lua_pcall(script.lua_state, 1, 0, 0) != LUA_OK) {
-        const char* err_msg = lua_tostring(script.lua_state, -1);
-        LOG_ERROR("Error in _input() of %s: %s", script.path.c_str(), err_msg);
-        lua_pop(script.lua_state, 1);
+        if (lua_pcall(script.lua_state, 1, 0, 0) != LUA_OK) {
+            const char* err_msg = lua_tostring(script.lua_state, -1);
+            LOG_ERROR("Error in _input() of %s: %s", script.path.c_str(), err_msg);
+            lua_pop(script.lua_state, 1);
+        }
     }
 }
 
@@ -421,6 +635,7 @@ void process_scripts_system(Script& script) {
     // Call _process
     lua_getglobal(script.lua_state, "_process");
     if (lua_isfunction(script.lua_state, -1)) {
+        PROFILE_SCOPE("Lua::_process");
         lua_pushnumber(script.lua_state, static_cast<lua_Number>(GEngine->get_timer().delta));
 
         if (lua_pcall(script.lua_state, 1, 0, 0) != LUA_OK) {
@@ -435,6 +650,7 @@ void process_scripts_system(Script& script) {
     // Call _draw
     lua_getglobal(script.lua_state, "_draw");
     if (lua_isfunction(script.lua_state, -1)) {
+        PROFILE_SCOPE("Lua::_draw");
         if (lua_pcall(script.lua_state, 0, 0, 0) != LUA_OK) {
             const char* err_msg = lua_tostring(script.lua_state, -1);
             LOG_ERROR("Error in _draw() of %s: %s", script.path.c_str(), err_msg);
@@ -445,6 +661,40 @@ void process_scripts_system(Script& script) {
     }
 }
 
+void process_physics_scripts_system(Script& script) {
+    if (!script.ready_called || !script.lua_state) {
+        return;
+    }
+
+    lua_getglobal(script.lua_state, "_physics_process");
+    if (!lua_isfunction(script.lua_state, -1)) {
+        lua_pop(script.lua_state, 1);
+        return;
+    }
+
+    PROFILE_SCOPE("Lua::_physics_process");
+
+    lua_pushnumber(script.lua_state, static_cast<lua_Number>(GEngine->get_timer().fixed_delta));
+
+    if (lua_pcall(script.lua_state, 1, 0, 0) != LUA_OK) {
+        const char* err_msg = lua_tostring(script.lua_state, -1);
+        LOG_ERROR("Error in _physics_process() of %s: %s", script.path.c_str(), err_msg);
+        lua_pop(script.lua_state, 1);
+    }
+}
+
+void store_previous_transform_2d_system(const Transform2D& t, Interpolation2D& previous) {
+    previous.position = t.position;
+    previous.scale    = t.scale;
+    previous.rotation = t.rotation;
+    previous.is_valid = true;
+}
+
+void store_previous_transform_3d_system(const Transform3D& t, Interpolation3D& previous) {
+    previous.previous = t;
+    previous.is_valid = true;
+}
+
 void scene_manager_system(flecs::world& world) {
     world.observer<SceneChangeRequest>("SceneChangeRequest_Observer")
         .event(flecs::OnSet)
@@ -0,0 +1,452 @@
+#include "core/component/logic/tilemap_2d.h"
+
+#include "core/io/file_system.h"
+
+
+namespace {
+
+    constexpr char BINARY_MAGIC[4] = {'E', 'T', 'M', '1'};
+
+    constexpr int CHUNK_TILES = TileMap2D::CHUNK_SIZE * TileMap2D::CHUNK_SIZE;
+
+    /// Bounds checked little endian reader over a file loaded in memory
+    struct BinaryReader {
+        const std::vector<char>& bytes;
+        size_t offset = 0;
+
+        bool read(void* data, size_t size) {
+            if (offset + size > bytes.size()) {
+                return false;
+            }
+
+            SDL_memcpy(data, bytes.data() + offset, size);
+            offset += size;
+            return true;
+        }
+
+        bool read_u16(Uint16& value) {
+            if (!read(&value, sizeof(value))) {
+                return false;
+            }
+            value = SDL_Swap16LE(value);
+            return true;
+        }
+
+        bool read_u32(Uint32& value) {
+            if (!read(&value, sizeof(value))) {
+                return false;
+            }
+            value = SDL_Swap32LE(value);
+            return true;
+        }
+
+        bool read_float(float& value) {
+            if (!read(&value, sizeof(value))) {
+                return false;
+            }
+            value = SDL_SwapFloatLE(value);
+            return true;
+        }
+    };
+
+    void write_bytes(std::vector<char>& out, const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    void write_u16(std::vector<char>& out, Uint16 value) {
+        value = SDL_Swap16LE(value);
+        write_bytes(out, &value, sizeof(value));
+    }
+
+    void write_u32(std::vector<char>& out, Uint32 value) {
+        value = SDL_Swap32LE(value);
+        write_bytes(out, &value, sizeof(value));
+    }
+
+    void write_float(std::vector<char>& out, float value) {
+        value = SDL_SwapFloatLE(value);
+        write_bytes(out, &value, sizeof(value));
+    }
+
+    /// Maps larger than this are rejected as corrupted files (64M tiles, 128 MB of ids), also keeps each side in an int
+    constexpr Uint64 MAX_TILES = 1ull << 26;
+
+    bool is_valid_size(Uint64 width, Uint64 height) {
+        return width <= MAX_TILES && height <= MAX_TILES && width * height <= MAX_TILES;
+    }
+
+    /// Positive and finite, NaN fails the comparisons
+    bool is_valid_tile_size(glm::vec2 size) {
+        return size.x > 0.0f && size.y > 0.0f && !SDL_isinff(size.x) && !SDL_isinff(size.y);
+    }
+
+    /// A missing dimension is 0, anything else must be a non-negative integer
+    bool get_json_dimension(const Json& json, const char* key, Uint64& value) {
+        const auto it = json.find(key);
+
+        if (it == json.end()) {
+            value = 0;
+            return true;
+        }
+
+        if (!it->is_number_unsigned()) {
+            return false;
+        }
+
+        value = it->get<Uint64>();
+        return true;
+    }
+
+    bool load_json(TileMap2D& map, const std::string& text, const std::string& path) {
+        const Json json = Json::parse(text, nullptr, false);
+
+        if (json.is_discarded() || !json.is_object() || !json.contains("tiles") || !json["tiles"].is_array()) {
+            LOG_ERROR("TileMap: invalid json %s", path.c_str());
+            return false;
+        }
+
+        // Everything is checked before the map is touched, a bad file leaves it as it was
+        Uint64 width  = 0;
+        Uint64 height = 0;
+
+        if (!get_json_dimension(json, "width", width) || !get_json_dimension(json, "height", height) || !is_valid_size(width, height)) {
+            LOG_ERROR("TileMap: invalid size in %s", path.c_str());
+            return false;
+        }
+
+        std::string texture_name = map.texture_name;
+
+        if (json.contains("texture")) {
+            if (!json["texture"].is_string()) {
+                LOG_ERROR("TileMap: texture is not a string in %s", path.c_str());
+                return false;
+            }
+
+            texture_name = json["texture"].get<std::string>();
+        }
+
+        glm::vec2 tile_size = map.tile_size;
+
+        if (json.contains("tile_size")) {
+            const Json& size = json["tile_size"];
+
+            if (!size.is_array() || size.size() != 2 || !size[0].is_number() || !size[1].is_number()) {
+                LOG_ERROR("TileMap: tile_size is not [width, height] in %s", path.c_str());
+                return false;
+            }
+
+            tile_size = {size[0].get<float>(), size[1].get<float>()};
+        }
+
+        if (!is_valid_tile_size(tile_size)) {
+            LOG_ERROR("TileMap: invalid tile_size in %s", path.c_str());
+            return false;
+        }
+
+        const Json& tiles  = json["tiles"];
+        const size_t count = SDL_min(tiles.size(), static_cast<size_t>(width * height));
+
+        for (size_t i = 0; i < count; i++) {
+            if (!tiles[i].is_number_unsigned() || tiles[i].get<Uint64>() > SDL_MAX_UINT16) {
+                LOG_ERROR("TileMap: tile %zu is not an id in [0, %u] in %s", i, SDL_MAX_UINT16, path.c_str());
+                return false;
+            }
+        }
+
+        map.texture_name = texture_name;
+        map.tile_size    = tile_size;
+        resize_tilemap(map, static_cast<int>(width), static_cast<int>(height));
+
+        for (size_t i = 0; i < count; i++) {
+            set_tile(map, static_cast<int>(i % width), static_cast<int>(i / width), tiles[i].get<Uint16>());
+        }
+
+        return true;
+    }
+
+    bool load_binary(TileMap2D& map, const std::vector<char>& bytes, const std::string& path) {
+        BinaryReader reader{bytes};
+
+        char magic[4]         = {};
+        Uint32 width          = 0;
+        Uint32 height         = 0;
+        glm::vec2 tile_size   = {0, 0};
+        Uint16 texture_length = 0;
+
+        if (!reader.read(magic, sizeof(magic)) || SDL_memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0) {
+            LOG_ERROR("TileMap: %s is not a tilemap file", path.c_str());
+            return false;
+        }
+
+        if (!reader.read_u32(width) || !reader.read_u32(height) || !reader.read_float(tile_size.x) || !reader.read_float(tile_size.y) ||
+            !reader.read_u16(texture_length)) {
+            LOG_ERROR("TileMap: truncated header in %s", path.c_str());
+            return false;
+        }
+
+        if (!is_valid_size(width, height)) {
+            LOG_ERROR("TileMap: invalid size %ux%u in %s", width, height, path.c_str());
+            return false;
+        }
+
+        if (!is_valid_tile_size(tile_size)) {
+            LOG_ERROR("TileMap: invalid tile_size in %s", path.c_str());
+            return false;
+        }
+
+        std::string texture_name(texture_length, '\0');
+
+        if (!reader.read(texture_name.data(), texture_length)) {
+            LOG_ERROR("TileMap: truncated header in %s", path.c_str());
+            return false;
+        }
+
+        // Runs are decoded into a new map, a truncated file leaves `map` as it was
+        TileMap2D loaded;
+        loaded.texture_name = texture_name;
+        loaded.tile_size    = tile_size;
+        loaded.color        = map.color;
+        loaded.frame        = map.frame;
+        resize_tilemap(loaded, static_cast<int>(width), static_cast<int>(height));
+
+        const Uint64 total = static_cast<Uint64>(width) * height;
+        Uint64 index       = 0;
+
+        while (index < total) {
+            Uint16 count = 0;
+            Uint16 tile  = 0;
+
+            if (!reader.read_u16(count) || !reader.read_u16(tile) || count == 0) {
+                LOG_ERROR("TileMap: truncated tiles in %s", path.c_str());
+                return false;
+            }
+
+            const Uint64 end = SDL_min(index + count, total);
+
+            // Empty runs only move forward, the chunks are already cleared
+            if (tile == TILE_EMPTY) {
+                index = end;
+                continue;
+            }
+
+            for (; index < end; index++) {
+                set_tile(loaded, static_cast<int>(index % width), static_cast<int>(index / width), tile);
+            }
+        }
+
+        map = std::move(loaded);
+        return true;
+    }
+
+} // namespace
+
+
+void resize_tilemap(TileMap2D& map, int width, int height) {
+    map.width    = SDL_max(width, 0);
+    map.height   = SDL_max(height, 0);
+    map.chunks_x = (map.width + TileMap2D::CHUNK_SIZE - 1) / TileMap2D::CHUNK_SIZE;
+    map.chunks_y = (map.height + TileMap2D::CHUNK_SIZE - 1) / TileMap2D::CHUNK_SIZE;
+
+    map.chunks.clear();
+    map.chunks.resize(static_cast<size_t>(map.chunks_x) * map.chunks_y);
+}
+
+Uint16 get_tile(const TileMap2D& map, int x, int y) {
+    if (x < 0 || y < 0 || x >= map.width || y >= map.height) {
+        return TILE_EMPTY;
+    }
+
+    const TileChunk2D& chunk = map.chunks[static_cast<size_t>(y / TileMap2D::CHUNK_SIZE) * map.chunks_x + x / TileMap2D::CHUNK_SIZE];
+
+    if (chunk.tiles.empty()) {
+        return TILE_EMPTY;
+    }
+
+    return chunk.tiles[(y % TileMap2D::CHUNK_SIZE) * TileMap2D::CHUNK_SIZE + x % TileMap2D::CHUNK_SIZE];
+}
+
+void set_tile(TileMap2D& map, int x, int y, Uint16 tile) {
+    if (x < 0 || y < 0 || x >= map.width || y >= map.height) {
+        return;
+    }
+
+    TileChunk2D& chunk = map.chunks[static_cast<size_t>(y / TileMap2D::CHUNK_SIZE) * map.chunks_x + x / TileMap2D::CHUNK_SIZE];
+
+    if (chunk.tiles.empty()) {
+        if (tile == TILE_EMPTY) {
+            return;
+        }
+
+        chunk.tiles.assign(CHUNK_TILES, TILE_EMPTY);
+    }
+
+    Uint16& cell = chunk.tiles[(y % TileMap2D::CHUNK_SIZE) * TileMap2D::CHUNK_SIZE + x % TileMap2D::CHUNK_SIZE];
+
+    if (cell == tile) {
+        return;
+    }
+
+    chunk.tile_count += (cell == TILE_EMPTY) - (tile == TILE_EMPTY);
+    cell           = tile;
+    chunk.is_dirty = true;
+}
+
+Rect2D get_tilemap_local_bounds(const TileMap2D& map) {
+    return {{0.0f, 0.0f}, glm::vec2(map.width, map.height) * map.tile_size};
+}
+
+bool get_visible_chunks(const TileMap2D& map, const Transform2D& t, const Rect2D& view, glm::ivec2& min, glm::ivec2& max) {
+    if (map.chunks.empty() || map.tile_size.x <= 0.0f || map.tile_size.y <= 0.0f) {
+        return false;
+    }
+
+    min = {0, 0};
+    max = {map.chunks_x - 1, map.chunks_y - 1};
+
+    const bool is_bounded = SDL_fabsf(view.min.x) < FLT_MAX && SDL_fabsf(view.min.y) < FLT_MAX && SDL_fabsf(view.max.x) < FLT_MAX &&
+                            SDL_fabsf(view.max.y) < FLT_MAX;
+
+    if (!is_bounded) {
+        return true;
+    }
+
+    if (t.world_scale.x == 0.0f || t.world_scale.y == 0.0f) {
+        return false;
+    }
+
+    // View corners back into the map space: undo the translation, the rotation, then the scale
+    const float cosr = SDL_cosf(t.world_rotation);
+    const float sinr = SDL_sinf(t.world_rotation);
+
+    glm::vec2 corners[4] = {view.min, {view.max.x, view.min.y}, view.max, {view.min.x, view.max.y}};
+
+    for (glm::vec2& corner : corners) {
+        const glm::vec2 d = corner - t.world_position;
+        corner            = glm::vec2(d.x * cosr + d.y * sinr, -d.x * sinr + d.y * cosr) / t.world_scale;
+    }
+
+    const Rect2D local         = Rect2D::from_points(corners, 4);
+    const glm::vec2 chunk_size = map.tile_size * static_cast<float>(TileMap2D::CHUNK_SIZE);
+
+    const glm::vec2 first = glm::floor(local.min / chunk_size);
+    const glm::vec2 last  = glm::floor(local.max / chunk_size);
+
+    if (last.x < 0.0f || last.y < 0.0f || first.x >= map.chunks_x || first.y >= map.chunks_y) {
+        return false;
+    }
+
+    min = glm::ivec2(glm::max(first, glm::vec2(0.0f)));
+    max = glm::ivec2(glm::min(last, glm::vec2(map.chunks_x - 1, map.chunks_y - 1)));
+    return true;
+}
+
+void build_tile_chunk(TileMap2D& map, int chunk_x, int chunk_y, glm::vec4 source, glm::vec2 texture_size) {
+    TileChunk2D& chunk = map.chunks[static_cast<size_t>(chunk_y) * map.chunks_x + chunk_x];
+
+    chunk.positions.clear();
+    chunk.uvs.clear();
+    chunk.is_dirty = false;
+
+    const int columns = static_cast<int>(source.z / map.tile_size.x);
+    const int rows    = static_cast<int>(source.w / map.tile_size.y);
+
+    if (chunk.tile_count == 0 || columns <= 0 || rows <= 0 || texture_size.x <= 0.0f || texture_size.y <= 0.0f) {
+        return;
+    }
+
+    chunk.positions.reserve(static_cast<size_t>(chunk.tile_count) * 4);
+    chunk.uvs.reserve(static_cast<size_t>(chunk.tile_count) * 4);
+
+    const glm::vec2 uv_scale = 1.0f / texture_size;
+    const glm::ivec2 origin  = glm::ivec2(chunk_x, chunk_y) * TileMap2D::CHUNK_SIZE;
+
+    for (int y = 0; y < TileMap2D::CHUNK_SIZE; y++) {
+        for (int x = 0; x < TileMap2D::CHUNK_SIZE; x++) {
+            const Uint16 tile = chunk.tiles[y * TileMap2D::CHUNK_SIZE + x];
+
+            // Ids past the tileset are skipped, not wrapped around
+            if (tile == TILE_EMPTY || tile > columns * rows) {
+                continue;
+            }
+
+            const glm::vec2 min = glm::vec2(origin.x + x, origin.y + y) * map.tile_size;
+            const glm::vec2 max = min + map.tile_size;
+
+            chunk.positions.insert(chunk.positions.end(), {min, {max.x, min.y}, max, {min.x, max.y}});
+
+            const int cell         = tile - 1;
+            const glm::vec2 uv_min = (glm::vec2(source.x, source.y) + glm::vec2(cell % columns, cell / columns) * map.tile_size) * uv_scale;
+            const glm::vec2 uv_max = uv_min + map.tile_size * uv_scale;
+
+            chunk.uvs.insert(chunk.uvs.end(), {uv_min, {uv_max.x, uv_min.y}, uv_max, {uv_min.x, uv_max.y}});
+        }
+    }
+}
+
+bool load_tilemap(TileMap2D& map, const std::string& path) {
+    PROFILE_SCOPE("load_tilemap");
+
+    FileAccess file(path, ModeFlags::READ);
+
+    if (!file.is_open()) {
+        LOG_ERROR("TileMap: failed to open %s", path.c_str());
+        return false;
+    }
+
+    const bool is_json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+
+    const bool is_loaded = is_json ? load_json(map, file.get_file_as_str(), path) : load_binary(map, file.get_file_as_bytes(), path);
+
+    if (is_loaded) {
+        LOG_INFO("TileMap: loaded %s (%dx%d tiles, %zu chunks)", path.c_str(), map.width, map.height, map.chunks.size());
+    }
+
+    return is_loaded;
+}
+
+bool save_tilemap(const TileMap2D& map, const std::string& path) {
+    std::vector<char> bytes;
+
+    write_bytes(bytes, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    write_u32(bytes, static_cast<Uint32>(map.width));
+    write_u32(bytes, static_cast<Uint32>(map.height));
+    write_float(bytes, map.tile_size.x);
+    write_float(bytes, map.tile_size.y);
+
+    const Uint16 texture_length = static_cast<Uint16>(SDL_min(map.texture_name.size(), size_t{UINT16_MAX}));
+    write_u16(bytes, texture_length);
+    write_bytes(bytes, map.texture_name.data(), texture_length);
+
+    Uint16 run_tile  = TILE_EMPTY;
+    Uint32 run_count = 0;
+
+    for (int y = 0; y < map.height; y++) {
+        for (int x = 0; x < map.width; x++) {
+            const Uint16 tile = get_tile(map, x, y);
+
+            if (run_count > 0 && (tile != run_tile || run_count == UINT16_MAX)) {
+                write_u16(bytes, static_cast<Uint16>(run_count));
+                write_u16(bytes, run_tile);
+                run_count = 0;
+            }
+
+            run_tile = tile;
+            run_count++;
+        }
+    }
+
+    if (run_count > 0) {
+        write_u16(bytes, static_cast<Uint16>(run_count));
+        write_u16(bytes, run_tile);
+    }
+
+    FileAccess file(path, ModeFlags::WRITE);
+
+    if (!file.is_open() || !file.store_bytes(bytes)) {
+        LOG_ERROR("TileMap: failed to write %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -1,33 +1,102 @@
 #include "core/ember_utils.h"
 
+#include <array>
+
+
+uint32_t utf8_decode(const char* text, size_t size, size_t& index) {
+    const auto* bytes        = reinterpret_cast<const unsigned char*>(text);
+    const unsigned char lead = bytes[index];
+
+    if (lead < 0x80) {
+        index++;
+        return lead;
+    }
+
+    int length         = 0;
+    uint32_t cp        = 0;
+    uint32_t min_value = 0;
+
+    if ((lead & 0xE0) == 0xC0) {
+        length    = 2;
+        cp        = lead & 0x1F;
+        min_value = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length    = 3;
+        cp        = lead & 0x0F;
+        min_value = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length    = 4;
+        cp        = lead & 0x07;
+        min_value = 0x10000;
+    } else {
+        index++;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+
+    if (index + length > size) {
+        index++;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+
+    for (int i = 1; i < length; i++) {
+        const unsigned char continuation = bytes[index + i];
+
+        if ((continuation & 0xC0) != 0x80) {
+            index++;
+            return UTF8_REPLACEMENT_CHARACTER;
+        }
+
+        cp = (cp << 6) | (continuation & 0x3F);
+    }
+
+    // Overlong forms, UTF-16 surrogates and values past U+10FFFF are not valid UTF-8
+    if (cp < min_value || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+        index++;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+
+    index += length;
+    return cp;
+}
+
+size_t utf8_skip_ascii(const char* text, size_t size, size_t index) {
+#if defined(EMBER_HAS_SSE2)
+    // The high bit of every byte is set for non-ASCII, movemask gathers them
+    while (index + 16 <= size) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + index));
+
+        if (_mm_movemask_epi8(chunk) != 0) {
+            break;
+        }
+        index += 16;
+    }
+#endif
+
+    // 8 bytes at a time on other targets (and for the tail)
+    while (index + 8 <= size) {
+        uint64_t word;
+        SDL_memcpy(&word, text + index, sizeof(word));
+
+        if ((word & 0x8080808080808080ULL) != 0) {
+            break;
+        }
+        index += 8;
+    }
+
+    while (index < size && static_cast<unsigned char>(text[index]) < 0x80) {
+        index++;
+    }
+
+    return index;
+}
 
 std::vector<uint32_t> utf8_to_utf32(const std::string& utf8) {
     std::vector<uint32_t> result;
-    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(utf8.c_str());
-    size_t i                   = 0;
-    while (i < utf8.length()) {
-        uint32_t cp = 0;
-        int n       = 1;
-        if (bytes[i] <= 0x7F) {
-            cp = bytes[i];
-        } else if ((bytes[i] & 0xE0) == 0xC0) {
-            n  = 2;
-            cp = (bytes[i] & 0x1F) << 6;
-            cp |= (bytes[i + 1] & 0x3F);
-        } else if ((bytes[i] & 0xF0) == 0xE0) {
-            n  = 3;
-            cp = (bytes[i] & 0x0F) << 12;
-            cp |= (bytes[i + 1] & 0x3F) << 6;
-            cp |= (bytes[i + 2] & 0x3F);
-        } else if ((bytes[i] & 0xF8) == 0xF0) {
-            n  = 4;
-            cp = (bytes[i] & 0x07) << 18;
-            cp |= (bytes[i + 1] & 0x3F) << 12;
-            cp |= (bytes[i + 2] & 0x3F) << 6;
-            cp |= (bytes[i + 3] & 0x3F);
-        }
-        result.push_back(cp);
-        i += n;
+    result.reserve(utf8.size());
+
+    size_t i = 0;
+    while (i < utf8.size()) {
+        result.push_back(utf8_decode(utf8.data(), utf8.size(), i));
     }
     return result;
 }
@@ -52,8 +121,55 @@ std::string utf32_to_utf8(uint32_t cp) {
     return r;
 }
 
+namespace {
+
+    struct CodepointRange {
+        uint32_t first;
+        uint32_t last;
+    };
+
+    // Supplementary plane ranges, all aligned to 16 code points so one bit covers a block
+    constexpr CodepointRange EMOJI_RANGES[] = {
+        {0x1F1E0, 0x1F1FF}, // Regional indicators (flags)
+        {0x1F300, 0x1F5FF}, // Misc symbols and pictographs
+        {0x1F600, 0x1F64F}, // Emoticons
+        {0x1F680, 0x1F6FF}, // Transport and map
+        {0x1F900, 0x1F9FF}, // Supplemental symbols and pictographs
+        {0x1FA70, 0x1FAFF}, // Symbols and pictographs extended-A
+    };
+
+    constexpr uint32_t EMOJI_BITMAP_FIRST = 0x1F000;
+    constexpr uint32_t EMOJI_BITMAP_END   = 0x1FB00;
+    constexpr uint32_t EMOJI_BLOCK_SHIFT  = 4; /// One bit per 16 code points
+
+    constexpr size_t EMOJI_BITMAP_WORDS = ((EMOJI_BITMAP_END - EMOJI_BITMAP_FIRST) >> EMOJI_BLOCK_SHIFT) / 64 + 1;
+
+    constexpr std::array<uint64_t, EMOJI_BITMAP_WORDS> make_emoji_bitmap() {
+        std::array<uint64_t, EMOJI_BITMAP_WORDS> bitmap{};
+
+        for (const auto& range : EMOJI_RANGES) {
+            for (uint32_t block = (range.first - EMOJI_BITMAP_FIRST) >> EMOJI_BLOCK_SHIFT; block <= (range.last - EMOJI_BITMAP_FIRST) >> EMOJI_BLOCK_SHIFT;
+                 block++) {
+                bitmap[block / 64] |= uint64_t{1} << (block % 64);
+            }
+        }
+        return bitmap;
+    }
+
+    constexpr std::array<uint64_t, EMOJI_BITMAP_WORDS> EMOJI_BITMAP = make_emoji_bitmap();
+
+} // namespace
+
 bool is_character_emoji(uint32_t cp) {
-    return (cp >= 0x1F600 && cp <= 0x1F64F) || (cp >= 0x1F300 && cp <= 0x1F5FF) || (cp >= 0x1F680 && cp <= 0x1F6FF)
-        || (cp >= 0x1F1E0 && cp <= 0x1F1FF) || (cp >= 0x2600 && cp <= 0x26FF) || (cp >= 0x2700 && cp <= 0x27BF)
-        || (cp >= 0x1F900 && cp <= 0x1F9FF) || (cp >= 0x1FA70 && cp <= 0x1FAFF);
+    // Misc symbols (U+2600..U+26FF) and dingbats (U+2700..U+27BF) are contiguous
+    if (cp < EMOJI_BITMAP_FIRST) {
+        return cp >= 0x2600 && cp <= 0x27BF;
+    }
+
+    if (cp >= EMOJI_BITMAP_END) {
+        return false;
+    }
+
+    const uint32_t block = (cp - EMOJI_BITMAP_FIRST) >> EMOJI_BLOCK_SHIFT;
+    return (EMOJI_BITMAP[block / 64] >> (block % 64)) & 1;
 }
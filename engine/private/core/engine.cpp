@@ -29,6 +29,11 @@ Renderer* create_renderer_internal(SDL_Window* window, EngineConfig& config) {
             renderer = new SDLRenderer();
             break;
         }
+    case Backend::NONE:
+        {
+            renderer = new NullRenderer();
+            break;
+        }
     }
 
     if (!renderer || !renderer->initialize(window)) {
@@ -44,6 +49,46 @@ Renderer* create_renderer_internal(SDL_Window* window, EngineConfig& config) {
 }
 
 
+float get_window_refresh_rate(SDL_Window* window) {
+    const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+
+    return mode ? mode->refresh_rate : 0.0f;
+}
+
+bool should_throttle_window(SDL_Window* window) {
+    if (!window) {
+        return false;
+    }
+
+    const SDL_WindowFlags flags = SDL_GetWindowFlags(window);
+
+    return (flags & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN | SDL_WINDOW_OCCLUDED)) != 0 || (flags & SDL_WINDOW_INPUT_FOCUS) == 0;
+}
+
+
+int get_worker_thread_count(int worker_threads) {
+    if (worker_threads > 0) {
+        return worker_threads;
+    }
+
+    // -1 (auto): one worker per logical core
+    return SDL_max(1, SDL_GetNumLogicalCPUCores());
+}
+
+
+void dump_profiler_trace() {
+    auto& profiler = Profiler::get_instance();
+
+    if (!profiler.is_enabled()) {
+        LOG_WARN("Profiler is disabled, enable <profiler> in project.xml to record traces");
+        return;
+    }
+
+    const std::string path = "user://profiler_trace_" + std::to_string(SDL_GetTicks()) + ".json";
+    profiler.dump_chrome_trace(path);
+}
+
+
 bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 window_flags) {
 
     // NOTE: set log only in debug mode
@@ -58,6 +103,10 @@ bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 wi
         LOG_CRITICAL("Failed to load config file (project.xml)");
     }
 
+    if (backend_override) {
+        _config.get_renderer_device().backend = *backend_override;
+    }
+
     const auto& app_config = _config.get_application();
 
 
@@ -71,6 +120,14 @@ bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 wi
 
     const auto& renderer_config = _config.get_renderer_device();
 
+    const bool is_headless = renderer_config.backend == Backend::NONE;
+
+    if (is_headless) {
+        // Nothing is ever presented, keep the window (if any) out of the way
+        window_flags |= SDL_WINDOW_HIDDEN;
+        window_flags &= ~SDL_WINDOW_FULLSCREEN;
+    }
+
     if (renderer_config.backend == Backend::GL_COMPATIBILITY) {
         window_flags |= SDL_WINDOW_OPENGL;
 
@@ -97,8 +154,20 @@ bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 wi
 
 
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMEPAD | SDL_INIT_JOYSTICK | SDL_INIT_AUDIO)) {
-        LOG_ERROR("Engine initialization failed %s", SDL_GetError());
-        return false;
+
+        if (!is_headless) {
+            LOG_ERROR("Engine initialization failed %s", SDL_GetError());
+            return false;
+        }
+
+        // GPU-less CI boxes have no display (and often no audio device either)
+        LOG_WARN("Engine initialization failed %s, retrying with the dummy video driver", SDL_GetError());
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+
+        if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
+            LOG_ERROR("Engine initialization failed %s", SDL_GetError());
+            return false;
+        }
     }
 
 
@@ -117,13 +186,13 @@ bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 wi
 
     int driver_count = SDL_GetNumRenderDrivers();
 
-    if (driver_count < 1) {
+    if (driver_count < 1 && !is_headless) {
         LOG_ERROR("No render drivers available");
         return false;
     }
 
     std::string renderer_list;
-    renderer_list.reserve(driver_count * 16);
+    renderer_list.reserve(SDL_max(driver_count, 0) * 16);
     for (int i = 0; i < driver_count; ++i) {
         const char* name = SDL_GetRenderDriver(i);
         renderer_list += name;
@@ -135,7 +204,9 @@ bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 wi
 
     _window = SDL_CreateWindow(app_config.name, window_w, window_h, window_flags);
 
-    if (!_window) {
+    if (!_window && is_headless) {
+        LOG_WARN("Window creation failed %s, running without a window", SDL_GetError());
+    } else if (!_window) {
         LOG_ERROR("Window creation failed %s", SDL_GetError());
         SDL_Quit();
         return false;
@@ -147,7 +218,7 @@ bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 wi
     SDL_Surface* logo_surface = nullptr;
     stbi_uc* logo_pixels = stbi_load((ASSETS_PATH + "icon.png").c_str(), &w, &h, &channels, 4);
 
-    if (logo_pixels) {
+    if (logo_pixels && _window) {
         logo_surface = SDL_CreateSurfaceFrom( w, h,SDL_PIXELFORMAT_RGBA32, logo_pixels,w * 4);
         SDL_SetWindowIcon(_window, logo_surface);
         SDL_DestroySurface(logo_surface);
@@ -177,14 +248,73 @@ bool Engine::initialize(int window_w, int window_h, const char* title, Uint32 wi
     }
 
 
+    const float refresh_rate = get_window_refresh_rate(_window);
+
+    _frame_pacer.set_target_fps(app_config.max_fps);
+    _frame_pacer.set_background_fps(app_config.background_fps);
+    _frame_pacer.set_vsync(_config.is_vsync() && !is_headless, refresh_rate);
+
+    LOG_INFO("Frame Pacing -> MaxFPS: %d, BackgroundFPS: %d, VSync: %s, RefreshRate: %.2f Hz", app_config.max_fps, app_config.background_fps,
+             _config.is_vsync() ? "ON" : "OFF", refresh_rate);
+
+    const auto& performance_config = _config.get_performance();
+
+    if (performance_config.physics_fps > 0) {
+        _timer.fixed_delta = 1.0 / static_cast<double>(performance_config.physics_fps);
+    } else {
+        LOG_WARN("Invalid physics_fps (%d), using %.0f Hz", performance_config.physics_fps, 1.0 / _timer.fixed_delta);
+    }
+
+    _input.initialize(_config.get_input_map().actions);
+
     _renderer->load_font("default", "res/fonts/Default.ttf", 16);
     _renderer->load_font("emoji", "res/fonts/Twemoji.ttf", 16);
     _renderer->set_default_fonts("default", "emoji");
 
+    const auto& atlas_config = _config.get_texture_atlas();
+    TextureAtlas& atlas      = _renderer->get_texture_atlas();
+
+    atlas.configure(atlas_config.page_size, atlas_config.padding, atlas_config.max_image_size);
+
+    if (!atlas_config.manifest.empty()) {
+        atlas.load_manifest(*_renderer, atlas_config.manifest);
+    }
+
+    for (const auto& image : atlas_config.images) {
+        // Too large for the atlas, sprites load it by name as before
+        if (!atlas.queue_image(image.name, image.path)) {
+            _renderer->load_texture(image.name, image.path);
+        }
+    }
+
+    atlas.build(*_renderer);
+
 #pragma region SETUP_FLECS_WORLD
 
     serialize_components(this->_world);
 
+    Profiler::get_instance().initialize();
+    Profiler::get_instance().set_enabled(performance_config.is_profiling);
+
+    if (performance_config.is_profiling) {
+        LOG_INFO("Profiler enabled, press F10 to write a Chrome trace (user://)");
+    }
+
+    if (performance_config.is_multithreaded) {
+        const int threads = get_worker_thread_count(performance_config.worker_threads);
+
+        _world.set_threads(threads);
+
+        LOG_INFO("ECS Worker Threads: %d", threads);
+    }
+
+    // One render stage per flecs stage, the submit systems never share one
+    _renderer->set_stage_count(_world.get_stage_count());
+
+    _fixed_pipeline = _world.pipeline().with(flecs::System).with<phases::FixedUpdate>().build();
+
+    _render_list_2d.attach(_world);
+
     engine_setup_systems(this->_world);
 
 
@@ -212,6 +342,18 @@ Timer& Engine::get_timer() {
     return _timer;
 }
 
+FramePacer& Engine::get_frame_pacer() {
+    return _frame_pacer;
+}
+
+Input& Engine::get_input() {
+    return _input;
+}
+
+RenderList2D& Engine::get_render_list_2d() {
+    return _render_list_2d;
+}
+
 
 Renderer* Engine::get_renderer() const {
     return _renderer;
@@ -225,12 +367,32 @@ flecs::world& Engine::get_world() {
     return _world;
 }
 
+flecs::entity Engine::get_fixed_pipeline() const {
+    return _fixed_pipeline;
+}
+
+void engine_fixed_update() {
+    PROFILE_SCOPE("FixedUpdate");
+
+    Timer& timer    = GEngine->get_timer();
+    const int steps = timer.consume_fixed_steps();
+
+    for (int i = 0; i < steps; ++i) {
+        GEngine->get_world().run_pipeline(GEngine->get_fixed_pipeline(), static_cast<float>(timer.fixed_delta));
+    }
+}
+
 void engine_core_loop() {
+    PROFILE_SCOPE("Frame");
 
     GEngine->get_timer().tick();
 
+    PROFILE_BEGIN("Events");
+    Input& input = GEngine->get_input();
+    input.begin_frame();
 
     while (SDL_PollEvent(&GEngine->event)) {
+        input.process_event(GEngine->event);
 
         if (GEngine->event.type == SDL_EVENT_QUIT) {
             GEngine->is_running = false;
@@ -242,6 +404,10 @@ void engine_core_loop() {
             if (GEngine->event.key.scancode == SDL_SCANCODE_F9) {
                 GEngine->get_config().is_debug = !GEngine->get_config().is_debug;
             }
+
+            if (GEngine->event.key.scancode == SDL_SCANCODE_F10 && !GEngine->event.key.repeat) {
+                dump_profiler_trace();
+            }
         }
 
 
@@ -253,25 +419,58 @@ void engine_core_loop() {
             app_win.height = new_h;
         }
 
-        GEngine->get_world().each([&](flecs::entity e, const Script& script) { process_event_scripts_system(script, GEngine->event); });
+        switch (GEngine->event.type) {
+        case SDL_EVENT_WINDOW_MINIMIZED:
+        case SDL_EVENT_WINDOW_RESTORED:
+        case SDL_EVENT_WINDOW_SHOWN:
+        case SDL_EVENT_WINDOW_HIDDEN:
+        case SDL_EVENT_WINDOW_OCCLUDED:
+        case SDL_EVENT_WINDOW_EXPOSED:
+        case SDL_EVENT_WINDOW_FOCUS_GAINED:
+        case SDL_EVENT_WINDOW_FOCUS_LOST:
+            GEngine->get_frame_pacer().set_throttled(should_throttle_window(GEngine->get_window()));
+            break;
+        case SDL_EVENT_WINDOW_DISPLAY_CHANGED:
+            GEngine->get_frame_pacer().set_vsync(GEngine->get_config().is_vsync(), get_window_refresh_rate(GEngine->get_window()));
+            break;
+        default:
+            break;
+        }
+    }
+
+    input.dispatch();
+
+    // Legacy `_input(event)` callbacks, only scripts defining it and only the coalesced events
+    if (!input.get_events().empty()) {
+        GEngine->get_world().each([&](flecs::entity e, const Script& script) { process_event_scripts_system(script, input.get_events()); });
     }
+    PROFILE_END();
+
 
+    engine_fixed_update();
 
     GEngine->get_renderer()->clear(GEngine->get_config().get_environment().clear_color);
 
+    PROFILE_BEGIN("World::progress");
     GEngine->get_world().progress(static_cast<float>(GEngine->get_timer().delta));
+    PROFILE_END();
 
+    PROFILE_BEGIN("Renderer::present");
     GEngine->get_renderer()->present();
+    PROFILE_END();
 
-    // FIXME: Cap framerate for now
-    SDL_Delay(16); // ~60 FPS
+    PROFILE_BEGIN("FramePacer::wait");
+    GEngine->get_frame_pacer().wait();
+    PROFILE_END();
 }
 
 
 void Engine::run() {
 
 #if defined(SDL_PLATFORM_EMSCRIPTEN)
-    emscripten_set_main_loop(engine_core_loop, 60, 1);
+    // 0 -> requestAnimationFrame (browser vsync)
+    const int fps = _config.is_vsync() ? 0 : _config.get_application().max_fps;
+    emscripten_set_main_loop(engine_core_loop, fps, 1);
 #else
     while (is_running) {
         engine_core_loop();
@@ -296,18 +495,70 @@ void engine_setup_systems(flecs::world& world) {
 
 #pragma region 3D SYSTEMS
 
-    world.system<Model, Animation3D, Transform3D>("Animation_System_OnUpdate")
+    world.system<Model>("LoadModels_PreUpdate").kind(flecs::PreUpdate).with<tags::ActiveScene>().up().each(load_model_system);
+
+    world.system<const Model, Animation3D>("Animation_System_OnUpdate")
         .kind(flecs::OnUpdate)
+        .multi_threaded()
         .with<tags::ActiveScene>()
         .up()
         .each(animation_system);
 
+    world.system<const Transform3D, const Camera3D>("PrepareView3D_OnUpdate")
+        .kind(flecs::OnUpdate)
+        .with<tags::ActiveScene>()
+        .up()
+        .each(prepare_view_3d_system);
+
+    world.system<const Transform3D, const Model>("SubmitModels3D_OnUpdate")
+        .kind(flecs::OnUpdate)
+        .multi_threaded()
+        .with<tags::ActiveScene>()
+        .up()
+        .each(submit_models_system);
+
+    world.system<const Transform3D, const MeshInstance3D>("SubmitMeshes3D_OnUpdate")
+        .kind(flecs::OnUpdate)
+        .multi_threaded()
+        .with<tags::ActiveScene>()
+        .up()
+        .each(submit_meshes_system);
+
+    world.system<const Transform3D, ParticleEmitter3D>("UpdateParticles3D_OnUpdate")
+        .kind(flecs::OnUpdate)
+        .multi_threaded()
+        .with<tags::ActiveScene>()
+        .up()
+        .each(update_particles_3d_system);
+
     world.system<Camera3D>("Render_World_3D_OnUpdate").kind(flecs::OnUpdate).with<tags::ActiveScene>().up().each(render_world_3d_system);
 
 #pragma endregion
 
 
 #pragma region 2D SYSTEMS
+    // Roots have no dependency between each other, children are resolved parent first (cascade)
+    world.system<Transform2D, const Interpolation2D*>("UpdateRootTransforms2D_PreUpdate")
+        .kind(flecs::PreUpdate)
+        .multi_threaded()
+        .without<Transform2D>()
+        .up()
+        .each([](Transform2D& t, const Interpolation2D* previous) { update_transforms_system(t, previous, nullptr, 0); });
+
+    world.system<Transform2D, const Interpolation2D*, const Transform2D>("UpdateChildTransforms2D_PreUpdate")
+        .kind(flecs::PreUpdate)
+        .term_at(2)
+        .cascade()
+        .each([](flecs::iter& it, size_t, Transform2D& t, const Interpolation2D* previous, const Transform2D& parent) {
+            update_transforms_system(t, previous, &parent, it.src(2));
+        });
+
+    // Emitters only touch their own pool, drawn by the render list below
+    world.system<const Transform2D, ParticleEmitter2D>("UpdateParticles2D_OnUpdate")
+        .kind(flecs::OnUpdate)
+        .multi_threaded()
+        .each(update_particles_2d_system);
+
     world.system<Camera2D>("Render_World_2D_OnUpdate").kind(flecs::OnUpdate).each(render_world_2d_system);
 
 #pragma endregion
@@ -324,4 +575,23 @@ void engine_setup_systems(flecs::world& world) {
     });
 
     world.system<Script>("ProcessScripts_OnUpdate").kind(flecs::OnUpdate).with<tags::ActiveScene>().up().each(process_scripts_system);
+
+#pragma region FIXED UPDATE SYSTEMS
+    // Declaration order is execution order: capture the previous state before anything moves
+
+    world.system<const Transform2D, Interpolation2D>("StorePreviousTransform2D_FixedUpdate")
+        .kind<phases::FixedUpdate>()
+        .each(store_previous_transform_2d_system);
+
+    world.system<const Transform3D, Interpolation3D>("StorePreviousTransform3D_FixedUpdate")
+        .kind<phases::FixedUpdate>()
+        .each(store_previous_transform_3d_system);
+
+    world.system<Script>("ProcessPhysicsScripts_FixedUpdate")
+        .kind<phases::FixedUpdate>()
+        .with<tags::ActiveScene>()
+        .up()
+        .each(process_physics_scripts_system);
+
+#pragma endregion
 }
@@ -129,6 +129,12 @@ bool Application::load(const tinyxml2::XMLElement* root) {
         LOG_WARN("Failed to load Application Config - max_fps element is null");
     }
 
+    if (const auto background_fps_element = app_element->FirstChildElement("background_fps")) {
+        background_fps_element->QueryIntText(&background_fps);
+    } else {
+        LOG_WARN("Failed to load Application Config - background_fps element is null");
+    }
+
     if (const auto fullscreen_element = app_element->FirstChildElement("fullscreen")) {
         fullscreen_element->QueryBoolText(&is_fullscreen);
     } else {
@@ -185,6 +191,13 @@ bool Performance::load(const tinyxml2::XMLElement* root) {
         return false;
     }
 
+    if (const auto profiler_element = performance_element->FirstChildElement("profiler")) {
+        profiler_element->QueryBoolText(&is_profiling);
+        profiler_element->QueryBoolAttribute("gpu_batches", &is_profiling_gpu_batches);
+    } else {
+        LOG_WARN("Performance Config - profiler element is null, using %s", is_profiling ? "true" : "false");
+    }
+
     return true;
 }
 
@@ -205,6 +218,8 @@ bool RendererDevice::load(const tinyxml2::XMLElement* root) {
             backend = Backend::DIRECTX12;
         } else if (strcmp(method_str, "auto") == 0) {
             backend = Backend::AUTO;
+        } else if (strcmp(method_str, "null") == 0) {
+            backend = Backend::NONE;
         } else {
             LOG_ERROR("Unknown renderer method: %s", method_str);
             return false;
@@ -244,6 +259,8 @@ const char* RendererDevice::get_backend_str() const {
         return "DirectX 12";
     case Backend::AUTO:
         return "Auto (SDL_RENDERER_GPU)";
+    case Backend::NONE:
+        return "Null (Headless)";
     default:
         return "Unknown";
     }
@@ -255,6 +272,136 @@ bool Window::load(const tinyxml2::XMLElement* root) {
     return true;
 }
 
+bool InputMap::load(const tinyxml2::XMLElement* root) {
+    const auto input_element = root->FirstChildElement("input");
+
+    if (!input_element) {
+        LOG_WARN("Input Config - input element is null, no actions defined");
+        return true;
+    }
+
+    for (auto action_element = input_element->FirstChildElement("action"); action_element;
+         action_element      = action_element->NextSiblingElement("action")) {
+
+        const char* name = action_element->Attribute("name");
+        if (!name) {
+            LOG_ERROR("Failed to load Input Config - action without name");
+            return false;
+        }
+
+        InputActionDesc desc = {name, {}};
+
+        for (auto key_element = action_element->FirstChildElement("key"); key_element; key_element = key_element->NextSiblingElement("key")) {
+            const char* key_str         = key_element->GetText();
+            const SDL_Scancode scancode = key_str ? SDL_GetScancodeFromName(key_str) : SDL_SCANCODE_UNKNOWN;
+
+            if (scancode == SDL_SCANCODE_UNKNOWN) {
+                LOG_ERROR("Unknown key %s in action %s", key_str ? key_str : "(null)", name);
+                continue;
+            }
+
+            desc.bindings.push_back({InputSource::KEY, scancode});
+        }
+
+        for (auto mouse_element = action_element->FirstChildElement("mouse"); mouse_element;
+             mouse_element      = mouse_element->NextSiblingElement("mouse")) {
+            const char* button_str = mouse_element->GetText();
+            int button             = 0;
+
+            if (!button_str) {
+                button = 0;
+            } else if (strcmp(button_str, "left") == 0) {
+                button = SDL_BUTTON_LEFT;
+            } else if (strcmp(button_str, "middle") == 0) {
+                button = SDL_BUTTON_MIDDLE;
+            } else if (strcmp(button_str, "right") == 0) {
+                button = SDL_BUTTON_RIGHT;
+            } else if (strcmp(button_str, "x1") == 0) {
+                button = SDL_BUTTON_X1;
+            } else if (strcmp(button_str, "x2") == 0) {
+                button = SDL_BUTTON_X2;
+            }
+
+            if (button == 0) {
+                LOG_ERROR("Unknown mouse button %s in action %s", button_str ? button_str : "(null)", name);
+                continue;
+            }
+
+            desc.bindings.push_back({InputSource::MOUSE_BUTTON, button});
+        }
+
+        actions.push_back(std::move(desc));
+    }
+
+    return true;
+}
+
+bool TextureAtlasConfig::load(const tinyxml2::XMLElement* root) {
+    const auto atlas_element = root->FirstChildElement("atlas");
+
+    if (!atlas_element) {
+        return true;
+    }
+
+    atlas_element->QueryIntAttribute("page_size", &page_size);
+    atlas_element->QueryIntAttribute("padding", &padding);
+    atlas_element->QueryIntAttribute("max_image_size", &max_image_size);
+
+    if (const auto manifest_element = atlas_element->FirstChildElement("manifest")) {
+        if (const char* manifest_str = manifest_element->GetText()) {
+            manifest = manifest_str;
+        }
+    }
+
+    for (auto image_element = atlas_element->FirstChildElement("image"); image_element; image_element = image_element->NextSiblingElement("image")) {
+        const char* name = image_element->Attribute("name");
+        const char* path = image_element->GetText();
+
+        if (!name || !path) {
+            LOG_ERROR("Failed to load Atlas Config - image without name or path");
+            return false;
+        }
+
+        images.push_back({name, path});
+    }
+
+    return true;
+}
+
+bool Shadows::load(const tinyxml2::XMLElement* root) {
+    const auto shadows_element = root->FirstChildElement("shadows");
+
+    if (!shadows_element) {
+        return true;
+    }
+
+    shadows_element->QueryIntAttribute("cascades", &cascade_count);
+    shadows_element->QueryIntAttribute("resolution", &resolution);
+    shadows_element->QueryIntAttribute("depth_bits", &depth_bits);
+    shadows_element->QueryFloatAttribute("distance", &distance);
+    shadows_element->QueryFloatAttribute("split_lambda", &split_lambda);
+    shadows_element->QueryBoolAttribute("cache_static", &is_caching_static);
+
+    if (cascade_count < 1 || cascade_count > MAX_SHADOW_CASCADES) {
+        LOG_WARN("Shadows Config - %d cascades is out of [1, %d], clamped", cascade_count, MAX_SHADOW_CASCADES);
+        cascade_count = SDL_clamp(cascade_count, 1, MAX_SHADOW_CASCADES);
+    }
+
+    if (depth_bits != 16 && depth_bits != 24) {
+        LOG_ERROR("Failed to load Shadows Config - depth_bits must be 16 or 24, got %d", depth_bits);
+        return false;
+    }
+
+    if (resolution <= 0 || distance <= 0.0f) {
+        LOG_ERROR("Failed to load Shadows Config - resolution and distance must be positive");
+        return false;
+    }
+
+    split_lambda = SDL_clamp(split_lambda, 0.0f, 1.0f);
+
+    return true;
+}
+
 bool EngineConfig::load() {
 
 
@@ -273,7 +420,15 @@ bool EngineConfig::load() {
     }
 
     if (const auto vsync_element = config->FirstChildElement("vsync")) {
-        vsync_element->QueryBoolText(&_is_vsync_enabled);
+        if (const char* vsync_str = vsync_element->GetText()) {
+            if (strcmp(vsync_str, "adaptive") == 0) {
+                _vsync_mode = VSyncMode::ADAPTIVE;
+            } else {
+                bool is_enabled = true;
+                vsync_element->QueryBoolText(&is_enabled);
+                _vsync_mode = is_enabled ? VSyncMode::ENABLED : VSyncMode::DISABLED;
+            }
+        }
     }
 
     if (const auto orientation_element = config->FirstChildElement("orientation")) {
@@ -318,6 +473,21 @@ bool EngineConfig::load() {
         return false;
     }
 
+    if (!_input_map.load(config)) {
+        LOG_ERROR("Failed to load Input Config");
+        return false;
+    }
+
+    if (!_texture_atlas.load(config)) {
+        LOG_ERROR("Failed to load Atlas Config");
+        return false;
+    }
+
+    if (!_shadows.load(config)) {
+        LOG_ERROR("Failed to load Shadows Config");
+        return false;
+    }
+
     return true;
 }
 
@@ -346,10 +516,30 @@ Window& EngineConfig::get_window(){
     return _window;
 }
 
+InputMap& EngineConfig::get_input_map() {
+    return _input_map;
+}
+
+TextureAtlasConfig& EngineConfig::get_texture_atlas() {
+    return _texture_atlas;
+}
+
+Shadows& EngineConfig::get_shadows() {
+    return _shadows;
+}
+
 bool EngineConfig::is_vsync() const {
-    return _is_vsync_enabled;
+    return _vsync_mode != VSyncMode::DISABLED;
 }
 
 void EngineConfig::set_vsync(bool enabled) {
-    _is_vsync_enabled = enabled;
+    _vsync_mode = enabled ? VSyncMode::ENABLED : VSyncMode::DISABLED;
+}
+
+VSyncMode EngineConfig::get_vsync_mode() const {
+    return _vsync_mode;
+}
+
+void EngineConfig::set_vsync_mode(VSyncMode mode) {
+    _vsync_mode = mode;
 }
\ No newline at end of file
@@ -120,10 +120,13 @@ void parse_meshes(aiMesh* ai_mesh, const aiScene* scene, const std::string& base
     verts.reserve(ai_mesh->mNumVertices);
     indices.reserve(ai_mesh->mNumFaces * 3);
 
+    mesh_ref.bounds = {};
+
     for (unsigned int i = 0; i < ai_mesh->mNumVertices; i++) {
         const aiVector3D& v = ai_mesh->mVertices[i];
         Vertex vert;
         vert.position = glm::vec3(v.x, v.y, v.z);
+        mesh_ref.bounds.expand(vert.position);
 
         if (ai_mesh->HasNormals()) {
             vert.normal = glm::vec3(ai_mesh->mNormals[i].x, ai_mesh->mNormals[i].y, ai_mesh->mNormals[i].z);
@@ -207,6 +210,9 @@ void parse_bones(aiMesh* ai_mesh, std::vector<glm::ivec4>& bone_ids, std::vector
                     continue;
                 }
 
+                // Every influence counts for the bounds, even past the 4 kept for skinning
+                mesh_ref.bones[bone_index].bounds.expand(mesh_ref.vertices[vertex_id].position);
+
                 int slot = bone_counts[vertex_id];
                 if (slot < 4) {
                     bone_ids[vertex_id][slot]     = bone_index;
@@ -219,6 +225,14 @@ void parse_bones(aiMesh* ai_mesh, std::vector<glm::ivec4>& bone_ids, std::vector
         }
 
 
+        mesh_ref.unskinned_bounds = {};
+
+        for (unsigned int i = 0; i < ai_mesh->mNumVertices; i++) {
+            if (bone_counts[i] == 0) {
+                mesh_ref.unskinned_bounds.expand(mesh_ref.vertices[i].position);
+            }
+        }
+
         LOG_DEBUG("Mesh '%s': Vertices: %u | Indices: %u | Bones: %zu | Has Texture: %s", mesh_ref.name.data(), mesh_ref.vertex_count,
                   mesh_ref.index_count, mesh_ref.bones.size(), mesh_ref.material->is_valid() ? "Yes" : "No");
     } else {
@@ -0,0 +1,161 @@
+#include "core/renderer/bounds.h"
+
+#include "core/ember_utils.h"
+
+
+BoundingBox BoundingBox::transformed(const glm::mat4& matrix) const {
+    if (!is_valid()) {
+        return *this;
+    }
+
+    // Arvo: the extents go through the absolute value of the linear part
+    const glm::vec3 center  = glm::vec3(matrix * glm::vec4(get_center(), 1.0f));
+    const glm::vec3 extents = get_extents();
+
+    glm::vec3 world_extents(0.0f);
+
+    for (int column = 0; column < 3; column++) {
+        world_extents += glm::abs(glm::vec3(matrix[column])) * extents[column];
+    }
+
+    return {center - world_extents, center + world_extents};
+}
+
+
+void Frustum::set_matrix(const glm::mat4& view_projection) {
+    const glm::mat4& m = view_projection;
+
+    const glm::vec4 row_x = {m[0][0], m[1][0], m[2][0], m[3][0]};
+    const glm::vec4 row_y = {m[0][1], m[1][1], m[2][1], m[3][1]};
+    const glm::vec4 row_z = {m[0][2], m[1][2], m[2][2], m[3][2]};
+    const glm::vec4 row_w = {m[0][3], m[1][3], m[2][3], m[3][3]};
+
+    // Gribb-Hartmann: left, right, bottom, top, near, far
+    const glm::vec4 planes[6] = {row_w + row_x, row_w - row_x, row_w + row_y, row_w - row_y, row_w + row_z, row_w - row_z};
+
+    for (int i = 0; i < 6; i++) {
+        // Normalized, so the sphere tests compare true distances
+        const float length = glm::length(glm::vec3(planes[i]));
+        const float scale  = length > 0.0f ? 1.0f / length : 0.0f;
+
+        _nx[i] = planes[i].x * scale;
+        _ny[i] = planes[i].y * scale;
+        _nz[i] = planes[i].z * scale;
+        _d[i]  = length > 0.0f ? planes[i].w * scale : 1.0f;
+    }
+}
+
+bool Frustum::is_sphere_visible(const glm::vec3& center, float radius) const {
+#ifdef EMBER_HAS_SSE2
+    const __m128 cx         = _mm_set1_ps(center.x);
+    const __m128 cy         = _mm_set1_ps(center.y);
+    const __m128 cz         = _mm_set1_ps(center.z);
+    const __m128 neg_radius = _mm_set1_ps(-radius);
+
+    for (int i = 0; i < 8; i += 4) {
+        __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_load_ps(_nx + i), cx), _mm_load_ps(_d + i));
+        distance        = _mm_add_ps(distance, _mm_mul_ps(_mm_load_ps(_ny + i), cy));
+        distance        = _mm_add_ps(distance, _mm_mul_ps(_mm_load_ps(_nz + i), cz));
+
+        if (_mm_movemask_ps(_mm_cmplt_ps(distance, neg_radius)) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+#else
+    for (int i = 0; i < 6; i++) {
+        if (_nx[i] * center.x + _ny[i] * center.y + _nz[i] * center.z + _d[i] < -radius) {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+bool Frustum::is_box_visible(const glm::vec3& min, const glm::vec3& max) const {
+    const glm::vec3 center  = (min + max) * 0.5f;
+    const glm::vec3 extents = (max - min) * 0.5f;
+
+#ifdef EMBER_HAS_SSE2
+    const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 cz = _mm_set1_ps(center.z);
+    const __m128 ex = _mm_set1_ps(extents.x);
+    const __m128 ey = _mm_set1_ps(extents.y);
+    const __m128 ez = _mm_set1_ps(extents.z);
+
+    for (int i = 0; i < 8; i += 4) {
+        const __m128 nx = _mm_load_ps(_nx + i);
+        const __m128 ny = _mm_load_ps(_ny + i);
+        const __m128 nz = _mm_load_ps(_nz + i);
+
+        __m128 distance = _mm_add_ps(_mm_mul_ps(nx, cx), _mm_load_ps(_d + i));
+        distance        = _mm_add_ps(distance, _mm_mul_ps(ny, cy));
+        distance        = _mm_add_ps(distance, _mm_mul_ps(nz, cz));
+
+        // Half size of the box along the plane normal
+        __m128 reach = _mm_mul_ps(_mm_and_ps(nx, sign_mask), ex);
+        reach        = _mm_add_ps(reach, _mm_mul_ps(_mm_and_ps(ny, sign_mask), ey));
+        reach        = _mm_add_ps(reach, _mm_mul_ps(_mm_and_ps(nz, sign_mask), ez));
+
+        if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, reach), _mm_setzero_ps())) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+#else
+    for (int i = 0; i < 6; i++) {
+        const float distance = _nx[i] * center.x + _ny[i] * center.y + _nz[i] * center.z + _d[i];
+        const float reach    = SDL_fabsf(_nx[i]) * extents.x + SDL_fabsf(_ny[i]) * extents.y + SDL_fabsf(_nz[i]) * extents.z;
+
+        if (distance + reach < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+void Frustum::cull_spheres(const float* x, const float* y, const float* z, const float* radius, size_t count, Uint8 pass,
+                           Uint8* passes) const {
+    size_t i = 0;
+
+#ifdef EMBER_HAS_SSE2
+    for (; i + 4 <= count; i += 4) {
+        const __m128 sx         = _mm_loadu_ps(x + i);
+        const __m128 sy         = _mm_loadu_ps(y + i);
+        const __m128 sz         = _mm_loadu_ps(z + i);
+        const __m128 neg_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (int p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(_nx[p]), sx), _mm_set1_ps(_d[p]));
+            distance        = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(_ny[p]), sy));
+            distance        = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(_nz[p]), sz));
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, neg_radius));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+                passes[i + lane] |= pass;
+            }
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (is_sphere_visible({x[i], y[i], z[i]}, radius[i])) {
+            passes[i] |= pass;
+        }
+    }
+}
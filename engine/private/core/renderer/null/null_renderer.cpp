@@ -0,0 +1,429 @@
+#include "core/renderer/null/null_renderer.h"
+
+#include "core/engine.h"
+#include "core/renderer/shape_tessellation.h"
+
+#include <bit>
+
+// Layout the batched 2D backends stream per vertex: position, uv, color
+constexpr Uint64 NULL_VERTEX_2D_SIZE = sizeof(glm::vec2) + sizeof(glm::vec2) + sizeof(glm::vec4);
+
+// Per instance attributes of the 3D batches: model matrix, color, bone palette offset
+constexpr Uint64 NULL_INSTANCE_3D_SIZE = sizeof(glm::mat4) + sizeof(glm::vec3) + sizeof(Sint32);
+
+// Per particle attributes of the billboard pass: position, size, RGBA8 color
+constexpr Uint64 NULL_PARTICLE_INSTANCE_SIZE = sizeof(glm::vec3) + sizeof(float) + sizeof(Uint32);
+
+
+
+NullRenderStats& NullRenderStats::operator+=(const NullRenderStats& other) {
+    draw_calls += other.draw_calls;
+    instances += other.instances;
+    batches += other.batches;
+    flushes += other.flushes;
+    vertices += other.vertices;
+    submitted_bytes += other.submitted_bytes;
+    shadow_instances += other.shadow_instances;
+    static_shadow_redraws += other.static_shadow_redraws;
+    textures_loaded += other.textures_loaded;
+    meshes_loaded += other.meshes_loaded;
+    fonts_loaded += other.fonts_loaded;
+    uploaded_bytes += other.uploaded_bytes;
+    return *this;
+}
+
+
+bool NullRenderer::initialize(SDL_Window* window) {
+
+    // A window is optional, the null renderer never presents anything
+    _window = window;
+
+    _cube_mesh.name         = "NULL_CUBE_MESH";
+    _cube_mesh.vertex_count = 24;
+    _cube_mesh.index_count  = 36;
+    _cube_mesh.bounds       = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+
+    LOG_INFO("Using backend: Null (headless), Window: %s", _window ? "Hidden" : "None");
+
+    return true;
+}
+
+void NullRenderer::clear(glm::vec4 color) {
+    _frame = {};
+
+    // Batches submitted without an active camera were never flushed
+    clear_stages();
+}
+
+void NullRenderer::present() {
+    _last_frame = _frame;
+}
+
+bool NullRenderer::set_vsync(VSyncMode mode) {
+    return true;
+}
+
+void NullRenderer::record(const NullRenderStats& stats) {
+    _frame += stats;
+    _total += stats;
+}
+
+void NullRenderer::record_vertices_2d(Uint64 count) {
+    record({.draw_calls = 1, .vertices = count, .submitted_bytes = count * NULL_VERTEX_2D_SIZE});
+}
+
+const NullRenderStats& NullRenderer::get_frame_stats() const {
+    return _last_frame;
+}
+
+const NullRenderStats& NullRenderer::get_total_stats() const {
+    return _total;
+}
+
+void NullRenderer::reset_stats() {
+    _frame      = {};
+    _last_frame = {};
+    _total      = {};
+}
+
+
+bool NullRenderer::load_font(const std::string& name, const std::string& path, int size) {
+
+    // Glyphs are never rasterized, only the alias is kept
+    _fonts[name] = std::make_shared<Font>(nullptr);
+
+    record({.fonts_loaded = 1});
+    return true;
+}
+
+std::shared_ptr<Texture> NullRenderer::load_texture(const std::string& name, const std::string& path, const aiTexture* ai_embedded_tex) {
+
+    if (_textures.contains(name)) {
+        return _textures[name];
+    }
+
+    // Decoding is CPU work and is kept, only the upload is skipped
+    auto texture = Renderer::load_texture(name, path, ai_embedded_tex);
+
+    if (!texture || !texture->pixels) {
+        LOG_ERROR("Failed to load texture surface: %s", name.c_str());
+        return nullptr;
+    }
+
+    return upload_texture(name, texture);
+}
+
+std::shared_ptr<Texture> NullRenderer::upload_texture(const std::string& name, std::shared_ptr<Texture> texture) {
+    record({.textures_loaded = 1, .uploaded_bytes = static_cast<Uint64>(texture->pitch) * texture->height});
+
+    return Renderer::upload_texture(name, texture);
+}
+
+std::unique_ptr<Mesh> NullRenderer::load_mesh(aiMesh* mesh, const aiScene* scene, const std::string& base_dir) {
+    auto null_mesh = std::make_unique<NullMesh>();
+
+    parse_meshes(mesh, scene, base_dir, *null_mesh);
+
+    std::vector<glm::ivec4> bone_ids;
+    std::vector<glm::vec4> bone_weights;
+    parse_bones(mesh, bone_ids, bone_weights, *null_mesh);
+
+    const Uint64 bone_bytes = bone_ids.size() * sizeof(glm::ivec4) + bone_weights.size() * sizeof(glm::vec4);
+
+    record({.meshes_loaded = 1, .uploaded_bytes = null_mesh->get_size_bytes() + bone_bytes});
+
+    return null_mesh;
+}
+
+std::shared_ptr<Model> NullRenderer::load_model(const char* path) {
+
+    if (_models.contains(path)) {
+        return _models[path];
+    }
+
+    auto model = Renderer::load_model(path);
+
+    if (model) {
+        _models[path] = model;
+    }
+
+    return model;
+}
+
+
+#pragma region 2D
+void NullRenderer::draw_texture(const Transform2D& transform, Texture* texture, const glm::vec4& dest, const glm::vec4& source, bool flip_h,
+                                bool flip_v, const glm::vec4& color) {
+    if (!texture) {
+        return;
+    }
+
+    record_vertices_2d(4);
+}
+
+void NullRenderer::draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    std::string text = vformat(fmt, args);
+    va_end(args);
+
+    draw_text_internal(transform.world_position, color, font_name, text);
+}
+
+void NullRenderer::draw_text_3d(const Transform3D& transform, const glm::mat4& view, const glm::mat4& projection, const glm::vec4& color,
+                                const std::string& font_name, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    std::string text = vformat(fmt, args);
+    va_end(args);
+
+    draw_text_internal(glm::vec2(0.0f), color, font_name, text);
+}
+
+void NullRenderer::draw_rect(const Transform2D& transform, float w, float h, glm::vec4 color, bool is_filled) {
+    record_vertices_2d(is_filled ? 4 : 8);
+}
+
+void NullRenderer::draw_triangle(const Transform2D& transform, float size, glm::vec4 color, bool is_filled) {
+    record_vertices_2d(is_filled ? 3 : 6);
+}
+
+void NullRenderer::draw_line(const Transform2D& transform, glm::vec2 end, glm::vec4 color) {
+    record_vertices_2d(2);
+}
+
+void NullRenderer::draw_circle(const Transform2D& transform, float radius, glm::vec4 color, bool is_filled) {
+    const float screen_radius = radius * SDL_max(SDL_fabsf(transform.world_scale.x), SDL_fabsf(transform.world_scale.y));
+    const Uint64 segments     = get_circle_segments(screen_radius);
+
+    // Same tessellation as the SDL batch: a fan around the center, or a ring strip
+    record_vertices_2d(is_filled ? segments + 1 : segments * 2);
+}
+
+void NullRenderer::draw_polygon(const Transform2D& transform, const std::vector<glm::vec2>& points, glm::vec4 color, bool is_filled) {
+    if (points.size() < 2) {
+        return;
+    }
+
+    record_vertices_2d(is_filled ? (points.size() - 2) * 3 : points.size() * 2);
+}
+
+void NullRenderer::draw_polygon_triangles(const Transform2D& transform, const std::vector<glm::vec2>& points, const std::vector<int>& triangles,
+                                          glm::vec4 color) {
+    if (triangles.empty()) {
+        return;
+    }
+
+    // Indexed: each vertex is streamed once, whatever the number of triangles sharing it
+    record_vertices_2d(points.size());
+}
+
+void NullRenderer::draw_texture_quads(const Transform2D& transform, Texture* texture, const std::vector<glm::vec2>& positions,
+                                      const std::vector<glm::vec2>& uvs, const glm::vec4& color) {
+    if (!texture || positions.size() < 4) {
+        return;
+    }
+
+    record_vertices_2d(positions.size());
+}
+
+void NullRenderer::draw_particles_2d(const ParticlePool& pool, Texture* texture, const glm::vec4& uv, float size) {
+    if (pool.size() == 0) {
+        return;
+    }
+
+    record_vertices_2d(pool.size() * 4);
+}
+
+void NullRenderer::draw_particles_3d(const ParticlePool& pool, float size) {
+    if (pool.size() == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_batch_mutex);
+    record({.draw_calls = 1, .instances = pool.size(), .submitted_bytes = pool.size() * NULL_PARTICLE_INSTANCE_SIZE});
+}
+
+std::vector<Tokens> NullRenderer::parse_text(const std::string& text) {
+    std::vector<Tokens> segments;
+
+    for_each_text_run(text, [&](const TextRun& run) { segments.push_back({text.substr(run.offset, run.length), run.is_emoji}); });
+
+    return segments;
+}
+
+void NullRenderer::draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name, const std::string& text) {
+    Uint64 glyphs = 0;
+
+    // Same segmentation cost as a real backend, without building the runs
+    for_each_text_run(text, [&](const TextRun& run) {
+        const size_t end = run.offset + run.length;
+
+        for (size_t i = run.offset; i < end; glyphs++) {
+            utf8_decode(text.data(), end, i);
+        }
+    });
+
+    record_vertices_2d(glyphs * 4);
+}
+#pragma endregion
+
+
+#pragma region 3D
+void NullRenderer::draw_line_3d(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color) {
+    record({.draw_calls = 1, .submitted_bytes = 2 * sizeof(glm::vec3)});
+}
+
+void NullRenderer::draw_triangle_3d(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3, const glm::vec4& color,
+                                    bool is_filled) {
+    record({.draw_calls = 1, .submitted_bytes = 3 * sizeof(glm::vec3)});
+}
+
+void NullRenderer::draw_model(const Transform3D& t, const Model* model, bool is_static, int stage) {
+    RenderStage* render_stage = get_stage(stage);
+
+    if (!model || !render_stage) {
+        return;
+    }
+
+    const glm::mat4 matrix = t.get_model_matrix();
+
+    if (is_static) {
+        add_static_caster(*render_stage, model, matrix);
+    }
+
+    thread_local std::vector<Uint8> mesh_passes;
+    mesh_passes.resize(model->meshes.size());
+
+    if (cull_meshes(model, matrix, mesh_passes.data()) == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < model->meshes.size(); i++) {
+        if (!model->meshes[i] || mesh_passes[i] == 0) {
+            continue;
+        }
+
+        add_instance(*render_stage, model->meshes[i].get(), matrix, glm::vec3(1.0f), -1,
+                     is_static ? mesh_passes[i] | RENDER_PASS_STATIC : mesh_passes[i]);
+    }
+
+    render_stage->draw_calls++;
+}
+
+void NullRenderer::draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count,
+                                       int animation, int stage) {
+    RenderStage* render_stage = get_stage(stage);
+
+    if (!model || !render_stage) {
+        return;
+    }
+
+    const glm::mat4 matrix = t.get_model_matrix();
+
+    const bool has_clip_bounds = animation >= 0 && animation < static_cast<int>(model->animation_bounds.size());
+    const Uint8 passes         = get_visible_passes(has_clip_bounds ? model->animation_bounds[animation] : model->bounds, matrix);
+
+    if (passes == 0) {
+        return;
+    }
+
+    const Sint32 bone_offset = add_bone_palette(*render_stage, model, bone_transforms, bone_count);
+
+    for (auto& mesh : model->meshes) {
+        if (!mesh || !mesh->has_bones) {
+            continue;
+        }
+
+        add_instance(*render_stage, mesh.get(), matrix, glm::vec3(1.0f), bone_offset, passes);
+    }
+
+    render_stage->draw_calls++;
+}
+
+void NullRenderer::draw_mesh(const Transform3D& transform, const MeshInstance3D& mesh, const Shader* shader, bool is_static, int stage) {
+    RenderStage* render_stage = get_stage(stage);
+
+    if (!render_stage) {
+        return;
+    }
+
+    Transform3D temp = transform;
+    temp.scale       = mesh.size;
+
+    const glm::mat4 matrix = temp.get_model_matrix();
+    const Uint8 passes     = get_visible_passes(_cube_mesh.bounds, matrix);
+
+    if (is_static) {
+        add_static_caster(*render_stage, &_cube_mesh, matrix);
+    }
+
+    if (passes == 0) {
+        return;
+    }
+
+    add_instance(*render_stage, &_cube_mesh, matrix, mesh.material.albedo, -1, is_static ? passes | RENDER_PASS_STATIC : passes).command =
+        EDrawCommand::MESH;
+
+    render_stage->draw_calls++;
+}
+
+void NullRenderer::draw_environment(const glm::mat4& view, const glm::mat4& projection) {
+    // The skybox is not an instanced batch, the OpenGL backend does not count it either
+}
+
+void NullRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
+    NullRenderStats stats = {.flushes = 1};
+
+    // Counted by the workers in their own stage
+    for (const RenderStage& stage : _stages) {
+        stats.draw_calls += stage.draw_calls;
+    }
+
+    merge_stages();
+
+    Uint64 dynamic_casters = 0;
+    Uint64 static_casters  = 0;
+
+    for (auto& [_, batch] : _instanced_batches) {
+        if (batch.models.empty()) {
+            continue;
+        }
+
+        stats.batches++;
+        stats.instances += batch.models.size();
+        stats.submitted_bytes += batch.models.size() * NULL_INSTANCE_3D_SIZE;
+
+        for (size_t i = 0; i < batch.models.size(); i++) {
+            const Uint8 passes = i < batch.passes.size() ? batch.passes[i] : RENDER_PASS_ALL;
+
+            if (passes & RENDER_PASS_SHADOW) {
+                (passes & RENDER_PASS_STATIC ? static_casters : dynamic_casters)++;
+            }
+        }
+    }
+
+    // Same shadow pass as the OpenGL backend: static casters are only drawn into the cascades being redrawn
+    const Uint64 static_signature = _static_caster_signature;
+    const Uint64 cascade_count    = _shadow_cascades.count;
+
+    if (GEngine->get_config().get_shadows().is_caching_static) {
+        const Uint32 redraws = _static_shadows.update(_shadow_cascades, static_signature);
+
+        stats.static_shadow_redraws = std::popcount(redraws);
+        stats.shadow_instances      = dynamic_casters * cascade_count + static_casters * stats.static_shadow_redraws;
+    } else {
+        stats.shadow_instances = (dynamic_casters + static_casters) * cascade_count;
+    }
+
+    // One palette upload for every skinned instance of the frame
+    stats.submitted_bytes += _bone_palette.size() * sizeof(glm::vec4);
+
+    _instanced_batches.clear();
+    _bone_palette.clear();
+
+    record(stats);
+
+    draw_environment(view, projection);
+}
+#pragma endregion
@@ -0,0 +1,8 @@
+#include "core/renderer/null/null_struct.h"
+
+
+// MESH IMPLEMENTATION
+
+Uint64 NullMesh::get_size_bytes() const {
+    return vertices.size() * sizeof(Vertex) + indices.size() * sizeof(Uint32);
+}
@@ -0,0 +1,221 @@
+#include "core/renderer/opengl/ogl_batch_2d.h"
+
+
+namespace {
+
+    constexpr size_t INITIAL_VERTEX_BYTES = 4 * 1024 * 1024;
+    constexpr size_t INITIAL_INDEX_BYTES  = 2 * 1024 * 1024;
+
+    constexpr float UNTEXTURED = -1.0f;
+
+} // namespace
+
+
+bool OpenglBatch2D::initialize() {
+    _shader = new OpenglShader("shaders/opengl/sprite_2d.vert", "shaders/opengl/sprite_2d.frag");
+
+    glGenVertexArrays(1, &_vao);
+    glBindVertexArray(_vao);
+
+    _vertex_buffer.initialize(GL_ARRAY_BUFFER, INITIAL_VERTEX_BYTES);
+    _index_buffer.initialize(GL_ELEMENT_ARRAY_BUFFER, INITIAL_INDEX_BYTES);
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+
+    return _shader->is_valid();
+}
+
+void OpenglBatch2D::destroy() {
+    _vertex_buffer.destroy();
+    _index_buffer.destroy();
+
+    if (_vao != 0) {
+        glDeleteVertexArrays(1, &_vao);
+        _vao = 0;
+    }
+
+    delete _shader;
+    _shader = nullptr;
+}
+
+Uint32 OpenglBatch2D::pack_color(glm::vec4 color) {
+    const glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return static_cast<Uint32>(c.r) | static_cast<Uint32>(c.g) << 8 | static_cast<Uint32>(c.b) << 16 | static_cast<Uint32>(c.a) << 24;
+}
+
+float OpenglBatch2D::next_depth() {
+    const float depth = 1.0f - 2.0f * static_cast<float>(SDL_min(_layer + 1, MAX_LAYERS)) / static_cast<float>(MAX_LAYERS);
+    _layer++;
+    return depth;
+}
+
+void OpenglBatch2D::add_translucent(Uint32 texture, size_t index_count) {
+    // Untextured geometry fits in any command, only a texture change starts a new one
+    DrawCommand* last = _translucent_commands.empty() ? nullptr : &_translucent_commands.back();
+
+    if (!last || (texture != 0 && last->texture != 0 && last->texture != texture)) {
+        _translucent_commands.push_back({texture, _translucent.size(), 0});
+        last = &_translucent_commands.back();
+    }
+
+    if (last->texture == 0) {
+        last->texture = texture;
+    }
+
+    last->count += index_count;
+}
+
+void OpenglBatch2D::push(Uint32 texture, bool is_opaque, const glm::vec2* positions, const glm::vec2* uvs, size_t vertex_count,
+                         const int* indices, size_t index_count, glm::vec4 color) {
+    if (vertex_count == 0 || index_count == 0) {
+        return;
+    }
+
+    const float depth   = next_depth();
+    const Uint32 base   = static_cast<Uint32>(_vertices.size());
+    const Uint32 packed = pack_color(color);
+
+    for (size_t i = 0; i < vertex_count; i++) {
+        _vertices.push_back({{positions[i], depth}, uvs ? uvs[i] : glm::vec2(UNTEXTURED), packed});
+    }
+
+    std::vector<Uint32>& target = is_opaque ? _opaque[texture] : _translucent;
+
+    if (!is_opaque) {
+        add_translucent(texture, index_count);
+    }
+
+    for (size_t i = 0; i < index_count; i++) {
+        target.push_back(base + static_cast<Uint32>(indices[i]));
+    }
+}
+
+OpenglVertex2D* OpenglBatch2D::push_quads(Uint32 texture, size_t quad_count) {
+    if (quad_count == 0) {
+        return nullptr;
+    }
+
+    const float depth  = next_depth();
+    const size_t base  = _vertices.size();
+    const Uint32 first = static_cast<Uint32>(base);
+
+    _vertices.resize(base + quad_count * 4, {{0.0f, 0.0f, depth}, glm::vec2(UNTEXTURED), 0xFFFFFFFF});
+
+    add_translucent(texture, quad_count * 6);
+
+    for (Uint32 q = 0; q < quad_count; q++) {
+        const Uint32 v = first + q * 4;
+        _translucent.insert(_translucent.end(), {v, v + 1, v + 2, v, v + 2, v + 3});
+    }
+
+    return _vertices.data() + base;
+}
+
+void OpenglBatch2D::draw(const DrawCommand& command, size_t index_offset, Uint32& bound_texture) {
+    if (command.count == 0) {
+        return;
+    }
+
+    if (command.texture != 0 && command.texture != bound_texture) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, command.texture);
+        bound_texture = command.texture;
+    }
+
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                   reinterpret_cast<const void*>(index_offset + command.first * sizeof(Uint32)));
+    _draw_calls++;
+}
+
+void OpenglBatch2D::flush(const glm::mat4& view, const glm::mat4& projection) {
+    _draw_calls = 0;
+
+    if (_vertices.empty() || !_shader) {
+        return;
+    }
+
+    PROFILE_SCOPE("OpenglBatch2D::flush");
+
+    // One index upload: the opaque groups, then the translucent draws
+    _upload_indices.clear();
+    _opaque_commands.clear();
+
+    for (auto& [texture, indices] : _opaque) {
+        if (indices.empty()) {
+            continue;
+        }
+
+        _opaque_commands.push_back({texture, _upload_indices.size(), indices.size()});
+        _upload_indices.insert(_upload_indices.end(), indices.begin(), indices.end());
+        indices.clear();
+    }
+
+    const size_t translucent_first = _upload_indices.size();
+    _upload_indices.insert(_upload_indices.end(), _translucent.begin(), _translucent.end());
+
+    glBindVertexArray(_vao);
+
+    const size_t vertex_offset = _vertex_buffer.write(_vertices.data(), _vertices.size() * sizeof(OpenglVertex2D));
+
+    // The ring offset moves every frame, the attribute pointers follow it
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(OpenglVertex2D),
+                          reinterpret_cast<const void*>(vertex_offset + offsetof(OpenglVertex2D, position)));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(OpenglVertex2D), reinterpret_cast<const void*>(vertex_offset + offsetof(OpenglVertex2D, uv)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OpenglVertex2D),
+                          reinterpret_cast<const void*>(vertex_offset + offsetof(OpenglVertex2D, color)));
+
+    const size_t index_offset = _index_buffer.write(_upload_indices.data(), _upload_indices.size() * sizeof(Uint32));
+
+    _shader->activate();
+    _shader->set_value("VIEW", view);
+    _shader->set_value("PROJECTION", projection);
+    _shader->set_value("TEXTURE", 0);
+
+    // 2D is layered over the 3D pass, its depth only orders the 2D draws
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    Uint32 bound_texture = 0;
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    _shader->set_value("ALPHA_CUTOFF", 0.5f);
+
+    for (const DrawCommand& command : _opaque_commands) {
+        draw(command, index_offset, bound_texture);
+    }
+
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    _shader->set_value("ALPHA_CUTOFF", 0.0f);
+
+    for (DrawCommand command : _translucent_commands) {
+        command.first += translucent_first;
+        draw(command, index_offset, bound_texture);
+    }
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glBindVertexArray(0);
+
+    _vertices.clear();
+    _translucent.clear();
+    _translucent_commands.clear();
+    _layer = 0;
+}
+
+bool OpenglBatch2D::is_empty() const {
+    return _vertices.empty();
+}
+
+int OpenglBatch2D::get_draw_call_count() const {
+    return _draw_calls;
+}
@@ -0,0 +1,113 @@
+#include "core/renderer/opengl/ogl_particles.h"
+
+#include "core/renderer/opengl/ogl_batch_2d.h"
+
+
+namespace {
+
+    constexpr size_t INITIAL_INSTANCE_BYTES = 2 * 1024 * 1024;
+
+} // namespace
+
+
+bool OpenglParticles::initialize() {
+    _shader = new OpenglShader("shaders/opengl/particle_3d.vert", "shaders/opengl/particle_3d.frag");
+
+    glGenVertexArrays(1, &_vao);
+    glBindVertexArray(_vao);
+
+    _instance_buffer.initialize(GL_ARRAY_BUFFER, INITIAL_INSTANCE_BYTES);
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(0, 1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+
+    return _shader->is_valid();
+}
+
+void OpenglParticles::destroy() {
+    _instance_buffer.destroy();
+
+    if (_vao != 0) {
+        glDeleteVertexArrays(1, &_vao);
+        _vao = 0;
+    }
+
+    delete _shader;
+    _shader = nullptr;
+}
+
+void OpenglParticles::push(const ParticlePool& pool, float size) {
+    const size_t count = pool.size();
+
+    if (count == 0) {
+        return;
+    }
+
+    const float* x = pool.get_stream(ParticlePool::POSITION_X);
+    const float* y = pool.get_stream(ParticlePool::POSITION_Y);
+    const float* z = pool.get_stream(ParticlePool::POSITION_Z);
+    const float* r = pool.get_stream(ParticlePool::COLOR_R);
+    const float* g = pool.get_stream(ParticlePool::COLOR_G);
+    const float* b = pool.get_stream(ParticlePool::COLOR_B);
+    const float* a = pool.get_stream(ParticlePool::COLOR_A);
+
+    const size_t base = _instances.size();
+    _instances.resize(base + count);
+
+    OpenglParticleInstance* instances = _instances.data() + base;
+
+    for (size_t i = 0; i < count; i++) {
+        instances[i] = {{x[i], y[i], z[i]}, size, OpenglBatch2D::pack_color({r[i], g[i], b[i], a[i]})};
+    }
+}
+
+void OpenglParticles::flush(const glm::mat4& view, const glm::mat4& projection) {
+    _drawn = 0;
+
+    if (_instances.empty() || !_shader || !_shader->is_valid()) {
+        _instances.clear();
+        return;
+    }
+
+    PROFILE_SCOPE("OpenglParticles::flush");
+
+    glBindVertexArray(_vao);
+
+    const size_t offset = _instance_buffer.write(_instances.data(), _instances.size() * sizeof(OpenglParticleInstance));
+
+    // Position and size are adjacent, one vec4
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(OpenglParticleInstance),
+                          reinterpret_cast<const void*>(offset + offsetof(OpenglParticleInstance, position)));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OpenglParticleInstance),
+                          reinterpret_cast<const void*>(offset + offsetof(OpenglParticleInstance, color)));
+
+    _shader->activate();
+    _shader->set_value("VIEW", view);
+    _shader->set_value("PROJECTION", projection);
+
+    // Blended over the scene, hidden by it, never hiding each other
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(_instances.size()));
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glBindVertexArray(0);
+
+    _drawn = _instances.size();
+    _instances.clear();
+}
+
+size_t OpenglParticles::get_instance_count() const {
+    return _drawn;
+}
@@ -3,6 +3,16 @@
 #include "core/engine.h"
 #include "core/io/file_system.h"
 #include "core/renderer/base_struct.h"
+#include "core/renderer/shape_tessellation.h"
+
+// Instance data of a frame before the arena grows, 13k instances
+constexpr size_t INITIAL_INSTANCE_BYTES = 1024 * 1024;
+
+// Texels per row of the bone palette, 341 bones; ES 3.0 has no texture buffers
+constexpr int BONE_PALETTE_WIDTH = 1024;
+
+// Texture unit of the bone palette, after the shadow map
+constexpr int BONE_PALETTE_UNIT = 3;
 
 void GLAPIENTRY ogl_validation_layer(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message,
                                      const void* userParam) {
@@ -66,6 +76,7 @@ std::shared_ptr<OpenglMesh> generate_cube_mesh() {
 
     mesh->vertex_count = 24;
     mesh->index_count  = 36;
+    mesh->bounds       = {glm::vec3(-0.5f), glm::vec3(0.5f)};
 
 
     glGenVertexArrays(1, &mesh->vao);
@@ -327,7 +338,38 @@ void OpenglRenderer::setup_cubemap() {
 // TODO: refactor this when make the Framebuffer class
 Uint32 shadowFBO   = 0;
 Uint32 shadowTexID = 0;
-Uint32 shadowWidth = 8192, shadowHeight = 8192;
+int shadowResolution   = 2048; /// Size of each cascade, see `Shadows`
+int shadowCascadeCount = 1;
+
+// Static casters only, copied into shadowTexID every frame; 0 when `Shadows::is_caching_static` is off
+Uint32 staticShadowFBO   = 0;
+Uint32 staticShadowTexID = 0;
+
+namespace {
+    /// Depth array of the cascades bound to `fbo`, compared in hardware (linear filtered depth needs compare mode on GLES)
+    Uint32 create_shadow_map(Uint32 fbo, bool is_depth_16) {
+        Uint32 texture = 0;
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, is_depth_16 ? GL_DEPTH_COMPONENT16 : GL_DEPTH_COMPONENT24, shadowResolution, shadowResolution,
+                     shadowCascadeCount, 0, GL_DEPTH_COMPONENT, is_depth_16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+
+        glDrawBuffers(0, nullptr);
+        glReadBuffer(GL_NONE);
+
+        return texture;
+    }
+} // namespace
 
 
 bool OpenglRenderer::initialize(SDL_Window* window) {
@@ -380,7 +422,7 @@ bool OpenglRenderer::initialize(SDL_Window* window) {
     _window  = window;
 
 
-    SDL_GL_SetSwapInterval(0);
+    set_vsync(GEngine->get_config().get_vsync_mode());
 
     GLint num_extensions = 0;
     std::vector<std::string> extensions;
@@ -439,24 +481,13 @@ bool OpenglRenderer::initialize(SDL_Window* window) {
     // glViewport(0, 0, viewport.width, viewport.height);
     glGenFramebuffers(1, &shadowFBO);
 
-    glGenTextures(1, &shadowTexID);
-    glBindTexture(GL_TEXTURE_2D, shadowTexID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowWidth, shadowHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-
-    float borderColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    const Shadows& shadows = GEngine->get_config().get_shadows();
+    shadowResolution       = shadows.resolution;
+    shadowCascadeCount     = SDL_clamp(shadows.cascade_count, 1, MAX_SHADOW_CASCADES);
 
-    LOG_INFO("Shadow Map: %dx%d with GL_LINEAR", shadowWidth, shadowHeight);
+    const bool is_depth_16 = shadows.depth_bits == 16;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowTexID, 0);
-
-    glDrawBuffers(0, nullptr);
-    glReadBuffer(GL_NONE);
+    shadowTexID = create_shadow_map(shadowFBO, is_depth_16);
 
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         LOG_ERROR("Shadow Framebuffer not complete!");
@@ -464,18 +495,58 @@ bool OpenglRenderer::initialize(SDL_Window* window) {
         LOG_INFO("Shadow Framebuffer completed");
     }
 
+    if (shadows.is_caching_static) {
+        glGenFramebuffers(1, &staticShadowFBO);
+        staticShadowTexID = create_shadow_map(staticShadowFBO, is_depth_16);
+
+        // Static casters are then drawn every frame with the dynamic ones
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            LOG_ERROR("Static Shadow Framebuffer not complete, static shadows are not cached");
+            glDeleteTextures(1, &staticShadowTexID);
+            glDeleteFramebuffers(1, &staticShadowFBO);
+            staticShadowTexID = 0;
+            staticShadowFBO   = 0;
+        }
+    }
+
+    // 24-bit depth is stored in 32 bits by most drivers
+    const int shadow_maps        = staticShadowFBO ? 2 : 1;
+    const float texel_bytes      = is_depth_16 ? 2.0f : 4.0f;
+    const float shadow_megabytes = static_cast<float>(shadowResolution) * shadowResolution * shadowCascadeCount * texel_bytes / (1024.0f * 1024.0f);
+
+    LOG_INFO("Shadow Map: %d cascades of %dx%d, %d-bit depth, static cache %s (%.1f MB)", shadowCascadeCount, shadowResolution,
+             shadowResolution, shadows.depth_bits, staticShadowFBO ? "ON" : "OFF", shadow_megabytes * shadow_maps);
+
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+    _gpu_timer.initialize();
+
+    if (!_batch_2d.initialize()) {
+        LOG_ERROR("Failed to create the 2D batch shader");
+    }
+
+    if (!_particles_3d.initialize()) {
+        LOG_ERROR("Failed to create the particle shader");
+    }
+
+    _instance_arena.initialize(INITIAL_INSTANCE_BYTES);
 
     return true;
 }
 
 void OpenglRenderer::clear(glm::vec4 color) {
+    _gpu_timer.begin_frame();
 
     // NOTE: Nuklear disables depth test, so we need to re-enable it each frame
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
 
+    // Batches submitted without an active camera were never flushed
+    clear_stages();
+
+    _clear_color      = color;
+    _is_frame_cleared = false;
+
     // TODO: handle viewport/window changes
     // const auto& window = GEngine->get_config().get_window();
     // glViewport(0, 0, window.width, window.height);
@@ -484,16 +555,75 @@ void OpenglRenderer::clear(glm::vec4 color) {
 }
 
 void OpenglRenderer::present() {
+    const auto& window = GEngine->get_config().get_window();
+
+    // Without a 3D camera nothing cleared the frame
+    if (!_is_frame_cleared) {
+        glViewport(0, 0, window.width, window.height);
+        glClearColor(_clear_color.r, _clear_color.g, _clear_color.b, _clear_color.a);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    if (!_batch_2d.is_empty()) {
+        PROFILE_SCOPE("OpenglRenderer::pass_2d");
+        _gpu_timer.begin_zone("OpenglRenderer::pass_2d");
+
+        const auto& viewport       = GEngine->get_config().get_viewport();
+        const glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(viewport.width), static_cast<float>(viewport.height), 0.0f, -1.0f, 1.0f);
+
+        glViewport(0, 0, window.width, window.height);
+        _batch_2d.flush(_view_2d, projection);
+
+        _gpu_timer.end_zone();
+    }
+
+    advance_text_frame();
 
     SDL_GL_SwapWindow(_window);
 }
 
+bool OpenglRenderer::set_vsync(VSyncMode mode) {
+
+    if (mode == VSyncMode::ADAPTIVE) {
+        if (SDL_GL_SetSwapInterval(-1)) {
+            LOG_INFO("VSync: Adaptive");
+            return true;
+        }
+
+        LOG_WARN("Adaptive VSync not supported, falling back to VSync, %s", SDL_GetError());
+        mode = VSyncMode::ENABLED;
+    }
+
+    const int interval = mode == VSyncMode::ENABLED ? 1 : 0;
+
+    if (!SDL_GL_SetSwapInterval(interval)) {
+        LOG_ERROR("Failed to set swap interval %d, %s", interval, SDL_GetError());
+        return false;
+    }
+
+    LOG_INFO("VSync: %s", interval ? "Enabled" : "Disabled");
+    return true;
+}
+
 
 bool OpenglRenderer::load_font(const std::string& name, const std::string& path, int size) {
+
+    if (_fonts.find(name) != _fonts.end()) {
+        return true;
+    }
+
+    TTF_Font* f = TTF_OpenFont(path.c_str(), size);
+    if (!f) {
+        LOG_ERROR("Failed to load Font %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    _fonts[name] = std::make_unique<Font>(f);
     return true;
 }
 
 std::shared_ptr<Texture> OpenglRenderer::load_texture(const std::string& name, const std::string& path, const aiTexture* ai_embedded_tex) {
+    PROFILE_SCOPE("OpenglRenderer::load_texture");
 
 
     if (_textures.contains(name)) {
@@ -507,7 +637,10 @@ std::shared_ptr<Texture> OpenglRenderer::load_texture(const std::string& name, c
         return nullptr;
     }
 
+    return upload_texture(name, texture);
+}
 
+std::shared_ptr<Texture> OpenglRenderer::upload_texture(const std::string& name, std::shared_ptr<Texture> texture) {
     texture->target = ETextureTarget::TEXTURE_2D;
 
     GLuint texID;
@@ -522,15 +655,23 @@ std::shared_ptr<Texture> OpenglRenderer::load_texture(const std::string& name, c
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texture->width, texture->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture->pixels);
     glGenerateMipmap(GL_TEXTURE_2D);
 
-    texture->id     = texID;
-    _textures[name] = texture;
+    texture->id = texID;
 
-    LOG_DEBUG("Successfully uploaded texture '%s' to GPU with ID=%u (size=%dx%d)", name.c_str(), texID, texture->width, texture->height);
+    // Cutout sprites (alpha only 0 or 255) can go through the depth tested opaque 2D pass
+    if (auto* gl_tex = dynamic_cast<OpenglTexture*>(texture.get())) {
+        const auto* pixels = static_cast<const Uint8*>(texture->pixels);
+        const size_t count = static_cast<size_t>(texture->width) * texture->height;
 
-    free(texture->pixels);
-    texture->pixels = nullptr;
+        gl_tex->is_opaque = true;
+        for (size_t i = 0; i < count && gl_tex->is_opaque; i++) {
+            const Uint8 alpha = pixels[i * 4 + 3];
+            gl_tex->is_opaque = alpha == 0 || alpha == 255;
+        }
+    }
 
-    return texture;
+    LOG_DEBUG("Successfully uploaded texture '%s' to GPU with ID=%u (size=%dx%d)", name.c_str(), texID, texture->width, texture->height);
+
+    return Renderer::upload_texture(name, texture);
 }
 
 
@@ -558,6 +699,7 @@ void OpenglRenderer::draw_triangle_3d(const glm::vec3& v1, const glm::vec3& v2,
 }
 
 std::unique_ptr<Mesh> OpenglRenderer::load_mesh(aiMesh* mesh, const aiScene* scene, const std::string& base_dir) {
+    PROFILE_SCOPE("OpenglRenderer::load_mesh");
     auto ogl_mesh = std::make_unique<OpenglMesh>();
     ogl_mesh->material->shader = default_shader;
 
@@ -677,141 +819,317 @@ std::unique_ptr<Mesh> OpenglRenderer::load_mesh(aiMesh* mesh, const aiScene* sce
 }
 
 
-void OpenglRenderer::draw_model(const Transform3D& t, const Model* model) {
+void OpenglRenderer::draw_model(const Transform3D& t, const Model* model, bool is_static, int stage) {
+
 
+    RenderStage* render_stage = get_stage(stage);
 
-    if (!model || !default_shader) {
+    if (!model || !default_shader || !render_stage) {
         return;
     }
 
-    for (auto& mesh : model->meshes) {
-        if (!mesh) {
+    const glm::mat4 matrix = t.get_model_matrix();
+
+    if (is_static) {
+        add_static_caster(*render_stage, model, matrix);
+    }
+
+    // Culled here, on the submitting worker, so hidden meshes never reach the batches
+    thread_local std::vector<Uint8> mesh_passes;
+    mesh_passes.resize(model->meshes.size());
+
+    if (cull_meshes(model, matrix, mesh_passes.data()) == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < model->meshes.size(); i++) {
+        Mesh* mesh = model->meshes[i].get();
+
+        if (!mesh || mesh_passes[i] == 0) {
             continue;
         }
 
-        auto& batch  = _instanced_batches[mesh.get()];
-        batch.mesh   = mesh.get();
+        auto& batch  = add_instance(*render_stage, mesh, matrix, glm::vec3(1.0f), -1, is_static ? mesh_passes[i] | RENDER_PASS_STATIC : mesh_passes[i]);
         batch.shader = default_shader;
-        batch.models.push_back(t.get_model_matrix());
-        batch.colors.push_back(glm::vec3(1.0f));
-        batch.mode = GEngine->get_config().is_debug ? EDrawMode::LINES : EDrawMode::TRIANGLES;
+        batch.mode   = GEngine->get_config().is_debug ? EDrawMode::LINES : EDrawMode::TRIANGLES;
     }
 }
 
-void OpenglRenderer::draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count) {
-    if (!model || !default_shader) {
+void OpenglRenderer::draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count,
+                                         int animation, int stage) {
+    RenderStage* render_stage = get_stage(stage);
+
+    if (!model || !default_shader || !render_stage) {
         return;
     }
 
+    const glm::mat4 matrix = t.get_model_matrix();
 
-    bone_count = bone_count > MAX_BONES ? SDL_min(bone_count, MAX_BONES) : bone_count;
+    const bool has_clip_bounds = animation >= 0 && animation < static_cast<int>(model->animation_bounds.size());
+    const Uint8 passes         = get_visible_passes(has_clip_bounds ? model->animation_bounds[animation] : model->bounds, matrix);
+
+    if (passes == 0) {
+        return;
+    }
+
+    // Every instance keeps its own pose, the batches only store where it starts in the palette
+    const Sint32 bone_offset = add_bone_palette(*render_stage, model, bone_transforms, bone_count);
 
     for (auto& mesh : model->meshes) {
         if (!mesh || !mesh->has_bones) {
             continue;
         }
 
-        auto& batch  = _instanced_batches[mesh.get()];
-        batch.mesh   = mesh.get();
+        auto& batch  = add_instance(*render_stage, mesh.get(), matrix, glm::vec3(1.0f), bone_offset, passes);
         batch.shader = default_shader;
-        batch.models.push_back(t.get_model_matrix());
-        batch.colors.push_back(glm::vec3(1.0f));
-        batch.mode = GEngine->get_config().is_debug ? EDrawMode::LINES : EDrawMode::TRIANGLES;
+        batch.mode   = GEngine->get_config().is_debug ? EDrawMode::LINES : EDrawMode::TRIANGLES;
+    }
+}
+
+
+void OpenglRenderer::upload_instances() {
+    PROFILE_SCOPE("OpenglRenderer::upload_instances");
+
+    // Every batch is written once, in one upload, the passes of the frame only differ by their shader
+    _instance_staging.clear();
+
+    // Without the static cache, static casters are drawn with the dynamic ones
+    const Uint8 pass_mask = staticShadowFBO ? 0xFF : static_cast<Uint8>(~RENDER_PASS_STATIC);
+
+    for (auto& [_, batch] : _instanced_batches) {
+        const auto stage = [&](Uint8 passes) {
+            for (size_t i = 0; i < batch.models.size(); i++) {
+                if (((i < batch.passes.size() ? batch.passes[i] : RENDER_PASS_ALL) & pass_mask) != passes) {
+                    continue;
+                }
+
+                _instance_staging.push_back({batch.models[i], i < batch.colors.size() ? batch.colors[i] : glm::vec3(1.0f),
+                                             i < batch.bone_offsets.size() ? batch.bone_offsets[i] : -1});
+            }
+        };
+
+        // Static shadow only, static both, main only, both, shadow only: each pass draws one contiguous range, shared
+        // instances are stored once
+        const bool is_split = !batch.passes.empty();
+
+        const size_t static_first = _instance_staging.size();
+
+        if (is_split) {
+            stage(RENDER_PASS_SHADOW | RENDER_PASS_STATIC);
+        }
+
+        const size_t main_first = _instance_staging.size();
+
+        if (is_split) {
+            stage(RENDER_PASS_ALL | RENDER_PASS_STATIC);
+        }
+
+        const size_t main_only = _instance_staging.size();
 
+        if (is_split) {
+            stage(RENDER_PASS_MAIN);
+        }
+
+        const size_t both = _instance_staging.size();
+        stage(RENDER_PASS_ALL);
+
+        const size_t shadow_only = _instance_staging.size();
+
+        if (is_split) {
+            stage(RENDER_PASS_SHADOW);
+        }
 
-        batch.bone_transforms = bone_transforms;
-        batch.bone_count      = bone_count;
+        batch.static_first   = static_first;
+        batch.static_count   = main_only - static_first;
+        batch.first_instance = main_first;
+        batch.main_count     = shadow_only - main_first;
+        batch.shadow_first   = both;
+        batch.shadow_count   = _instance_staging.size() - both;
     }
+
+    if (_instance_staging.empty()) {
+        return;
+    }
+
+    _instance_base = _instance_arena.upload(_instance_staging.data(), _instance_staging.size() * sizeof(OpenglInstance3D));
 }
 
+void OpenglRenderer::bind_instances(OpenglMesh* ogl_mesh, size_t first_instance) {
+    const size_t offset = _instance_base + first_instance * sizeof(OpenglInstance3D);
 
-void OpenglRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
+    glBindVertexArray(ogl_mesh->vao);
 
-    // Simple directional light setup
-    // Light direction: vector pointing FROM scene UP TO the sun
-    glm::vec3 to_light = glm::normalize(glm::vec3(1.0f, 2.5f, 1.0f)); // Sun higher in sky
+    if (ogl_mesh->has_instance_layout && ogl_mesh->instance_offset == offset) {
+        return;
+    }
 
-    // TODO: Calculate dynamic scene bounds from all rendered objects
-    // For now, using larger fixed bounds to capture more of the scene
-    glm::vec3 scene_center   = glm::vec3(0.0f, 5.0f, 10.0f); // Center of your scene
-    glm::vec3 light_position = scene_center + to_light * 100.0f; // Far enough to act as directional
+    // Enables and divisors are VAO state, only the pointers follow the frame data
+    if (!ogl_mesh->has_instance_layout) {
+        for (int i = 0; i < 5; i++) {
+            glEnableVertexAttribArray(3 + i);
+            glVertexAttribDivisor(3 + i, 1);
+        }
 
-    // For shader: direction light comes FROM (opposite of to_light)
-    glm::vec3 lightDir = -to_light;
+        glEnableVertexAttribArray(10);
+        glVertexAttribDivisor(10, 1);
 
-    // Larger orthographic bounds to capture full scene (adjust these if shadows get cut off)
-    float shadow_extent           = 120.0f; // Increased from 80 to capture more
-    glm::mat4 orthgonalProjection = glm::ortho(-shadow_extent, shadow_extent, -shadow_extent, shadow_extent, 0.1f, 1000.0f);
-    glm::mat4 lightView           = glm::lookAt(light_position, scene_center, glm::vec3(0.0f, 1.0f, 0.0f));
-    glm::mat4 lightProjection     = orthgonalProjection * lightView;
+        ogl_mesh->has_instance_layout = true;
+    }
 
-    glDisable(GL_MULTISAMPLE);
+    glBindBuffer(GL_ARRAY_BUFFER, _instance_arena.get_id());
 
-    // glCullFace(GL_FRONT);
-#pragma region SHADOW_PASS
-    glEnable(GL_DEPTH_TEST);
+    for (int i = 0; i < 4; i++) {
+        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(OpenglInstance3D),
+                              reinterpret_cast<const void*>(offset + offsetof(OpenglInstance3D, model) + i * sizeof(glm::vec4)));
+    }
 
-    glViewport(0, 0, shadowWidth, shadowHeight);
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(OpenglInstance3D), reinterpret_cast<const void*>(offset + offsetof(OpenglInstance3D, color)));
+    glVertexAttribIPointer(10, 1, GL_INT, sizeof(OpenglInstance3D), reinterpret_cast<const void*>(offset + offsetof(OpenglInstance3D, bone_offset)));
 
-    shadow_shader->activate();
-    shadow_shader->set_value("LIGHT_PROJECTION", lightProjection);
+    ogl_mesh->instance_offset = offset;
+}
+
+void OpenglRenderer::upload_bone_palette() {
+    if (_bone_palette.empty()) {
+        return;
+    }
+
+    PROFILE_SCOPE("OpenglRenderer::upload_bone_palette");
+
+    const int texels = static_cast<int>(_bone_palette.size());
+    const int height = (texels + BONE_PALETTE_WIDTH - 1) / BONE_PALETTE_WIDTH;
 
+    // Padded to full rows, the tail of the last row is never fetched
+    _bone_palette.resize(static_cast<size_t>(height) * BONE_PALETTE_WIDTH);
 
-    // Render all batches to shadow map (instanced rendering)
+    glActiveTexture(GL_TEXTURE0 + BONE_PALETTE_UNIT);
+
+    if (!_bone_texture) {
+        glGenTextures(1, &_bone_texture);
+        glBindTexture(GL_TEXTURE_2D, _bone_texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, _bone_texture);
+    }
+
+    if (height > _bone_texture_height) {
+        // Doubled, a crowd growing by one character does not reallocate every frame
+        _bone_texture_height = SDL_max(height, _bone_texture_height * 2);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, BONE_PALETTE_WIDTH, _bone_texture_height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    }
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, BONE_PALETTE_WIDTH, height, GL_RGBA, GL_FLOAT, _bone_palette.data());
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void OpenglRenderer::draw_shadow_casters(bool is_static) {
     for (auto& [_, batch] : _instanced_batches) {
-        const Mesh* mesh = batch.mesh;
-        auto& models     = batch.models;
+        const Mesh* mesh   = batch.mesh;
+        const size_t first = is_static ? batch.static_first : batch.shadow_first;
+        const size_t count = is_static ? batch.static_count : batch.shadow_count;
 
-        if (!mesh || models.empty()) {
+        if (!mesh || count == 0) {
             continue;
         }
 
-        const OpenglMesh* ogl_mesh = static_cast<const OpenglMesh*>(mesh);
-        if (!ogl_mesh) {
-            continue;
-        }
+        OpenglMesh* ogl_mesh = static_cast<OpenglMesh*>(batch.mesh);
 
-        auto& buffers = _buffers[mesh];
-        if (buffers.instance_buffer == 0) {
-            glGenBuffers(1, &buffers.instance_buffer);
-            glGenBuffers(1, &buffers.color_buffer);
-        }
+        // Same range as the main pass unless some instances were culled from one of them
+        bind_instances(ogl_mesh, first);
 
+        shadow_shader->set_value("USE_SKELETON", mesh->has_bones && !batch.bone_offsets.empty() ? 1 : 0);
+
+        glDrawElementsInstanced(GL_TRIANGLES, ogl_mesh->index_count, GL_UNSIGNED_INT, 0, count);
+    }
+}
 
-        glBindVertexArray(ogl_mesh->vao);
+void OpenglRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
+    PROFILE_SCOPE("OpenglRenderer::flush");
 
-        // Upload instance model matrices
-        glBindBuffer(GL_ARRAY_BUFFER, buffers.instance_buffer);
-        glBufferData(GL_ARRAY_BUFFER, models.size() * sizeof(glm::mat4), models.data(), GL_STREAM_DRAW);
+    // Sun of `set_view_3d`, the instances were culled against the frustum enclosing its cascades
+    const glm::vec3 lightDir        = _light_direction_3d;
+    const ShadowCascades& cascades  = _shadow_cascades;
+    const int cascade_count         = SDL_min(cascades.count, shadowCascadeCount);
 
-        // Set up instanced model matrix attributes (location 3-6 for mat4)
-        // CRITICAL: Buffer must be bound when setting up attributes
-        for (int i = 0; i < 4; i++) {
-            glEnableVertexAttribArray(3 + i);
-            glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*) (i * sizeof(glm::vec4)));
-            glVertexAttribDivisor(3 + i, 1);
+    glDisable(GL_MULTISAMPLE);
+
+    for (const RenderStage& stage : _stages) {
+        if (stage.has_mesh_material && cube_mesh) {
+            cube_mesh->material->albedo         = stage.mesh_material.albedo;
+            cube_mesh->material->albedo_texture = stage.mesh_material.albedo_texture;
+            cube_mesh->material->normal_texture = stage.mesh_material.normal_texture;
+            cube_mesh->material->shader         = default_shader;
         }
+    }
+
+    merge_stages();
+    upload_instances();
+    upload_bone_palette();
+
+    glActiveTexture(GL_TEXTURE0 + BONE_PALETTE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, _bone_texture);
+    glActiveTexture(GL_TEXTURE0);
+
+    // glCullFace(GL_FRONT);
+#pragma region SHADOW_PASS
+    PROFILE_BEGIN("OpenglRenderer::shadow_pass");
+    _gpu_timer.begin_zone("OpenglRenderer::shadow_pass");
+    glEnable(GL_DEPTH_TEST);
 
-        if (mesh->has_bones) {
-            shadow_shader->set_value("USE_SKELETON", 1);
+    glViewport(0, 0, shadowResolution, shadowResolution);
+    glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
 
-            int count = batch.bone_count < MAX_BONES ? batch.bone_count : MAX_BONES;
+    shadow_shader->activate();
+    shadow_shader->set_value("BONE_PALETTE", BONE_PALETTE_UNIT);
 
-            if (batch.bone_transforms && batch.bone_count > 0) {
-                shadow_shader->set_value("BONES", batch.bone_transforms, count);
+    // Static casters are only redrawn into the cascades that moved, or all of them when the casters changed
+    const Uint64 static_signature = _static_caster_signature;
+    const bool has_static_casters = staticShadowFBO && static_signature != 0;
+
+    if (has_static_casters) {
+        const Uint32 redraws = _static_shadows.update(cascades, static_signature);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, staticShadowFBO);
+
+        for (int cascade = 0; cascade < cascade_count; cascade++) {
+            if (!(redraws & (1u << cascade))) {
+                continue;
             }
 
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticShadowTexID, 0, cascade);
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+            shadow_shader->set_value("LIGHT_PROJECTION", cascades.matrices[cascade]);
+            draw_shadow_casters(true);
+        }
+    }
+
+    // Each cascade is its own layer; the shadow range is drawn in all of them, the GPU clips what falls outside
+    for (int cascade = 0; cascade < cascade_count; cascade++) {
+        glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowTexID, 0, cascade);
+
+        if (has_static_casters) {
+            // Starts from the cached static depth, the dynamic casters are drawn over it
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, staticShadowFBO);
+            glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticShadowTexID, 0, cascade);
+            glBlitFramebuffer(0, 0, shadowResolution, shadowResolution, 0, 0, shadowResolution, shadowResolution, GL_DEPTH_BUFFER_BIT,
+                              GL_NEAREST);
         } else {
-            shadow_shader->set_value("USE_SKELETON", 0);
+            glClear(GL_DEPTH_BUFFER_BIT);
         }
 
-        glDrawElementsInstanced(GL_TRIANGLES, ogl_mesh->index_count, GL_UNSIGNED_INT, 0, models.size());
+        shadow_shader->set_value("LIGHT_PROJECTION", cascades.matrices[cascade]);
+        draw_shadow_casters(false);
     }
 
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    _gpu_timer.end_zone();
+    PROFILE_END();
 #pragma endregion
 
     glEnable(GL_BLEND);
@@ -819,11 +1137,16 @@ void OpenglRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
     glEnable(GL_MULTISAMPLE);
     glCullFace(GL_BACK);
 #pragma region RENDER_PASS
+    PROFILE_BEGIN("OpenglRenderer::main_pass");
+    _gpu_timer.begin_zone("OpenglRenderer::main_pass");
+
+    const bool is_timing_batches = GEngine->get_config().get_performance().is_profiling_gpu_batches;
 
     const auto& window = GEngine->get_config().get_window();
     glViewport(0, 0, window.width, window.height);
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    _is_frame_cleared = true;
 
     // LOG_DEBUG("MSAA during render: %s", glIsEnabled(GL_MULTISAMPLE) ? "ON" : "OFF");
 
@@ -832,7 +1155,7 @@ void OpenglRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
         auto shader      = batch.shader;
         auto& models     = batch.models;
 
-        if (!mesh || !shader || models.empty()) {
+        if (!mesh || !shader || models.empty() || batch.main_count == 0) {
             continue;
         }
 
@@ -844,39 +1167,25 @@ void OpenglRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
 
         // Set up directional light (sun)
         ogl_shader->set_value("LIGHT_DIRECTION", lightDir); // Direction light comes FROM
-        ogl_shader->set_value("LIGHT_PROJECTION", lightProjection);
+        ogl_shader->set_value("SHADOW_MATRICES", cascades.matrices.data(), cascade_count);
+        ogl_shader->set_value("SHADOW_SPLITS", cascades.splits.data(), cascade_count);
+        ogl_shader->set_value("SHADOW_CASCADE_COUNT", cascade_count);
 
-        const OpenglMesh* ogl_mesh = static_cast<const OpenglMesh*>(mesh);
+        OpenglMesh* ogl_mesh = static_cast<OpenglMesh*>(batch.mesh);
         if (!ogl_shader->is_valid()) {
             continue;
         }
 
 
-        auto& buffers = _buffers[mesh];
-
-        if (buffers.instance_buffer == 0) {
-            glGenBuffers(1, &buffers.instance_buffer);
-            glGenBuffers(1, &buffers.color_buffer);
+        if (is_timing_batches) {
+            _gpu_timer.begin_zone(get_batch_zone_name(mesh));
         }
 
-        glBindBuffer(GL_ARRAY_BUFFER, buffers.instance_buffer);
-        glBufferData(GL_ARRAY_BUFFER, models.size() * sizeof(glm::mat4), models.data(), GL_STREAM_DRAW);
+        bind_instances(ogl_mesh, batch.first_instance);
 
-        glBindVertexArray(ogl_mesh->vao);
-
-        // TODO: refactor to send SSBO for bones
-        if (mesh->has_bones) {
-            ogl_shader->set_value("USE_SKELETON", 1);
-
-            int count = batch.bone_count < MAX_BONES ? batch.bone_count : MAX_BONES;
-
-            if (batch.bone_transforms && batch.bone_count > 0) {
-                ogl_shader->set_value("BONES", batch.bone_transforms, count);
-            }
-
-        } else {
-            ogl_shader->set_value("USE_SKELETON", 0);
-        }
+        // Poses are read per instance from the bone palette, one draw for every character sharing the mesh
+        ogl_shader->set_value("USE_SKELETON", mesh->has_bones && !batch.bone_offsets.empty() ? 1 : 0);
+        ogl_shader->set_value("BONE_PALETTE", BONE_PALETTE_UNIT);
 
 
         mesh->material->bind();
@@ -885,67 +1194,81 @@ void OpenglRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
 
         // TODO: refactor this to use FBO
         glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, shadowTexID);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, shadowTexID);
         ogl_shader->set_value("SHADOW_TEXTURE", 2);
 
 
-        // instanced model matrix (4 vec4)
-        for (int i = 0; i < 4; i++) {
-            glEnableVertexAttribArray(3 + i);
-            glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*) (i * sizeof(glm::vec4)));
-            glVertexAttribDivisor(3 + i, 1);
-        }
-
-        // instanced colors
-        if (!batch.colors.empty()) {
-            glBindBuffer(GL_ARRAY_BUFFER, buffers.color_buffer);
-            glBufferData(GL_ARRAY_BUFFER, batch.colors.size() * sizeof(glm::vec3), batch.colors.data(), GL_STREAM_DRAW);
+        auto mode = batch.mode == EDrawMode::LINES ? GL_LINES : GL_TRIANGLES;
+        glDrawElementsInstanced(mode, ogl_mesh->index_count, GL_UNSIGNED_INT, 0, batch.main_count);
 
-            glEnableVertexAttribArray(7);
-            glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*) 0);
-            glVertexAttribDivisor(7, 1);
+        if (is_timing_batches) {
+            _gpu_timer.end_zone();
         }
-
-
-        auto mode = batch.mode == EDrawMode::LINES ? GL_LINES : GL_TRIANGLES;
-        glDrawElementsInstanced(mode, ogl_mesh->index_count, GL_UNSIGNED_INT, 0, models.size());
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
     glBindVertexArray(0);
     _instanced_batches.clear();
+    _bone_palette.clear();
 
+    // Both passes are issued, the region can be recycled once the GPU is done with them
+    _instance_arena.end_frame();
+
+    _gpu_timer.end_zone();
+    PROFILE_END();
 #pragma endregion
     glDisable(GL_BLEND);
 
 #pragma region ENVIRONMENT_PASS
+    PROFILE_BEGIN("OpenglRenderer::environment_pass");
+    _gpu_timer.begin_zone("OpenglRenderer::environment_pass");
     draw_environment(view, projection);
+    _gpu_timer.end_zone();
+    PROFILE_END();
+
+#pragma endregion
 
+#pragma region PARTICLE_PASS
+    _gpu_timer.begin_zone("OpenglRenderer::particle_pass");
+    _particles_3d.flush(view, projection);
+    _gpu_timer.end_zone();
 #pragma endregion
 }
 
 
-void OpenglRenderer::draw_mesh(const Transform3D& transform, const MeshInstance3D& mesh, const Shader* shader) {
+void OpenglRenderer::draw_mesh(const Transform3D& transform, const MeshInstance3D& mesh, const Shader* shader, bool is_static, int stage) {
 
-    if (!cube_mesh) {
+    RenderStage* render_stage = get_stage(stage);
+
+    if (!cube_mesh || !render_stage) {
         return;
     }
 
     Transform3D temp = transform;
     temp.scale       = mesh.size;
 
-    auto& batch                  = _instanced_batches[cube_mesh.get()];
-    batch.mesh                   = cube_mesh.get();
-    batch.mesh->material->albedo = mesh.material.albedo;
-    batch.mesh->material->albedo_texture = mesh.material.albedo_texture;
-    batch.mesh->material->normal_texture = mesh.material.normal_texture;
-    batch.mesh->material->shader = default_shader;
-    batch.shader                 = default_shader;
-    batch.models.push_back(temp.get_model_matrix());
-    batch.colors.push_back(mesh.material.albedo);
+    const glm::mat4 model = temp.get_model_matrix();
+    const Uint8 passes    = get_visible_passes(cube_mesh->bounds, model);
+
+    if (is_static) {
+        add_static_caster(*render_stage, cube_mesh.get(), model);
+    }
+
+    if (passes == 0) {
+        return;
+    }
+
+    auto& batch   = add_instance(*render_stage, cube_mesh.get(), model, mesh.material.albedo, -1, is_static ? passes | RENDER_PASS_STATIC : passes);
+    batch.shader  = default_shader;
     batch.command = EDrawCommand::MESH;
     batch.mode    = GEngine->get_config().is_debug ? EDrawMode::LINES : EDrawMode::TRIANGLES;
+
+    // The cube is shared by every worker, its material is only written by the flush
+    render_stage->mesh_material.albedo         = mesh.material.albedo;
+    render_stage->mesh_material.albedo_texture = mesh.material.albedo_texture;
+    render_stage->mesh_material.normal_texture = mesh.material.normal_texture;
+    render_stage->has_mesh_material            = true;
 }
 
 void OpenglRenderer::draw_environment(const glm::mat4& view, const glm::mat4& projection) {
@@ -973,11 +1296,73 @@ void OpenglRenderer::draw_environment(const glm::mat4& view, const glm::mat4& pr
     glDepthFunc(GL_LESS);
 }
 
+namespace {
+
+    constexpr int QUAD_INDICES[] = {0, 1, 2, 0, 2, 3};
+
+    /// Local point -> world, scaled then rotated by the world transform
+    glm::vec2 to_world(const Transform2D& transform, glm::vec2 point, float cosr, float sinr) {
+        const float x = point.x * transform.world_scale.x;
+        const float y = point.y * transform.world_scale.y;
+        return {transform.world_position.x + x * cosr - y * sinr, transform.world_position.y + x * sinr + y * cosr};
+    }
+
+} // namespace
+
+void OpenglRenderer::set_view_2d(const glm::mat4& view) {
+    Renderer::set_view_2d(view);
+
+    _view_scale_2d = SDL_sqrtf(SDL_fabsf(glm::determinant(glm::mat2(glm::vec2(view[0]), glm::vec2(view[1])))));
+}
+
+void OpenglRenderer::push_shape(const glm::vec2* points, size_t count, const int* indices, size_t index_count, glm::vec4 color) {
+    _batch_2d.push(0, color.a >= 1.0f, points, nullptr, count, indices, index_count, color);
+}
+
+void OpenglRenderer::push_outline(const glm::vec2* points, size_t count, glm::vec4 color) {
+    // Built in world space, so the width is divided by the zoom to stay 1px on screen
+    const float width = _view_scale_2d > 0.0f ? 1.0f / _view_scale_2d : 1.0f;
+
+    build_outline(points, count, width, _outline_positions, _outline_indices);
+    push_shape(_outline_positions.data(), _outline_positions.size(), _outline_indices.data(), _outline_indices.size(), color);
+}
+
 void OpenglRenderer::draw_texture(const Transform2D& transform, Texture* texture, const glm::vec4& dest, const glm::vec4& source,
                                   bool flip_h, bool flip_v, const glm::vec4& color) {
-}
 
-void OpenglRenderer::draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) {
+    // Every texture loaded by this renderer is an OpenglTexture
+    const OpenglTexture* gl_tex = static_cast<OpenglTexture*>(texture);
+
+    if (!gl_tex || !gl_tex->is_valid() || gl_tex->width <= 0 || gl_tex->height <= 0) {
+        return;
+    }
+
+    // Same placement as the SDLRenderer: dest offset from the world position, rotated around its center
+    const float hw   = dest.z * transform.world_scale.x * 0.5f;
+    const float hh   = dest.w * transform.world_scale.y * 0.5f;
+    const float cx   = transform.world_position.x + dest.x + hw;
+    const float cy   = transform.world_position.y + dest.y + hh;
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    const auto corner = [&](float x, float y) { return glm::vec2(cx + x * cosr - y * sinr, cy + x * sinr + y * cosr); };
+
+    float u0 = source.x / static_cast<float>(gl_tex->width);
+    float v0 = source.y / static_cast<float>(gl_tex->height);
+    float u1 = (source.x + source.z) / static_cast<float>(gl_tex->width);
+    float v1 = (source.y + source.w) / static_cast<float>(gl_tex->height);
+
+    if (flip_h) {
+        std::swap(u0, u1);
+    }
+    if (flip_v) {
+        std::swap(v0, v1);
+    }
+
+    const glm::vec2 positions[4] = {corner(-hw, -hh), corner(hw, -hh), corner(hw, hh), corner(-hw, hh)};
+    const glm::vec2 uvs[4]       = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+    _batch_2d.push(gl_tex->id, gl_tex->is_opaque && color.a >= 1.0f, positions, uvs, 4, QUAD_INDICES, 6, color);
 }
 
 void OpenglRenderer::draw_text_3d(const Transform3D& transform, const glm::mat4& view, const glm::mat4& projection, const glm::vec4& color,
@@ -985,38 +1370,239 @@ void OpenglRenderer::draw_text_3d(const Transform3D& transform, const glm::mat4&
 }
 
 void OpenglRenderer::draw_rect(const Transform2D& transform, float w, float h, glm::vec4 color, bool is_filled) {
+    const float hw   = w / 2.0f;
+    const float hh   = h / 2.0f;
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    const glm::vec2 pts[4] = {
+        to_world(transform, {-hw, -hh}, cosr, sinr), // Top-left
+        to_world(transform, {hw, -hh}, cosr, sinr), // Top-right
+        to_world(transform, {hw, hh}, cosr, sinr), // Bottom-right
+        to_world(transform, {-hw, hh}, cosr, sinr), // Bottom-left
+    };
+
+    if (is_filled) {
+        push_shape(pts, 4, QUAD_INDICES, 6, color);
+    } else {
+        push_outline(pts, 4, color);
+    }
 }
 
 void OpenglRenderer::draw_triangle(const Transform2D& transform, float size, glm::vec4 color, bool is_filled) {
+    const float height = SDL_sqrtf(3.0f) / 2.0f * size;
+    const float cosr   = SDL_cosf(transform.world_rotation);
+    const float sinr   = SDL_sinf(transform.world_rotation);
+
+    const glm::vec2 pts[3] = {
+        to_world(transform, {0.0f, -height / 2.0f}, cosr, sinr), // Top vertex
+        to_world(transform, {-size / 2.0f, height / 2.0f}, cosr, sinr), // Bottom left
+        to_world(transform, {size / 2.0f, height / 2.0f}, cosr, sinr), // Bottom right
+    };
+
+    if (is_filled) {
+        constexpr int indices[] = {0, 1, 2};
+        push_shape(pts, 3, indices, 3, color);
+    } else {
+        push_outline(pts, 3, color);
+    }
 }
 
 void OpenglRenderer::draw_line(const Transform2D& transform, glm::vec2 end, glm::vec4 color) {
+    const glm::vec2 from = transform.world_position;
+    const glm::vec2 to   = to_world(transform, end, SDL_cosf(transform.world_rotation), SDL_sinf(transform.world_rotation));
+
+    const glm::vec2 direction = to - from;
+    const float length        = glm::length(direction);
+
+    if (length <= 0.0f) {
+        return;
+    }
+
+    // A quad 1px wide on screen
+    const float half_width = 0.5f / (_view_scale_2d > 0.0f ? _view_scale_2d : 1.0f);
+    const glm::vec2 normal = glm::vec2(-direction.y, direction.x) / length * half_width;
+
+    const glm::vec2 pts[4] = {from + normal, to + normal, to - normal, from - normal};
+
+    push_shape(pts, 4, QUAD_INDICES, 6, color);
 }
 
 void OpenglRenderer::draw_circle(const Transform2D& transform, float radius, glm::vec4 color, bool is_filled) {
+    if (radius <= 0.0f) {
+        return;
+    }
+
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    // The transform position is the top-left corner of the circle bounds
+    const glm::vec2 center = to_world(transform, {radius, radius}, cosr, sinr);
+
+    const float scale_x = radius * transform.world_scale.x;
+    const float scale_y = radius * transform.world_scale.y;
+
+    const auto& unit_circle = get_unit_circle(get_circle_segments(SDL_max(SDL_fabsf(scale_x), SDL_fabsf(scale_y)) * _view_scale_2d));
+    const int segments      = static_cast<int>(unit_circle.size());
+
+    // Triangle fan around the center, the center is dropped by outlines
+    _scratch_points.clear();
+    _scratch_points.push_back(center);
+
+    for (const glm::vec2& point : unit_circle) {
+        const float x = point.x * scale_x;
+        const float y = point.y * scale_y;
+        _scratch_points.emplace_back(center.x + x * cosr - y * sinr, center.y + x * sinr + y * cosr);
+    }
+
+    if (!is_filled) {
+        push_outline(_scratch_points.data() + 1, segments, color);
+        return;
+    }
+
+    _scratch_indices.clear();
+
+    for (int i = 0; i < segments; i++) {
+        _scratch_indices.push_back(0);
+        _scratch_indices.push_back(1 + i);
+        _scratch_indices.push_back(1 + (i + 1) % segments);
+    }
+
+    push_shape(_scratch_points.data(), _scratch_points.size(), _scratch_indices.data(), _scratch_indices.size(), color);
 }
 
 void OpenglRenderer::draw_polygon(const Transform2D& transform, const std::vector<glm::vec2>& points, glm::vec4 color, bool is_filled) {
+    if (points.empty()) {
+        return;
+    }
+
+    if (is_filled) {
+        // Uncached, Shape2D polygons go through draw_polygon_triangles with their stored triangulation
+        triangulate_polygon(points, _scratch_triangles);
+        draw_polygon_triangles(transform, points, _scratch_triangles, color);
+        return;
+    }
+
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    _scratch_points.clear();
+
+    for (const auto& point : points) {
+        _scratch_points.push_back(to_world(transform, point, cosr, sinr));
+    }
+
+    push_outline(_scratch_points.data(), _scratch_points.size(), color);
 }
 
+void OpenglRenderer::draw_polygon_triangles(const Transform2D& transform, const std::vector<glm::vec2>& points, const std::vector<int>& triangles,
+                                            glm::vec4 color) {
+    if (triangles.empty()) {
+        return;
+    }
+
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
 
-OpenglRenderer::~OpenglRenderer() {
+    _scratch_points.clear();
 
-    for (auto& [_, buffer] : _buffers) {
-        if (buffer.instance_buffer) {
-            glDeleteBuffers(1, &buffer.instance_buffer);
-            buffer.instance_buffer = 0;
-        }
-        if (buffer.color_buffer) {
-            glDeleteBuffers(1, &buffer.color_buffer);
-            buffer.color_buffer = 0;
+    for (const auto& point : points) {
+        _scratch_points.push_back(to_world(transform, point, cosr, sinr));
+    }
+
+    push_shape(_scratch_points.data(), _scratch_points.size(), triangles.data(), triangles.size(), color);
+}
+
+void OpenglRenderer::draw_texture_quads(const Transform2D& transform, Texture* texture, const std::vector<glm::vec2>& positions,
+                                        const std::vector<glm::vec2>& uvs, const glm::vec4& color) {
+    const OpenglTexture* gl_tex = static_cast<OpenglTexture*>(texture);
+
+    const size_t quad_count = SDL_min(positions.size(), uvs.size()) / 4;
+
+    if (!gl_tex || !gl_tex->is_valid() || quad_count == 0) {
+        return;
+    }
+
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    _scratch_points.clear();
+
+    for (size_t i = 0; i < quad_count * 4; i++) {
+        _scratch_points.push_back(to_world(transform, positions[i], cosr, sinr));
+    }
+
+    _batch_2d.push(gl_tex->id, gl_tex->is_opaque && color.a >= 1.0f, _scratch_points.data(), uvs.data(), quad_count * 4,
+                   get_quad_indices(quad_count).data(), quad_count * 6, color);
+}
+
+void OpenglRenderer::draw_particles_2d(const ParticlePool& pool, Texture* texture, const glm::vec4& uv, float size) {
+    const OpenglTexture* gl_tex = static_cast<OpenglTexture*>(texture);
+    const Uint32 texture_id     = gl_tex && gl_tex->is_valid() ? gl_tex->id : 0;
+
+    const size_t count = pool.size();
+
+    // Written straight into the batch, a particle is never a separate draw
+    OpenglVertex2D* vertices = _batch_2d.push_quads(texture_id, count);
+
+    if (!vertices) {
+        return;
+    }
+
+    const float* x = pool.get_stream(ParticlePool::POSITION_X);
+    const float* y = pool.get_stream(ParticlePool::POSITION_Y);
+    const float* r = pool.get_stream(ParticlePool::COLOR_R);
+    const float* g = pool.get_stream(ParticlePool::COLOR_G);
+    const float* b = pool.get_stream(ParticlePool::COLOR_B);
+    const float* a = pool.get_stream(ParticlePool::COLOR_A);
+
+    const float half = size * 0.5f;
+
+    const glm::vec2 corner_uvs[4] = {{uv.x, uv.y}, {uv.x + uv.z, uv.y}, {uv.x + uv.z, uv.y + uv.w}, {uv.x, uv.y + uv.w}};
+    const glm::vec2 offsets[4]    = {{-half, -half}, {half, -half}, {half, half}, {-half, half}};
+
+    for (size_t i = 0; i < count; i++) {
+        const glm::vec2 center = {x[i], y[i]};
+        const Uint32 color     = OpenglBatch2D::pack_color({r[i], g[i], b[i], a[i]});
+
+        for (int corner = 0; corner < 4; corner++) {
+            OpenglVertex2D& vertex = vertices[i * 4 + corner];
+            vertex.position.x      = center.x + offsets[corner].x;
+            vertex.position.y      = center.y + offsets[corner].y;
+            vertex.color           = color;
+
+            if (texture_id != 0) {
+                vertex.uv = corner_uvs[corner];
+            }
         }
     }
+}
+
+void OpenglRenderer::draw_particles_3d(const ParticlePool& pool, float size) {
+    std::lock_guard<std::mutex> lock(_batch_mutex);
+    _particles_3d.push(pool, size);
+}
+
+int OpenglRenderer::get_batch_2d_draw_calls() const {
+    return _batch_2d.get_draw_call_count();
+}
+
+
+OpenglRenderer::~OpenglRenderer() {
+
+    _instance_arena.destroy();
+
+    if (_bone_texture) {
+        glDeleteTextures(1, &_bone_texture);
+    }
 
     glDeleteTextures(1, &shadowTexID);
     glDeleteFramebuffers(1, &shadowFBO);
 
-    _buffers.clear();
+    if (staticShadowFBO) {
+        glDeleteTextures(1, &staticShadowTexID);
+        glDeleteFramebuffers(1, &staticShadowFBO);
+    }
 
     // cubemap resources
     delete skybox_mesh;
@@ -1032,9 +1618,31 @@ OpenglRenderer::~OpenglRenderer() {
     delete shadow_shader;
     shadow_shader = nullptr;
 
+    _gpu_timer.destroy();
+
+    _batch_2d.destroy();
+    _particles_3d.destroy();
+    clear_text_cache();
+
     SDL_GL_DestroyContext(_context);
 }
 
+const OpenglGpuTimer& OpenglRenderer::get_gpu_timer() const {
+    return _gpu_timer;
+}
+
+const char* OpenglRenderer::get_batch_zone_name(const Mesh* mesh) {
+    if (const auto it = _batch_zone_names.find(mesh); it != _batch_zone_names.end()) {
+        return it->second;
+    }
+
+    const std::string name = std::string("batch/") + std::string(mesh->name) + (mesh->has_bones ? " (skinned)" : "");
+    const char* interned   = Profiler::get_instance().intern(name.c_str());
+
+    _batch_zone_names[mesh] = interned;
+    return interned;
+}
+
 void OpenglRenderer::setup_default_shaders() {
 
 
@@ -1062,10 +1670,48 @@ void OpenglRenderer::setup_default_shaders() {
 
 
 std::vector<Tokens> OpenglRenderer::parse_text(const std::string& text) {
+    std::vector<Tokens> segments;
+
+    for_each_text_run(text, [&](const TextRun& run) { segments.push_back({text.substr(run.offset, run.length), run.is_emoji}); });
+
+    return segments;
+}
+
+std::unique_ptr<Texture> OpenglRenderer::create_glyph_page(int size) {
+    GLuint id = 0;
+    glGenTextures(1, &id);
+
+    if (id == 0) {
+        return nullptr;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Padding between glyphs must stay transparent
+    const std::vector<Uint32> transparent(static_cast<size_t>(size) * size, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent.data());
+
+    auto page    = std::make_unique<OpenglTexture>();
+    page->id     = id;
+    page->width  = size;
+    page->height = size;
+    page->target = ETextureTarget::TEXTURE_2D;
+    return page;
+}
 
-    return {};
+void OpenglRenderer::update_glyph_page(Texture* page, const SDL_Rect& rect, const void* pixels, int pitch) {
+    glBindTexture(GL_TEXTURE_2D, page->id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.w, rect.h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 }
 
-void OpenglRenderer::draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name,
-                                        const std::string& text) {
+void OpenglRenderer::push_glyph_quad(Texture* page, const glm::vec2* positions, const glm::vec2* uvs, const glm::vec4& color) {
+    _batch_2d.push(page->id, false, positions, uvs, 4, QUAD_INDICES, 6, color);
 }
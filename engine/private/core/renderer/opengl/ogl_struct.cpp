@@ -286,3 +286,333 @@ OpenglTexture::~OpenglTexture() {
         id = -1;
     }
 }
+
+
+void OpenglStreamBuffer::initialize(Uint32 target, size_t capacity) {
+    _target   = target;
+    _capacity = capacity;
+    _head     = 0;
+
+    glGenBuffers(1, &_id);
+    glBindBuffer(_target, _id);
+    glBufferData(_target, static_cast<GLsizeiptr>(_capacity), nullptr, GL_STREAM_DRAW);
+}
+
+size_t OpenglStreamBuffer::write(const void* data, size_t size) {
+    glBindBuffer(_target, _id);
+
+    if (size > _capacity) {
+        _capacity = SDL_max(_capacity * 2, size);
+        _head     = _capacity; // forces the orphaning below
+    }
+
+    if (_head + size > _capacity) {
+        // Orphan: the GPU keeps the old storage until it is done with it
+        glBufferData(_target, static_cast<GLsizeiptr>(_capacity), nullptr, GL_STREAM_DRAW);
+        _head = 0;
+    }
+
+    const size_t offset = _head;
+
+    void* destination = glMapBufferRange(_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size),
+                                         GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+    if (destination) {
+        SDL_memcpy(destination, data, size);
+        glUnmapBuffer(_target);
+    } else {
+        glBufferSubData(_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    }
+
+    // Keeps the next write aligned for any attribute type
+    _head = (offset + size + 15) & ~static_cast<size_t>(15);
+    return offset;
+}
+
+void OpenglStreamBuffer::bind() const {
+    glBindBuffer(_target, _id);
+}
+
+void OpenglStreamBuffer::destroy() {
+    if (_id != 0) {
+        glDeleteBuffers(1, &_id);
+        _id = 0;
+    }
+
+    _capacity = 0;
+    _head     = 0;
+}
+
+Uint32 OpenglStreamBuffer::get_id() const {
+    return _id;
+}
+
+size_t OpenglStreamBuffer::get_capacity() const {
+    return _capacity;
+}
+
+
+void OpenglInstanceArena::initialize(size_t frame_capacity) {
+#if defined(SDL_PLATFORM_EMSCRIPTEN)
+    _has_fences = false;
+#else
+    _has_fences = glFenceSync && glClientWaitSync && glDeleteSync;
+#endif
+
+    // Regions start on 256 bytes boundaries
+    _frame_capacity = (frame_capacity + 255) & ~static_cast<size_t>(255);
+    _region         = -1;
+
+    glGenBuffers(1, &_id);
+    glBindBuffer(GL_ARRAY_BUFFER, _id);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_frame_capacity * FRAME_COUNT), nullptr, GL_STREAM_DRAW);
+}
+
+size_t OpenglInstanceArena::upload(const void* data, size_t size) {
+    glBindBuffer(GL_ARRAY_BUFFER, _id);
+
+    _region = (_region + 1) % FRAME_COUNT;
+
+    if (size > _frame_capacity) {
+        // Fresh storage, nothing in flight reads it
+        _frame_capacity = (SDL_max(_frame_capacity * 2, size) + 255) & ~static_cast<size_t>(255);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_frame_capacity * FRAME_COUNT), nullptr, GL_STREAM_DRAW);
+        release_fences();
+    } else if (_has_fences && _fences[_region]) {
+        PROFILE_SCOPE("OpenglInstanceArena::wait");
+
+        while (glClientWaitSync(_fences[_region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+        }
+
+        glDeleteSync(_fences[_region]);
+        _fences[_region] = nullptr;
+    } else if (!_has_fences && _region == 0) {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_frame_capacity * FRAME_COUNT), nullptr, GL_STREAM_DRAW);
+    }
+
+    const size_t offset = static_cast<size_t>(_region) * _frame_capacity;
+
+    if (size == 0) {
+        return offset;
+    }
+
+    void* destination = glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size),
+                                         GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+    if (destination) {
+        SDL_memcpy(destination, data, size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    }
+
+    return offset;
+}
+
+void OpenglInstanceArena::end_frame() {
+    if (!_has_fences || _region < 0) {
+        return;
+    }
+
+    if (_fences[_region]) {
+        glDeleteSync(_fences[_region]);
+    }
+
+    _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void OpenglInstanceArena::release_fences() {
+    for (GLsync& fence : _fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
+
+void OpenglInstanceArena::destroy() {
+    release_fences();
+
+    if (_id != 0) {
+        glDeleteBuffers(1, &_id);
+        _id = 0;
+    }
+
+    _frame_capacity = 0;
+    _region         = -1;
+}
+
+Uint32 OpenglInstanceArena::get_id() const {
+    return _id;
+}
+
+size_t OpenglInstanceArena::get_frame_capacity() const {
+    return _frame_capacity;
+}
+
+
+// GPU TIMER IMPLEMENTATION
+
+bool OpenglGpuTimer::initialize() {
+#if defined(SDL_PLATFORM_IOS) || defined(SDL_PLATFORM_ANDROID) || defined(SDL_PLATFORM_EMSCRIPTEN)
+    _is_supported = false;
+#else
+    _is_supported = (GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query) && glQueryCounter && glGetQueryObjectui64v;
+#endif
+
+    if (!_is_supported) {
+        LOG_WARN("GPU timer queries not supported, GPU pass timing disabled");
+        return false;
+    }
+
+    for (auto& frame : _frames) {
+        frame.zones.resize(MAX_ZONES);
+
+        for (auto& zone : frame.zones) {
+            GLuint queries[2];
+            glGenQueries(2, queries);
+            zone.begin_query = queries[0];
+            zone.end_query   = queries[1];
+        }
+    }
+
+    _open.reserve(16);
+    _last_results.reserve(MAX_ZONES);
+
+    calibrate();
+
+    LOG_INFO("GPU Timer: %d frames x %d zones of timestamp queries", QUERY_FRAMES, MAX_ZONES);
+    return true;
+}
+
+bool OpenglGpuTimer::is_supported() const {
+    return _is_supported;
+}
+
+void OpenglGpuTimer::calibrate() {
+    GLint64 gpu_ns = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_ns);
+
+    _gpu_to_cpu_ns = static_cast<Sint64>(Profiler::get_time_ns()) - static_cast<Sint64>(gpu_ns);
+}
+
+void OpenglGpuTimer::resolve(Frame& frame) {
+    if (!frame.has_data || frame.used == 0) {
+        return;
+    }
+
+    // Never wait on the GPU, a frame that isn't complete yet is dropped
+    for (int i = 0; i < frame.used; ++i) {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(frame.zones[i].end_query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available == GL_FALSE) {
+            return;
+        }
+    }
+
+    _last_results.clear();
+
+    for (int i = 0; i < frame.used; ++i) {
+        const Zone& zone = frame.zones[i];
+
+        GLuint64 begin_ns = 0, end_ns = 0;
+        glGetQueryObjectui64v(zone.begin_query, GL_QUERY_RESULT, &begin_ns);
+        glGetQueryObjectui64v(zone.end_query, GL_QUERY_RESULT, &end_ns);
+
+        if (end_ns < begin_ns) {
+            continue;
+        }
+
+        _last_results.push_back({zone.name, end_ns - begin_ns, zone.depth});
+
+        Profiler::get_instance().record_zone("GPU", zone.name, static_cast<Uint64>(static_cast<Sint64>(begin_ns) + _gpu_to_cpu_ns),
+                                             static_cast<Uint64>(static_cast<Sint64>(end_ns) + _gpu_to_cpu_ns), zone.depth);
+    }
+}
+
+void OpenglGpuTimer::begin_frame() {
+    if (!_is_supported) {
+        return;
+    }
+
+    _frame_index = (_frame_index + 1) % QUERY_FRAMES;
+
+    Frame& frame = _frames[_frame_index];
+    resolve(frame);
+
+    frame.used     = 0;
+    frame.has_data = false;
+    _open.clear();
+
+    _is_recording = Profiler::get_instance().is_enabled();
+
+    // Clocks drift apart slowly, a sync point every few seconds is enough
+    if (++_frame_count % 300 == 0) {
+        calibrate();
+    }
+}
+
+void OpenglGpuTimer::begin_zone(const char* name) {
+    if (!_is_supported || !_is_recording) {
+        return;
+    }
+
+    Frame& frame = _frames[_frame_index];
+
+    if (frame.used >= MAX_ZONES) {
+        // keep the stack balanced, the zone is simply not timed
+        _open.push_back(-1);
+        return;
+    }
+
+    Zone& zone = frame.zones[frame.used];
+    zone.name  = name;
+    zone.depth = static_cast<Uint32>(_open.size());
+
+    glQueryCounter(zone.begin_query, GL_TIMESTAMP);
+
+    _open.push_back(frame.used);
+    frame.used++;
+    frame.has_data = true;
+}
+
+void OpenglGpuTimer::end_zone() {
+    if (!_is_supported || !_is_recording || _open.empty()) {
+        return;
+    }
+
+    const int index = _open.back();
+    _open.pop_back();
+
+    if (index < 0) {
+        return;
+    }
+
+    glQueryCounter(_frames[_frame_index].zones[index].end_query, GL_TIMESTAMP);
+}
+
+const std::vector<GpuZoneResult>& OpenglGpuTimer::get_last_results() const {
+    return _last_results;
+}
+
+void OpenglGpuTimer::destroy() {
+    if (!_is_supported) {
+        return;
+    }
+
+    for (auto& frame : _frames) {
+        for (auto& zone : frame.zones) {
+            GLuint queries[2] = {zone.begin_query, zone.end_query};
+            glDeleteQueries(2, queries);
+        }
+        frame.zones.clear();
+        frame.used = 0;
+    }
+
+    _is_supported = false;
+}
+
+OpenglGpuTimer::~OpenglGpuTimer() {
+    destroy();
+}
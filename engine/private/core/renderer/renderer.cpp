@@ -1,5 +1,6 @@
 #include "core/renderer/renderer.h"
 
+#include "core/component/logic/system_helper.h"
 #include "core/io/assimp_io.h"
 #include <core/engine.h>
 
@@ -18,6 +19,7 @@ std::string Renderer::vformat(const char* fmt, va_list args) {
 }
 
 std::shared_ptr<Texture> Renderer::load_texture(const std::string& name, const std::string& path, const aiTexture* ai_embedded_tex) {
+    PROFILE_SCOPE("Renderer::decode_texture");
     int width = 0, height = 0, channels = 0;
     unsigned char* pixels = nullptr;
 
@@ -77,6 +79,19 @@ std::shared_ptr<Texture> Renderer::load_texture(const std::string& name, const s
 
     }
 
+    auto texture = make_texture(width, height, pixels, path);
+
+    if (!texture) {
+        free(pixels);
+    } else {
+        LOG_INFO("Texture Info: Size %dx%d | Path: %s | Embedded: %s", texture->width, texture->height, texture->path.data(),
+                 ai_embedded_tex != nullptr ? "Yes" : "No");
+    }
+
+    return texture;
+}
+
+std::shared_ptr<Texture> Renderer::make_texture(int width, int height, unsigned char* pixels, const std::string& path) const {
     std::shared_ptr<Texture> texture = nullptr;
     switch (GEngine->get_config().get_renderer_device().backend) {
         case Backend::GL_COMPATIBILITY:
@@ -85,6 +100,9 @@ std::shared_ptr<Texture> Renderer::load_texture(const std::string& name, const s
         case Backend::AUTO:
             texture = std::make_shared<SDLTexture>();
             break;
+        case Backend::NONE:
+            texture = std::make_shared<NullTexture>();
+            break;
         case Backend::VK_FORWARD:
             LOG_ERROR("Vulkan texture loading not implemented yet");
             break;
@@ -99,6 +117,10 @@ std::shared_ptr<Texture> Renderer::load_texture(const std::string& name, const s
             break;
     }
 
+    if (!texture) {
+        return nullptr;
+    }
+
     constexpr int BYTES_PER_PIXEL = 4;
 
     texture->width = width;
@@ -107,16 +129,331 @@ std::shared_ptr<Texture> Renderer::load_texture(const std::string& name, const s
     texture->pitch = width * BYTES_PER_PIXEL;
     texture->pixels = pixels; // THIS: MUST be freed after uploading to GPU
 
-    LOG_INFO("Texture Info: Size %dx%d | Path: %s | Embedded: %s",
-             texture->width, texture->height, texture->path.data(),
-             ai_embedded_tex != nullptr ? "Yes" : "No");
+    return texture;
+}
+
+std::shared_ptr<Texture> Renderer::upload_texture(const std::string& name, std::shared_ptr<Texture> texture) {
+    free(texture->pixels);
+    texture->pixels = nullptr;
 
+    _textures[name] = texture;
     return texture;
 }
 
+std::shared_ptr<Texture> Renderer::create_texture(const std::string& name, int width, int height, unsigned char* pixels) {
+    if (const auto it = _textures.find(name); it != _textures.end()) {
+        free(pixels);
+        return it->second;
+    }
+
+    auto texture = make_texture(width, height, pixels, "");
+
+    if (!texture) {
+        free(pixels);
+        return nullptr;
+    }
+
+    return upload_texture(name, texture);
+}
+
+TextureAtlas& Renderer::get_texture_atlas() {
+    return _texture_atlas;
+}
+
+void Renderer::set_stage_count(int count) {
+    _stages.resize(SDL_max(count, 1));
+}
+
+RenderStage* Renderer::get_stage(int stage) {
+    if (stage < 0 || stage >= static_cast<int>(_stages.size())) {
+        LOG_ERROR("Render stage %d out of [0, %zu), see Renderer::set_stage_count", stage, _stages.size());
+        return nullptr;
+    }
+
+    return &_stages[stage];
+}
+
+Sint32 Renderer::add_bone_palette(RenderStage& stage, const Model* model, const glm::mat4* bone_transforms, int bone_count) {
+    // Bone indices are per mesh, the palette only needs the longest skeleton
+    int used = 0;
+
+    for (const auto& mesh : model->meshes) {
+        if (mesh && mesh->has_bones) {
+            used = SDL_max(used, static_cast<int>(mesh->bones.size()));
+        }
+    }
+
+    used = SDL_min(SDL_min(used, bone_count), MAX_BONES);
+
+    const Sint32 first = static_cast<Sint32>(stage.bone_palette.size() / 3);
+
+    for (int bone = 0; bone < used; bone++) {
+        const glm::mat4& m = bone_transforms[bone];
+
+        // Affine: the last row is always (0, 0, 0, 1) and is not stored
+        for (int row = 0; row < 3; row++) {
+            stage.bone_palette.emplace_back(m[0][row], m[1][row], m[2][row], m[3][row]);
+        }
+    }
+
+    return first;
+}
+
+InstancedBatch& Renderer::add_instance(RenderStage& stage, Mesh* mesh, const glm::mat4& model, const glm::vec3& color, Sint32 bone_offset,
+                                       Uint8 passes) {
+    if (!(passes & RENDER_PASS_SHADOW)) {
+        passes &= ~RENDER_PASS_STATIC;
+    }
+
+    InstancedBatch& batch = stage.batches[mesh];
+    batch.mesh            = mesh;
+    batch.models.push_back(model);
+    batch.colors.push_back(color);
+
+    // Offsets are only stored once a skinned instance joins the batch
+    if (bone_offset >= 0 || !batch.bone_offsets.empty()) {
+        batch.bone_offsets.resize(batch.models.size() - 1, -1);
+        batch.bone_offsets.push_back(bone_offset);
+    }
+
+    // Same for the passes, once an instance is culled from one of them
+    if (passes != RENDER_PASS_ALL || !batch.passes.empty()) {
+        batch.passes.resize(batch.models.size() - 1, RENDER_PASS_ALL);
+        batch.passes.push_back(passes);
+    }
+
+    return batch;
+}
+
+void Renderer::merge_stages() {
+    _static_caster_signature = 0;
+
+    for (RenderStage& stage : _stages) {
+        _static_caster_signature += stage.static_signature;
+
+        // Offsets of the stage start at 0, they follow the palettes of the stages before it
+        const Sint32 bone_base = static_cast<Sint32>(_bone_palette.size() / 3);
+        _bone_palette.insert(_bone_palette.end(), stage.bone_palette.begin(), stage.bone_palette.end());
+
+        for (auto& [mesh, staged] : stage.batches) {
+            InstancedBatch& batch = _instanced_batches[mesh];
+
+            // First stage of the mesh, taken as is (the common single stage case)
+            if (batch.models.empty()) {
+                for (Sint32& offset : staged.bone_offsets) {
+                    offset = offset >= 0 ? offset + bone_base : offset;
+                }
+
+                batch = std::move(staged);
+                continue;
+            }
+
+            const size_t count = batch.models.size();
+
+            // The lazy vectors are filled up to the merged instances once either side has them
+            if (!staged.bone_offsets.empty() || !batch.bone_offsets.empty()) {
+                batch.bone_offsets.resize(count, -1);
+
+                for (size_t i = 0; i < staged.models.size(); i++) {
+                    const Sint32 offset = i < staged.bone_offsets.size() ? staged.bone_offsets[i] : -1;
+                    batch.bone_offsets.push_back(offset >= 0 ? offset + bone_base : -1);
+                }
+            }
+
+            if (!staged.passes.empty() || !batch.passes.empty()) {
+                batch.passes.resize(count, RENDER_PASS_ALL);
+                staged.passes.resize(staged.models.size(), RENDER_PASS_ALL);
+                batch.passes.insert(batch.passes.end(), staged.passes.begin(), staged.passes.end());
+            }
+
+            batch.models.insert(batch.models.end(), staged.models.begin(), staged.models.end());
+            batch.colors.insert(batch.colors.end(), staged.colors.begin(), staged.colors.end());
+        }
+
+        stage.clear();
+    }
+}
+
+void Renderer::clear_stages() {
+    for (RenderStage& stage : _stages) {
+        stage.clear();
+    }
+
+    _instanced_batches.clear();
+    _bone_palette.clear();
+    _static_caster_signature = 0;
+}
+
+void Renderer::add_static_caster(RenderStage& stage, const void* source, const glm::mat4& matrix) {
+    // FNV-1a of the source and its matrix
+    Uint64 hash = 14695981039346656037ull;
+
+    const auto mix = [&hash](const void* data, size_t size) {
+        const Uint8* bytes = static_cast<const Uint8*>(data);
+
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    mix(&source, sizeof(source));
+    mix(glm::value_ptr(matrix), sizeof(glm::mat4));
+
+    stage.static_signature += hash;
+}
+
+void Renderer::set_view_3d(const glm::mat4& view, const glm::mat4& projection) {
+    _view_frustum_3d.set_matrix(projection * view);
+
+    // Light direction: vector pointing FROM scene UP TO the sun
+    const glm::vec3 to_light = glm::normalize(glm::vec3(1.0f, 2.5f, 1.0f));
+
+    _light_direction_3d = -to_light;
+
+    _shadow_cascades.fit(view, projection, to_light, GEngine->get_config().get_shadows());
+    _light_frustum_3d.set_matrix(_shadow_cascades.caster_matrix);
+}
+
+bool Renderer::is_box_visible_3d(const glm::vec3& min, const glm::vec3& max) const {
+    return _view_frustum_3d.is_box_visible(min, max);
+}
+
+namespace {
+    /// Largest scale of the linear part of `matrix`, grows the radius of the bounding spheres
+    float get_max_scale(const glm::mat4& matrix) {
+        const float x = glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0]));
+        const float y = glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1]));
+        const float z = glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]));
+
+        return SDL_sqrtf(SDL_max(x, SDL_max(y, z)));
+    }
+
+    // Poses sampled per second of a clip for its bounds, and the cap for very long clips
+    constexpr float ANIMATION_BOUNDS_RATE       = 30.0f;
+    constexpr int ANIMATION_BOUNDS_MAX_SAMPLES = 256;
+
+    /// Box swept by the skinned meshes of `model` over the whole `animation`, in model space
+    BoundingBox get_animation_bounds(const Model& model, const aiAnimation* animation) {
+        BoundingBox bounds;
+
+        const float duration         = static_cast<float>(animation->mDuration);
+        const float ticks_per_second = static_cast<float>(animation->mTicksPerSecond != 0 ? animation->mTicksPerSecond : 25.0f);
+        const int samples = SDL_clamp(static_cast<int>(SDL_ceilf(duration / ticks_per_second * ANIMATION_BOUNDS_RATE)) + 1, 2,
+                                      ANIMATION_BOUNDS_MAX_SAMPLES);
+
+        std::unordered_map<std::string, glm::mat4> node_transforms;
+
+        for (int sample = 0; sample < samples; sample++) {
+            const float time = duration * static_cast<float>(sample) / static_cast<float>(samples - 1);
+
+            node_transforms.clear();
+            read_node_hierarchy(time, model.scene->mRootNode, glm::mat4(1.0f), animation, model, node_transforms);
+
+            for (const auto& mesh : model.meshes) {
+                if (!mesh || !mesh->has_bones) {
+                    continue;
+                }
+
+                bounds.merge(mesh->unskinned_bounds);
+
+                // A skinned vertex is a blend of its bones, so it stays inside the union of their moved boxes
+                for (const Bone& bone : mesh->bones) {
+                    const auto it = node_transforms.find(bone.name);
+
+                    if (it != node_transforms.end()) {
+                        bounds.merge(bone.bounds.transformed(model.global_inverse_transform * it->second * bone.offset_matrix));
+                    } else {
+                        bounds.merge(bone.bounds);
+                    }
+                }
+            }
+        }
+
+        return bounds;
+    }
+} // namespace
+
+Uint8 Renderer::get_visible_passes(const BoundingBox& bounds, const glm::mat4& matrix) const {
+    if (!bounds.is_valid()) {
+        return RENDER_PASS_ALL;
+    }
+
+    const glm::vec3 center = glm::vec3(matrix * glm::vec4(bounds.get_center(), 1.0f));
+    const float radius     = glm::length(bounds.get_extents()) * get_max_scale(matrix);
+
+    Uint8 passes = 0;
+
+    if (_view_frustum_3d.is_sphere_visible(center, radius)) {
+        passes |= RENDER_PASS_MAIN;
+    }
+
+    if (_light_frustum_3d.is_sphere_visible(center, radius)) {
+        passes |= RENDER_PASS_SHADOW;
+    }
+
+    return passes;
+}
+
+Uint8 Renderer::cull_meshes(const Model* model, const glm::mat4& matrix, Uint8* passes) const {
+    const size_t count = model->meshes.size();
+    const Uint8 model_passes = get_visible_passes(model->bounds, matrix);
+
+    if (model_passes == 0 || count <= 1) {
+        SDL_memset(passes, model_passes, count);
+        return model_passes;
+    }
+
+    // Called from the submit systems, each worker has its own streams
+    thread_local std::vector<float> streams;
+    streams.resize(count * 4);
+
+    float* x      = streams.data();
+    float* y      = x + count;
+    float* z      = y + count;
+    float* radius = z + count;
+
+    const float scale = get_max_scale(matrix);
+
+    for (size_t i = 0; i < count; i++) {
+        const Mesh* mesh = model->meshes[i].get();
+
+        if (!mesh || !mesh->bounds.is_valid()) {
+            x[i] = y[i] = z[i] = 0.0f;
+            radius[i]          = FLT_MAX;
+            continue;
+        }
+
+        const glm::vec3 center = glm::vec3(matrix * glm::vec4(mesh->bounds.get_center(), 1.0f));
+
+        x[i]      = center.x;
+        y[i]      = center.y;
+        z[i]      = center.z;
+        radius[i] = glm::length(mesh->bounds.get_extents()) * scale;
+    }
+
+    SDL_memset(passes, 0, count);
+
+    if (model_passes & RENDER_PASS_MAIN) {
+        _view_frustum_3d.cull_spheres(x, y, z, radius, count, RENDER_PASS_MAIN, passes);
+    }
+
+    if (model_passes & RENDER_PASS_SHADOW) {
+        _light_frustum_3d.cull_spheres(x, y, z, radius, count, RENDER_PASS_SHADOW, passes);
+    }
+
+    Uint8 visible = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        visible |= passes[i];
+    }
+
+    return visible;
+}
+
 
 
 std::shared_ptr<Model> Renderer::load_model(const char* path) {
+    PROFILE_SCOPE("Renderer::load_model");
 
     std::string path_str = path;
 
@@ -146,7 +483,9 @@ std::shared_ptr<Model> Renderer::load_model(const char* path) {
 
     std::string filename = (last_slash != std::string::npos) ? path_str.substr(last_slash + 1) : path_str;
 
+    PROFILE_BEGIN("Assimp::ReadFile");
     const aiScene* scene = importer->ReadFile(filename, ASSIMP_FLAGS);
+    PROFILE_END();
 
     if (!scene || !scene->mRootNode) {
         LOG_ERROR("Failed to load Model: %s, Error: %s", path, importer->GetErrorString());
@@ -180,11 +519,20 @@ std::shared_ptr<Model> Renderer::load_model(const char* path) {
     for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
         LOG_DEBUG("Loading Mesh %d/%d  Name: %s", i + 1, scene->mNumMeshes, scene->mMeshes[i]->mName.C_Str());
         model->meshes.push_back(load_mesh(scene->mMeshes[i], scene, base_dir));
+
+        if (model->meshes.back()) {
+            model->bounds.merge(model->meshes.back()->bounds);
+        }
     }
 
 
     if (scene->HasAnimations()) {
+        PROFILE_SCOPE("Renderer::animation_bounds");
 
+        // Culls a playing model with the box of its clip, computed once here rather than skinning it every frame
+        for (unsigned int i = 0; i < scene->mNumAnimations; i++) {
+            model->animation_bounds.push_back(get_animation_bounds(*model, scene->mAnimations[i]));
+        }
 
         LOG_INFO("Loaded Model: %s | Meshes: %zu | Animations: %u | Format: %s", path, model->meshes.size(), scene->mNumAnimations,
                  ext.c_str());
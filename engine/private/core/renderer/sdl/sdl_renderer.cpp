@@ -1,6 +1,7 @@
 #include "core/renderer/sdl/sdl_renderer.h"
 
 #include "core/engine.h"
+#include "core/renderer/shape_tessellation.h"
 
 
 bool SDLRenderer::initialize(SDL_Window* window) {
@@ -25,6 +26,8 @@ bool SDLRenderer::initialize(SDL_Window* window) {
     LOG_INFO("Using backend: %s, Viewport: %dx%d", renderer_name, viewport.width, viewport.height);
     SDL_SetRenderLogicalPresentation(_renderer, viewport.width, viewport.height, SDL_LOGICAL_PRESENTATION_STRETCH);
 
+    set_vsync(GEngine->get_config().get_vsync_mode());
+
     // SDL_SetRenderDrawBlendMode(_renderer, SDL_BLENDMODE_BLEND);
 
     return true;
@@ -33,138 +36,188 @@ bool SDLRenderer::initialize(SDL_Window* window) {
 
 void SDLRenderer::clear(glm::vec4 color) {
 
+    _batch_count = 0;
 
     SDL_SetRenderDrawColor(_renderer, (Uint8) (color.r * 255), (Uint8) (color.g * 255), (Uint8) (color.b * 255), (Uint8) (color.a * 255));
     SDL_RenderClear(_renderer);
 }
 
 void SDLRenderer::flush(const glm::mat4& view, const glm::mat4& projection) {
-    // TODO: flush geometry
+    flush_batch();
 }
 
 void SDLRenderer::present() {
 
+    flush_batch();
+    _last_frame_batch_count = _batch_count;
+
+    advance_text_frame();
+
     SDL_RenderPresent(_renderer);
 }
 
+void SDLRenderer::flush_batch() {
+    if (_batch.indices.empty()) {
+        return;
+    }
+
+    // Untextured geometry is blended with the renderer draw mode, textured geometry with the texture's own
+    if (!_batch.texture) {
+        SDL_SetRenderDrawBlendMode(_renderer, _batch.blend_mode);
+    }
 
-void SDLRenderer::draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) {
-    va_list args;
-    va_start(args, fmt);
-    std::string text = vformat(fmt, args);
-    va_end(args);
+    SDL_RenderGeometry(_renderer, _batch.texture, _batch.vertices.data(), static_cast<int>(_batch.vertices.size()), _batch.indices.data(),
+                       static_cast<int>(_batch.indices.size()));
 
-    draw_text_internal(transform.world_position, color, font_name, text);
+    _batch.vertices.clear();
+    _batch.indices.clear();
+    _batch_count++;
 }
 
-void SDLRenderer::draw_line(const Transform2D& transform, glm::vec2 end, glm::vec4 color) {
+void SDLRenderer::set_view_2d(const glm::mat4& view) {
+    Renderer::set_view_2d(view);
 
-    SDL_SetRenderDrawColorFloat(_renderer, color.r, color.g, color.b, color.a);
+    _view_linear      = glm::mat2(glm::vec2(view[0]), glm::vec2(view[1]));
+    _view_translation = glm::vec2(view[3]);
+    _view_scale       = SDL_sqrtf(SDL_fabsf(glm::determinant(_view_linear)));
+    _is_view_identity = _view_linear == glm::mat2(1.0f) && _view_translation == glm::vec2(0.0f);
+}
 
-    glm::vec2 start = transform.position;
+SDL_FPoint SDLRenderer::to_screen(SDL_FPoint point) const {
+    if (_is_view_identity) {
+        return point;
+    }
 
-    float cosr = cos(transform.rotation);
-    float sinr = sin(transform.rotation);
+    const glm::vec2 screen = _view_linear * glm::vec2(point.x, point.y) + _view_translation;
+    return {screen.x, screen.y};
+}
 
-    float x = end.x * transform.scale.x;
-    float y = end.y * transform.scale.y;
+void SDLRenderer::push_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count,
+                                bool is_screen_space) {
+    SDL_BlendMode blend_mode = SDL_BLENDMODE_NONE;
 
-    float rx = x * cosr - y * sinr;
-    float ry = x * sinr + y * cosr;
+    if (texture) {
+        SDL_GetTextureBlendMode(texture, &blend_mode);
+    } else {
+        SDL_GetRenderDrawBlendMode(_renderer, &blend_mode);
+    }
 
-    glm::vec2 final_pos = {transform.position.x + rx, transform.position.y + ry};
+    // Only consecutive submissions are merged, so the z order of the caller is kept
+    if (texture != _batch.texture || blend_mode != _batch.blend_mode) {
+        flush_batch();
+        _batch.texture    = texture;
+        _batch.blend_mode = blend_mode;
+    }
+
+    const int base = static_cast<int>(_batch.vertices.size());
+
+    _batch.vertices.insert(_batch.vertices.end(), vertices, vertices + vertex_count);
+
+    if (!is_screen_space && !_is_view_identity) {
+        for (size_t i = static_cast<size_t>(base); i < _batch.vertices.size(); i++) {
+            _batch.vertices[i].position = to_screen(_batch.vertices[i].position);
+        }
+    }
 
-    SDL_RenderLine(_renderer, start.x, start.y, final_pos.x, final_pos.y);
+    for (int i = 0; i < index_count; i++) {
+        _batch.indices.push_back(base + indices[i]);
+    }
 }
 
-void SDLRenderer::draw_rect(const Transform2D& transform, float w, float h, glm::vec4 color, bool is_filled) {
+int SDLRenderer::get_batch_count() const {
+    return _last_frame_batch_count;
+}
 
 
-    if (SDL_abs(transform.rotation) < 0.001f) {
-        SDL_FRect rect = {transform.position.x - (w * transform.scale.x) / 2.0f, transform.position.y - (h * transform.scale.y) / 2.0f,
-                          w * transform.scale.x, h * transform.scale.y};
+bool SDLRenderer::set_vsync(VSyncMode mode) {
 
-        if (is_filled) {
-            SDL_RenderFillRect(_renderer, &rect);
-        } else {
-            SDL_RenderRect(_renderer, &rect);
-        }
-    } else {
-        float hw = (w * transform.scale.x) / 2.0f;
-        float hh = (h * transform.scale.y) / 2.0f;
-
-        std::vector<glm::vec2> corners = {
-            {-hw, -hh}, // Top-left
-            {hw, -hh}, // Top-right
-            {hw, hh}, // Bottom-right
-            {-hw, hh} // Bottom-left
-        };
-
-        float cosr = cos(transform.rotation);
-        float sinr = sin(transform.rotation);
-        std::vector<SDL_FPoint> pts;
-
-        for (const auto& corner : corners) {
-            float rx = corner.x * cosr - corner.y * sinr;
-            float ry = corner.x * sinr + corner.y * cosr;
-            pts.push_back({transform.position.x + rx, transform.position.y + ry});
+    if (mode == VSyncMode::ADAPTIVE) {
+        if (SDL_SetRenderVSync(_renderer, SDL_RENDERER_VSYNC_ADAPTIVE)) {
+            LOG_INFO("VSync: Adaptive");
+            return true;
         }
 
-        if (is_filled) {
-            SDL_Vertex vertices[4];
-            for (int i = 0; i < 4; ++i) {
-                vertices[i].position  = pts[i];
-                vertices[i].color     = SDL_FColor{color.r, color.g, color.b, color.a};
-                vertices[i].tex_coord = {0.0f, 0.0f};
-            }
-
-            int indices[] = {0, 1, 2, 0, 2, 3};
-            SDL_RenderGeometry(_renderer, nullptr, vertices, 4, indices, 6);
-        } else {
-
-            SDL_SetRenderDrawColorFloat(_renderer, color.r, color.g, color.b, color.a);
-            pts.push_back(pts[0]);
-            SDL_RenderLines(_renderer, pts.data(), pts.size());
-        }
+        LOG_WARN("Adaptive VSync not supported, falling back to VSync, %s", SDL_GetError());
+        mode = VSyncMode::ENABLED;
     }
+
+    const int interval = mode == VSyncMode::ENABLED ? 1 : SDL_RENDERER_VSYNC_DISABLED;
+
+    if (!SDL_SetRenderVSync(_renderer, interval)) {
+        LOG_ERROR("Failed to set render vsync %d, %s", interval, SDL_GetError());
+        return false;
+    }
+
+    LOG_INFO("VSync: %s", interval == 1 ? "Enabled" : "Disabled");
+    return true;
 }
 
-void SDLRenderer::draw_triangle(const Transform2D& transform, float size, glm::vec4 color, bool is_filled) {
 
+namespace {
 
-    const float height                     = sqrt(3.0f) / 2.0f * size;
-    std::vector<glm::vec2> triangle_points = {
-        {0.0f, -height / 2.0f}, // Top vertex
-        {-size / 2.0f, height / 2.0f}, // Bottom left
-        {size / 2.0f, height / 2.0f} // Bottom right
-    };
+    /// Local point -> world, scaled then rotated by the world transform
+    SDL_FPoint to_world(const Transform2D& transform, glm::vec2 point, float cosr, float sinr) {
+        const float x = point.x * transform.world_scale.x;
+        const float y = point.y * transform.world_scale.y;
+        return {transform.world_position.x + x * cosr - y * sinr, transform.world_position.y + x * sinr + y * cosr};
+    }
+
+    SDL_Vertex make_vertex(SDL_FPoint position, glm::vec4 color, SDL_FPoint tex_coord = {0.0f, 0.0f}) {
+        return {position, SDL_FColor{color.r, color.g, color.b, color.a}, tex_coord};
+    }
 
-    float cosr = cos(transform.rotation);
-    float sinr = sin(transform.rotation);
-    std::vector<SDL_FPoint> pts;
+} // namespace
 
-    for (const auto& point : triangle_points) {
-        float x  = point.x * transform.scale.x;
-        float y  = point.y * transform.scale.y;
-        float rx = x * cosr - y * sinr;
-        float ry = x * sinr + y * cosr;
-        pts.push_back({transform.position.x + rx, transform.position.y + ry});
+void SDLRenderer::draw_line(const Transform2D& transform, glm::vec2 end, glm::vec4 color) {
+    flush_batch();
+
+    SDL_SetRenderDrawColorFloat(_renderer, color.r, color.g, color.b, color.a);
+
+    const SDL_FPoint from = to_screen({transform.world_position.x, transform.world_position.y});
+    const SDL_FPoint to   = to_screen(to_world(transform, end, SDL_cosf(transform.world_rotation), SDL_sinf(transform.world_rotation)));
+
+    SDL_RenderLine(_renderer, from.x, from.y, to.x, to.y);
+}
+
+void SDLRenderer::draw_rect(const Transform2D& transform, float w, float h, glm::vec4 color, bool is_filled) {
+    const float hw   = w / 2.0f;
+    const float hh   = h / 2.0f;
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    SDL_FPoint pts[4];
+    pts[0] = to_world(transform, {-hw, -hh}, cosr, sinr); // Top-left
+    pts[1] = to_world(transform, {hw, -hh}, cosr, sinr); // Top-right
+    pts[2] = to_world(transform, {hw, hh}, cosr, sinr); // Bottom-right
+    pts[3] = to_world(transform, {-hw, hh}, cosr, sinr); // Bottom-left
+
+    if (is_filled) {
+        const SDL_Vertex vertices[4] = {make_vertex(pts[0], color), make_vertex(pts[1], color), make_vertex(pts[2], color), make_vertex(pts[3], color)};
+        constexpr int indices[]      = {0, 1, 2, 0, 2, 3};
+
+        push_geometry(nullptr, vertices, 4, indices, 6);
+    } else {
+        push_outline(pts, 4, color);
     }
+}
+
+void SDLRenderer::draw_triangle(const Transform2D& transform, float size, glm::vec4 color, bool is_filled) {
+    const float height = SDL_sqrtf(3.0f) / 2.0f * size;
+    const float cosr   = SDL_cosf(transform.world_rotation);
+    const float sinr   = SDL_sinf(transform.world_rotation);
+
+    SDL_FPoint pts[3];
+    pts[0] = to_world(transform, {0.0f, -height / 2.0f}, cosr, sinr); // Top vertex
+    pts[1] = to_world(transform, {-size / 2.0f, height / 2.0f}, cosr, sinr); // Bottom left
+    pts[2] = to_world(transform, {size / 2.0f, height / 2.0f}, cosr, sinr); // Bottom right
 
     if (is_filled) {
-        SDL_Vertex vertices[3];
-        for (int i = 0; i < 3; ++i) {
-            vertices[i].position  = pts[i];
-            vertices[i].color     = SDL_FColor{color.r, color.g, color.b, color.a};
-            vertices[i].tex_coord = {0.0f, 0.0f};
-        }
+        const SDL_Vertex vertices[3] = {make_vertex(pts[0], color), make_vertex(pts[1], color), make_vertex(pts[2], color)};
+        constexpr int indices[]      = {0, 1, 2};
 
-        int indices[] = {0, 1, 2};
-        SDL_RenderGeometry(_renderer, nullptr, vertices, 3, indices, 3);
+        push_geometry(nullptr, vertices, 3, indices, 3);
     } else {
-        SDL_SetRenderDrawColorFloat(_renderer, color.r, color.g, color.b, color.a);
-        pts.push_back(pts[0]);
-        SDL_RenderLines(_renderer, pts.data(), pts.size());
+        push_outline(pts, 3, color);
     }
 }
 
@@ -174,70 +227,114 @@ void SDLRenderer::draw_polygon(const Transform2D& transform, const std::vector<g
         return;
     }
 
+    if (is_filled) {
+        // Uncached, Shape2D polygons go through draw_polygon_triangles with their stored triangulation
+        triangulate_polygon(points, _scratch_triangles);
+        draw_polygon_triangles(transform, points, _scratch_triangles, color);
+        return;
+    }
+
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    _scratch_points.clear();
 
-    std::vector<SDL_FPoint> pts;
-    for (const auto& v : points) {
-        float cosr = cos(transform.rotation), sinr = sin(transform.rotation);
-        float x    = v.x * transform.scale.x, y    = v.y * transform.scale.y;
-        float rx   = x * cosr - y * sinr, ry       = x * sinr + y * cosr;
-        pts.push_back({transform.position.x + rx, transform.position.y + ry});
+    for (const auto& point : points) {
+        _scratch_points.push_back(to_world(transform, point, cosr, sinr));
     }
 
-    if (is_filled) {
+    push_outline(_scratch_points.data(), static_cast<int>(_scratch_points.size()), color);
+}
+
+void SDLRenderer::draw_polygon_triangles(const Transform2D& transform, const std::vector<glm::vec2>& points, const std::vector<int>& triangles,
+                                         glm::vec4 color) {
+    if (triangles.empty()) {
+        return;
+    }
+
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
 
-        if (pts.size() >= 3) {
-            std::vector<SDL_Vertex> vertices;
-            std::vector<int> indices;
-
-            for (size_t i = 0; i < pts.size(); ++i) {
-                SDL_Vertex vertex;
-                vertex.position  = pts[i];
-                vertex.color     = SDL_FColor{color.r, color.g, color.b, color.a};
-                vertex.tex_coord = {0.0f, 0.0f};
-                vertices.push_back(vertex);
-            }
-
-            for (size_t i = 1; i < pts.size() - 1; ++i) {
-                indices.push_back(0);
-                indices.push_back(i);
-                indices.push_back(i + 1);
-            }
-
-            SDL_RenderGeometry(_renderer, nullptr, vertices.data(), vertices.size(), indices.data(), indices.size());
+    _scratch_vertices.clear();
+
+    for (const auto& point : points) {
+        _scratch_vertices.push_back(make_vertex(to_world(transform, point, cosr, sinr), color));
+    }
+
+    push_geometry(nullptr, _scratch_vertices.data(), static_cast<int>(_scratch_vertices.size()), triangles.data(), static_cast<int>(triangles.size()));
+}
+
+void SDLRenderer::draw_texture_quads(const Transform2D& transform, Texture* texture, const std::vector<glm::vec2>& positions,
+                                     const std::vector<glm::vec2>& uvs, const glm::vec4& color) {
+    SDLTexture* sdl_tex = static_cast<SDLTexture*>(texture);
+
+    const size_t quad_count = SDL_min(positions.size(), uvs.size()) / 4;
+
+    if (!sdl_tex || !sdl_tex->get_texture() || quad_count == 0) {
+        return;
+    }
+
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    _scratch_vertices.clear();
+
+    for (size_t i = 0; i < quad_count * 4; i++) {
+        _scratch_vertices.push_back(make_vertex(to_world(transform, positions[i], cosr, sinr), color, {uvs[i].x, uvs[i].y}));
+    }
+
+    push_geometry(sdl_tex->get_texture(), _scratch_vertices.data(), static_cast<int>(_scratch_vertices.size()), get_quad_indices(quad_count).data(),
+                  static_cast<int>(quad_count * 6));
+}
+
+void SDLRenderer::draw_particles_2d(const ParticlePool& pool, Texture* texture, const glm::vec4& uv, float size) {
+    SDLTexture* sdl_tex      = static_cast<SDLTexture*>(texture);
+    SDL_Texture* sdl_texture = sdl_tex ? sdl_tex->get_texture() : nullptr;
+
+    const size_t count = pool.size();
+
+    if (count == 0) {
+        return;
+    }
+
+    const float* x = pool.get_stream(ParticlePool::POSITION_X);
+    const float* y = pool.get_stream(ParticlePool::POSITION_Y);
+    const float* r = pool.get_stream(ParticlePool::COLOR_R);
+    const float* g = pool.get_stream(ParticlePool::COLOR_G);
+    const float* b = pool.get_stream(ParticlePool::COLOR_B);
+    const float* a = pool.get_stream(ParticlePool::COLOR_A);
+
+    const float half = size * 0.5f;
+
+    const SDL_FPoint corner_uvs[4] = {{uv.x, uv.y}, {uv.x + uv.z, uv.y}, {uv.x + uv.z, uv.y + uv.w}, {uv.x, uv.y + uv.w}};
+    const glm::vec2 offsets[4]     = {{-half, -half}, {half, -half}, {half, half}, {-half, half}};
+
+    _scratch_vertices.resize(count * 4);
+
+    for (size_t i = 0; i < count; i++) {
+        const SDL_FColor color = {r[i], g[i], b[i], a[i]};
+
+        for (int corner = 0; corner < 4; corner++) {
+            _scratch_vertices[i * 4 + corner] = {{x[i] + offsets[corner].x, y[i] + offsets[corner].y}, color, corner_uvs[corner]};
         }
-    } else {
-        SDL_SetRenderDrawColorFloat(_renderer, color.r, color.g, color.b, color.a);
-        pts.push_back(pts.front());
-        SDL_RenderLines(_renderer, pts.data(), pts.size());
     }
+
+    // Untextured particles fade out too, they take the blend mode a texture would have
+    SDL_BlendMode draw_blend_mode = SDL_BLENDMODE_NONE;
+    SDL_GetRenderDrawBlendMode(_renderer, &draw_blend_mode);
+    SDL_SetRenderDrawBlendMode(_renderer, SDL_BLENDMODE_BLEND);
+
+    push_geometry(sdl_texture, _scratch_vertices.data(), static_cast<int>(_scratch_vertices.size()), get_quad_indices(count).data(),
+                  static_cast<int>(count * 6));
+
+    SDL_SetRenderDrawBlendMode(_renderer, draw_blend_mode);
 }
 
 std::vector<Tokens> SDLRenderer::parse_text(const std::string& text) {
     std::vector<Tokens> segments;
-    auto cps = utf8_to_utf32(text);
-    if (cps.empty()) {
-        return segments;
-    }
-
-    std::string current;
-    bool current_emoji = is_character_emoji(cps[0]);
-
-    for (auto cp : cps) {
-        bool is_e     = is_character_emoji(cp);
-        std::string s = utf32_to_utf8(cp);
-        if (is_e != current_emoji) {
-            if (!current.empty()) {
-                segments.push_back({current, current_emoji});
-            }
-            current       = s;
-            current_emoji = is_e;
-        } else {
-            current += s;
-        }
-    }
-    if (!current.empty()) {
-        segments.push_back({current, current_emoji});
-    }
+
+    for_each_text_run(text, [&](const TextRun& run) { segments.push_back({text.substr(run.offset, run.length), run.is_emoji}); });
+
     return segments;
 }
 
@@ -265,150 +362,195 @@ std::shared_ptr<Texture> SDLRenderer::load_texture(const std::string& name, cons
 
     auto texture = Renderer::load_texture(name, path, nullptr);
 
+    if (!texture) {
+        LOG_ERROR("Failed to load texture surface: %s", name.c_str());
+        return nullptr;
+    }
 
-    _textures[name] = texture;
-
-    free(texture->pixels);
-    texture->pixels = nullptr;
+    return upload_texture(name, texture);
+}
 
+std::shared_ptr<Texture> SDLRenderer::upload_texture(const std::string& name, std::shared_ptr<Texture> texture) {
+    // Decoded pixels are RGBA bytes
+    SDL_Texture* sdl_texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, texture->width, texture->height);
 
-    return texture;
-}
+    if (!sdl_texture || !SDL_UpdateTexture(sdl_texture, nullptr, texture->pixels, texture->pitch)) {
+        LOG_ERROR("Failed to upload texture %s: %s", name.c_str(), SDL_GetError());
 
-void SDLRenderer::draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name, const std::string& text) {
-    auto segments = parse_text(text);
-    float x       = pos.x;
-    float y       = pos.y;
-
-    for (auto& seg : segments) {
-        Font* font = nullptr;
-        if (!font_name.empty()) {
-            font = seg.is_emoji ? _fonts[font_name].get() : _fonts[font_name].get();
-        } else {
-            font = seg.is_emoji ? _fonts[_emoji_font_name].get() : _fonts[_default_font_name].get();
+        if (sdl_texture) {
+            SDL_DestroyTexture(sdl_texture);
         }
+        free(texture->pixels);
+        texture->pixels = nullptr;
+        return nullptr;
+    }
 
-        if (!font || !font->get_font()) {
-            continue;
-        }
+    const bool is_nearest = GEngine->get_config().get_renderer_device().texture_filtering == TextureFiltering::NEAREST;
 
-        SDL_Surface* surf = TTF_RenderText_Blended(font->get_font(), seg.text.c_str(), seg.text.size(),
-                                                   SDL_Color{static_cast<Uint8>(color.r * 255), static_cast<Uint8>(color.g * 255),
-                                                             static_cast<Uint8>(color.b * 255), static_cast<Uint8>(color.a * 255)});
+    SDL_SetTextureBlendMode(sdl_texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(sdl_texture, is_nearest ? SDL_SCALEMODE_NEAREST : SDL_SCALEMODE_LINEAR);
 
-        if (!surf) {
-            continue;
-        }
+    static_cast<SDLTexture*>(texture.get())->set_texture(sdl_texture);
 
-        SDL_Texture* tex = SDL_CreateTextureFromSurface(_renderer, surf);
+    return Renderer::upload_texture(name, texture);
+}
 
-        if (!tex) {
-            SDL_DestroySurface(surf);
-            continue;
-        }
+std::unique_ptr<Texture> SDLRenderer::create_glyph_page(int size) {
+    SDL_Texture* page = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size);
 
-        // SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);
+    if (!page) {
+        LOG_ERROR("Failed to create glyph page: %s", SDL_GetError());
+        return nullptr;
+    }
+
+    // Static textures start undefined, padding between glyphs must stay transparent
+    const std::vector<Uint32> transparent(static_cast<size_t>(size) * size, 0);
+    SDL_UpdateTexture(page, nullptr, transparent.data(), size * static_cast<int>(sizeof(Uint32)));
+    SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+
+    auto texture    = std::make_unique<SDLTexture>(page);
+    texture->width  = size;
+    texture->height = size;
+    return texture;
+}
 
-        SDL_FRect r{x, y, float(surf->w), float(surf->h)};
-        SDL_RenderTexture(_renderer, tex, nullptr, &r);
-        x += surf->w;
+void SDLRenderer::update_glyph_page(Texture* page, const SDL_Rect& rect, const void* pixels, int pitch) {
+    SDL_UpdateTexture(static_cast<SDLTexture*>(page)->get_texture(), &rect, pixels, pitch);
+}
+
+void SDLRenderer::push_glyph_quad(Texture* page, const glm::vec2* positions, const glm::vec2* uvs, const glm::vec4& color) {
+    constexpr int indices[] = {0, 1, 2, 0, 2, 3};
 
-        SDL_DestroySurface(surf);
-        SDL_DestroyTexture(tex);
+    SDL_Vertex vertices[4];
+    for (int i = 0; i < 4; i++) {
+        vertices[i] = make_vertex({positions[i].x, positions[i].y}, color, {uvs[i].x, uvs[i].y});
     }
+
+    push_geometry(static_cast<SDLTexture*>(page)->get_texture(), vertices, 4, indices, 6);
 }
 
 void SDLRenderer::draw_texture(const Transform2D& transform, Texture* texture, const glm::vec4& dest, const glm::vec4& source,
                                bool flip_h = false, bool flip_v = false, const glm::vec4& color = glm::vec4(1, 1, 1, 1)) {
 
+    // Every texture loaded by this renderer is an SDLTexture
+    SDLTexture* sdl_tex = static_cast<SDLTexture*>(texture);
 
-    if (!texture) {
+    if (!sdl_tex || !sdl_tex->get_texture() || sdl_tex->width <= 0 || sdl_tex->height <= 0) {
         return;
     }
 
-    SDLTexture* sdl_tex = dynamic_cast<SDLTexture*>(texture);
+    // Same placement as SDL_RenderTextureRotated: dest offset from the world position, rotated around its center
+    const float hw   = dest.z * transform.world_scale.x * 0.5f;
+    const float hh   = dest.w * transform.world_scale.y * 0.5f;
+    const float cx   = transform.world_position.x + dest.x + hw;
+    const float cy   = transform.world_position.y + dest.y + hh;
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
+
+    const auto corner = [&](float x, float y) { return SDL_FPoint{cx + x * cosr - y * sinr, cy + x * sinr + y * cosr}; };
 
-    if (!sdl_tex || !sdl_tex->get_texture()) {
+    float u0 = source.x / static_cast<float>(sdl_tex->width);
+    float v0 = source.y / static_cast<float>(sdl_tex->height);
+    float u1 = (source.x + source.z) / static_cast<float>(sdl_tex->width);
+    float v1 = (source.y + source.w) / static_cast<float>(sdl_tex->height);
 
+    if (flip_h) {
+        std::swap(u0, u1);
+    }
+    if (flip_v) {
+        std::swap(v0, v1);
+    }
+
+    // Tint is a vertex color, the texture color/alpha mods stay untouched so sprites can share a batch
+    const SDL_Vertex vertices[4] = {
+        make_vertex(corner(-hw, -hh), color, {u0, v0}),
+        make_vertex(corner(hw, -hh), color, {u1, v0}),
+        make_vertex(corner(hw, hh), color, {u1, v1}),
+        make_vertex(corner(-hw, hh), color, {u0, v1}),
+    };
+    constexpr int indices[] = {0, 1, 2, 0, 2, 3};
+
+    push_geometry(sdl_tex->get_texture(), vertices, 4, indices, 6);
+}
+
+
+void SDLRenderer::draw_circle(const Transform2D& transform, float radius, glm::vec4 color, bool is_filled) {
+    if (radius <= 0.0f) {
         return;
     }
 
-    SDL_FRect src_rect;
-    src_rect.x = source.x;
-    src_rect.y = source.y;
-    src_rect.w = source.z;
-    src_rect.h = source.w;
+    const float cosr = SDL_cosf(transform.world_rotation);
+    const float sinr = SDL_sinf(transform.world_rotation);
 
-    SDL_FRect dst_rect;
-    dst_rect.x = dest.x + transform.world_position.x;
-    dst_rect.y = dest.y + transform.world_position.y;
-    dst_rect.w = dest.z * transform.world_scale.x;
-    dst_rect.h = dest.w * transform.world_scale.y;
+    // The transform position is the top-left corner of the circle bounds
+    const SDL_FPoint center = to_world(transform, {radius, radius}, cosr, sinr);
 
-    SDL_SetTextureColorModFloat(sdl_tex->get_texture(), color.r, color.g, color.b);
-    SDL_SetTextureAlphaModFloat(sdl_tex->get_texture(), color.a);
+    const float scale_x = radius * transform.world_scale.x;
+    const float scale_y = radius * transform.world_scale.y;
 
-    SDL_FPoint center;
-    center.x = dst_rect.w * 0.5f;
-    center.y = dst_rect.h * 0.5f;
+    const auto& unit_circle = get_unit_circle(get_circle_segments(SDL_max(SDL_fabsf(scale_x), SDL_fabsf(scale_y)) * _view_scale));
+    const int segments      = static_cast<int>(unit_circle.size());
 
-    SDL_FlipMode flip = SDL_FLIP_NONE;
-    if (flip_h && flip_v) {
-        flip = (SDL_FlipMode) (SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL);
-    } else if (flip_h) {
-        flip = SDL_FLIP_HORIZONTAL;
-    } else if (flip_v) {
-        flip = SDL_FLIP_VERTICAL;
+    _scratch_points.clear();
+
+    for (const glm::vec2& point : unit_circle) {
+        const float x = point.x * scale_x;
+        const float y = point.y * scale_y;
+        _scratch_points.push_back({center.x + x * cosr - y * sinr, center.y + x * sinr + y * cosr});
     }
 
-    SDL_RenderTextureRotated(_renderer, sdl_tex->get_texture(), &src_rect, &dst_rect, transform.rotation, &center, flip);
-}
+    if (!is_filled) {
+        push_outline(_scratch_points.data(), segments, color);
+        return;
+    }
 
+    // Triangle fan around the center
+    _scratch_vertices.clear();
+    _scratch_indices.clear();
 
-void SDLRenderer::draw_circle(const Transform2D& transform, float radius, glm::vec4 color, bool is_filled) {
+    _scratch_vertices.push_back(make_vertex(center, color));
 
-    float cx = transform.position.x + radius * transform.scale.x;
-    float cy = transform.position.y + radius * transform.scale.y;
+    for (int i = 0; i < segments; i++) {
+        _scratch_vertices.push_back(make_vertex(_scratch_points[i], color));
 
-    if (is_filled) {
-        std::vector<SDL_FPoint> points;
-        int minX = (int) (cx - radius), maxX = (int) (cx + radius);
-        int minY = (int) (cy - radius), maxY = (int) (cy + radius);
-
-        for (int y = minY; y <= maxY; y++) {
-            for (int x = minX; x <= maxX; x++) {
-                float dx = (x - cx) / radius;
-                float dy = (y - cy) / radius;
-                if (dx * dx + dy * dy <= 1.0f) {
-                    points.push_back({(float) x, (float) y});
-                }
-            }
-        }
-
-        if (!points.empty()) {
-            SDL_RenderPoints(_renderer, points.data(), points.size());
-        }
+        _scratch_indices.push_back(0);
+        _scratch_indices.push_back(1 + i);
+        _scratch_indices.push_back(1 + (i + 1) % segments);
+    }
 
-    } else {
+    push_geometry(nullptr, _scratch_vertices.data(), static_cast<int>(_scratch_vertices.size()), _scratch_indices.data(),
+                  static_cast<int>(_scratch_indices.size()));
+}
 
-        SDL_SetRenderDrawColorFloat(_renderer, color.r, color.g, color.b, color.a);
+void SDLRenderer::push_outline(const SDL_FPoint* points, int count, glm::vec4 color) {
+    if (count < 2) {
+        return;
+    }
 
-        constexpr int segments = 64;
-        std::vector<SDL_FPoint> pts;
-        pts.reserve(segments + 1);
+    // Built in screen space, the width does not follow the zoom
+    _outline_points.clear();
+    for (int i = 0; i < count; i++) {
+        const SDL_FPoint point = to_screen(points[i]);
+        _outline_points.emplace_back(point.x, point.y);
+    }
 
-        for (int i = 0; i <= segments; i++) {
-            float a = (i / (float) segments) * 2.0f * glm::pi<float>();
-            pts.push_back({cx + cos(a) * radius, cy + sin(a) * radius});
-        }
+    build_outline(_outline_points.data(), _outline_points.size(), 1.0f, _outline_positions, _outline_indices);
 
-        SDL_RenderLines(_renderer, pts.data(), pts.size());
+    _outline_vertices.clear();
+    for (const glm::vec2& position : _outline_positions) {
+        _outline_vertices.push_back(make_vertex({position.x, position.y}, color));
     }
+
+    push_geometry(nullptr, _outline_vertices.data(), static_cast<int>(_outline_vertices.size()), _outline_indices.data(),
+                  static_cast<int>(_outline_indices.size()), true);
 }
 
 
 SDLRenderer::~SDLRenderer() {
 
+    // Glyph pages belong to the SDL renderer
+    clear_text_cache();
+
     if (_renderer) {
         SDL_DestroyRenderer(_renderer);
         _renderer = nullptr;
@@ -14,3 +14,10 @@ SDLTexture::~SDLTexture() {
 SDL_Texture* SDLTexture::get_texture() const {
     return _texture;
 }
+
+void SDLTexture::set_texture(SDL_Texture* texture) {
+    if (_texture && _texture != texture) {
+        SDL_DestroyTexture(_texture);
+    }
+    _texture = texture;
+}
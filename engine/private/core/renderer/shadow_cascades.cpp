@@ -0,0 +1,116 @@
+#include "core/renderer/shadow_cascades.h"
+
+#include "core/renderer/bounds.h"
+
+
+void ShadowCascades::fit(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& to_light, const Shadows& config) {
+    const glm::mat4 inverse = glm::inverse(projection * view);
+
+    // Corners of the near and far planes, the slices are cut along the 4 edges joining them
+    glm::vec3 near_corners[4];
+    glm::vec3 far_corners[4];
+
+    for (int i = 0; i < 4; i++) {
+        const float x = i & 1 ? 1.0f : -1.0f;
+        const float y = i & 2 ? 1.0f : -1.0f;
+
+        const glm::vec4 near_corner = inverse * glm::vec4(x, y, -1.0f, 1.0f);
+        const glm::vec4 far_corner  = inverse * glm::vec4(x, y, 1.0f, 1.0f);
+
+        near_corners[i] = glm::vec3(near_corner) / near_corner.w;
+        far_corners[i]  = glm::vec3(far_corner) / far_corner.w;
+    }
+
+    const float near_depth = -(view * glm::vec4(near_corners[0], 1.0f)).z;
+    const float far_depth  = -(view * glm::vec4(far_corners[0], 1.0f)).z;
+    const float depth      = far_depth - near_depth;
+
+    const float shadow_depth = SDL_clamp(config.distance, near_depth + 0.01f, far_depth);
+
+    // Rotation only, the cascades are placed by their projection so they all share it
+    const glm::vec3 up         = SDL_fabsf(to_light.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 light_view = glm::lookAt(glm::vec3(0.0f), -to_light, up);
+
+    count = SDL_clamp(config.cascade_count, 1, MAX_SHADOW_CASCADES);
+
+    BoundingBox caster_box;
+    float slice_near = near_depth;
+
+    for (int c = 0; c < count; c++) {
+        const float p         = static_cast<float>(c + 1) / static_cast<float>(count);
+        const float uniform   = near_depth + (shadow_depth - near_depth) * p;
+        const float logarithm = near_depth > 0.0f ? near_depth * SDL_powf(shadow_depth / near_depth, p) : uniform;
+        const float split     = c == count - 1 ? shadow_depth : glm::mix(uniform, logarithm, config.split_lambda);
+
+        const float t0 = (slice_near - near_depth) / depth;
+        const float t1 = (split - near_depth) / depth;
+
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+
+        for (int i = 0; i < 4; i++) {
+            corners[i]     = glm::mix(near_corners[i], far_corners[i], t0);
+            corners[i + 4] = glm::mix(near_corners[i], far_corners[i], t1);
+            center += corners[i] + corners[i + 4];
+        }
+
+        center /= 8.0f;
+
+        float radius = 0.0f;
+
+        for (const glm::vec3& corner : corners) {
+            radius = SDL_max(radius, glm::length(corner - center));
+        }
+
+        // A sphere does not change size when the camera turns, rounded so float noise does not either
+        radius = SDL_ceilf(radius * 16.0f) / 16.0f;
+
+        // Moved by whole texels only, a texel keeps covering the same world area from one frame to the next.
+        // The depth range too, so the matrix does not change at all for small moves (see `StaticShadowCache`)
+        const float texel = 2.0f * radius / static_cast<float>(config.resolution);
+        glm::vec3 origin  = glm::vec3(light_view * glm::vec4(center, 1.0f));
+        origin.x          = SDL_floorf(origin.x / texel) * texel;
+        origin.y          = SDL_floorf(origin.y / texel) * texel;
+        origin.z          = SDL_floorf(origin.z / texel) * texel;
+
+        // Light space looks down -z, the sun is towards +z
+        const glm::vec3 min = {origin.x - radius, origin.y - radius, origin.z - radius};
+        const glm::vec3 max = {origin.x + radius, origin.y + radius, origin.z + radius + SHADOW_CASTER_DISTANCE};
+
+        matrices[c] = glm::ortho(min.x, max.x, min.y, max.y, -max.z, -min.z) * light_view;
+        splits[c]   = split;
+
+        caster_box.expand(min);
+        caster_box.expand(max);
+
+        slice_near = split;
+    }
+
+    caster_matrix = glm::ortho(caster_box.min.x, caster_box.max.x, caster_box.min.y, caster_box.max.y, -caster_box.max.z, -caster_box.min.z)
+                  * light_view;
+}
+
+Uint32 StaticShadowCache::update(const ShadowCascades& cascades, Uint64 frame_signature) {
+    // Static casters added, removed or moved: any cascade may see them
+    if (frame_signature != signature) {
+        signature  = frame_signature;
+        valid_mask = 0;
+    }
+
+    Uint32 dirty = 0;
+
+    for (int c = 0; c < cascades.count; c++) {
+        const Uint32 bit = 1u << c;
+
+        if ((valid_mask & bit) && matrices[c] == cascades.matrices[c]) {
+            continue;
+        }
+
+        matrices[c] = cascades.matrices[c];
+        dirty |= bit;
+    }
+
+    valid_mask |= dirty;
+
+    return dirty;
+}
@@ -0,0 +1,200 @@
+#include "core/renderer/shape_tessellation.h"
+
+
+namespace {
+
+    float cross(glm::vec2 a, glm::vec2 b, glm::vec2 c) {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+
+    /// Inclusive of the edges, a vertex touching a candidate ear blocks it
+    bool is_inside_triangle(glm::vec2 p, glm::vec2 a, glm::vec2 b, glm::vec2 c) {
+        return cross(a, b, p) >= 0.0f && cross(b, c, p) >= 0.0f && cross(c, a, p) >= 0.0f;
+    }
+
+} // namespace
+
+
+int get_circle_segments(float screen_radius) {
+    if (!(screen_radius > CIRCLE_MAX_ERROR)) {
+        return CIRCLE_MIN_SEGMENTS;
+    }
+
+    // The sagitta of a segment spanning `angle` is r * (1 - cos(angle / 2))
+    const float angle = 2.0f * SDL_acosf(1.0f - CIRCLE_MAX_ERROR / screen_radius);
+
+    // Huge radii (a zoomed in camera) round the cosine to 1, the angle to 0. The quotient is clamped before the cast,
+    // a tiny angle would not fit an int
+    if (!(angle > 0.0f)) {
+        return CIRCLE_MAX_SEGMENTS;
+    }
+
+    const int segments = static_cast<int>(SDL_min(SDL_ceilf(2.0f * glm::pi<float>() / angle), static_cast<float>(CIRCLE_MAX_SEGMENTS)));
+
+    return SDL_clamp((segments + 3) & ~3, CIRCLE_MIN_SEGMENTS, CIRCLE_MAX_SEGMENTS);
+}
+
+const std::vector<glm::vec2>& get_unit_circle(int segments) {
+    // One slot per multiple of 4, all built by the first call (a thread-safe static), then only read
+    using Circles = std::array<std::vector<glm::vec2>, CIRCLE_MAX_SEGMENTS / 4 + 1>;
+
+    static const Circles circles = [] {
+        Circles result;
+
+        for (int count = CIRCLE_MIN_SEGMENTS; count <= CIRCLE_MAX_SEGMENTS; count += 4) {
+            std::vector<glm::vec2>& circle = result[count / 4];
+            circle.reserve(count);
+
+            for (int i = 0; i < count; i++) {
+                const float angle = 2.0f * glm::pi<float>() * static_cast<float>(i) / static_cast<float>(count);
+                circle.emplace_back(SDL_cosf(angle), SDL_sinf(angle));
+            }
+        }
+
+        return result;
+    }();
+
+    segments = SDL_clamp((segments + 3) & ~3, CIRCLE_MIN_SEGMENTS, CIRCLE_MAX_SEGMENTS);
+
+    return circles[segments / 4];
+}
+
+bool triangulate_polygon(const std::vector<glm::vec2>& points, std::vector<int>& indices) {
+    indices.clear();
+
+    const int count = static_cast<int>(points.size());
+
+    if (count < 3) {
+        return false;
+    }
+
+    float area = 0.0f;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+        area += points[j].x * points[i].y - points[i].x * points[j].y;
+    }
+
+    // Walk counter clockwise (positive area) so convex corners have a positive cross product
+    std::vector<int> remaining(count);
+    for (int i = 0; i < count; i++) {
+        remaining[i] = area >= 0.0f ? i : count - 1 - i;
+    }
+
+    indices.reserve(static_cast<size_t>(count - 2) * 3);
+
+    size_t current = 0;
+    size_t misses  = 0;
+
+    while (remaining.size() > 3) {
+        const size_t size = remaining.size();
+
+        const int previous = remaining[(current + size - 1) % size];
+        const int vertex   = remaining[current];
+        const int next     = remaining[(current + 1) % size];
+
+        const glm::vec2 a = points[previous];
+        const glm::vec2 b = points[vertex];
+        const glm::vec2 c = points[next];
+
+        const float corner = cross(a, b, c);
+
+        // Collinear vertices add nothing to the surface
+        if (corner == 0.0f) {
+            remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>(current));
+            current = current % remaining.size();
+            misses  = 0;
+            continue;
+        }
+
+        bool is_ear = corner > 0.0f;
+
+        for (size_t i = 0; is_ear && i < size; i++) {
+            const int other = remaining[i];
+
+            if (other == previous || other == vertex || other == next) {
+                continue;
+            }
+
+            // Duplicated positions (touching holes) do not block the ear
+            const glm::vec2 p = points[other];
+            if (p != a && p != b && p != c && is_inside_triangle(p, a, b, c)) {
+                is_ear = false;
+            }
+        }
+
+        if (is_ear) {
+            indices.insert(indices.end(), {previous, vertex, next});
+            remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>(current));
+
+            current = current % remaining.size();
+            misses  = 0;
+            continue;
+        }
+
+        // A full turn without an ear: degenerate or self-intersecting, fan what is left
+        if (++misses >= size) {
+            for (size_t i = 1; i + 1 < size; i++) {
+                indices.insert(indices.end(), {remaining[0], remaining[i], remaining[i + 1]});
+            }
+            return false;
+        }
+
+        current = (current + 1) % size;
+    }
+
+    if (cross(points[remaining[0]], points[remaining[1]], points[remaining[2]]) != 0.0f) {
+        indices.insert(indices.end(), {remaining[0], remaining[1], remaining[2]});
+    }
+
+    return !indices.empty();
+}
+
+void build_outline(const glm::vec2* points, size_t count, float width, std::vector<glm::vec2>& positions, std::vector<int>& indices) {
+    positions.clear();
+    indices.clear();
+
+    if (count < 2) {
+        return;
+    }
+
+    const float half_width = width * 0.5f;
+
+    const auto edge_normal = [](glm::vec2 from, glm::vec2 to) {
+        const glm::vec2 direction = to - from;
+        const float length        = glm::length(direction);
+        return length > 0.0f ? glm::vec2(-direction.y, direction.x) / length : glm::vec2(0.0f);
+    };
+
+    glm::vec2 previous_normal = edge_normal(points[count - 1], points[0]);
+
+    for (size_t i = 0; i < count; i++) {
+        const glm::vec2 next_normal = edge_normal(points[i], points[(i + 1) % count]);
+
+        glm::vec2 miter    = previous_normal + next_normal;
+        const float length = glm::length(miter);
+        miter              = length > 0.0f ? miter / length : next_normal;
+
+        // Sharp corners are capped instead of spiking out
+        const float offset = half_width / SDL_max(glm::dot(miter, next_normal), 0.25f);
+
+        positions.push_back(points[i] + miter * offset);
+        positions.push_back(points[i] - miter * offset);
+
+        const int outer      = static_cast<int>(2 * i);
+        const int next_outer = static_cast<int>(2 * ((i + 1) % count));
+
+        indices.insert(indices.end(), {outer, next_outer, outer + 1, outer + 1, next_outer, next_outer + 1});
+
+        previous_normal = next_normal;
+    }
+}
+
+const std::vector<int>& get_quad_indices(size_t quad_count) {
+    static std::vector<int> indices;
+
+    for (size_t quad = indices.size() / 6; quad < quad_count; quad++) {
+        const int first = static_cast<int>(quad * 4);
+        indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+    }
+
+    return indices;
+}
@@ -0,0 +1,211 @@
+#include "core/renderer/text_layout.h"
+
+#include "core/renderer/renderer.h"
+#include "core/system/logging.h"
+
+
+GlyphAtlas::GlyphAtlas(TTF_Font* font, int page_size) : _font(font), _page_size(page_size), _packer(page_size, page_size, 1) {
+}
+
+bool GlyphAtlas::add_page(Renderer& renderer) {
+    std::unique_ptr<Texture> page = renderer.create_glyph_page(_page_size);
+
+    if (!page) {
+        LOG_ERROR("Failed to create glyph page");
+        return false;
+    }
+
+    _pages.push_back(std::move(page));
+    _packer.reset();
+    return true;
+}
+
+const Glyph& GlyphAtlas::get_glyph(Renderer& renderer, Uint32 codepoint) {
+    if (const auto it = _glyphs.find(codepoint); it != _glyphs.end()) {
+        return it->second;
+    }
+
+    Glyph& glyph = _glyphs[codepoint];
+
+    int min_x = 0, max_x = 0, min_y = 0, max_y = 0, advance = 0;
+    if (TTF_GetGlyphMetrics(_font, codepoint, &min_x, &max_x, &min_y, &max_y, &advance)) {
+        glyph.advance = static_cast<float>(advance);
+    }
+
+    // White, the label color is applied per vertex
+    SDL_Surface* surface = TTF_RenderGlyph_Blended(_font, codepoint, SDL_Color{255, 255, 255, 255});
+
+    if (!surface) {
+        return glyph;
+    }
+
+    // Byte order R, G, B, A whatever the endianness, the layout of every other RGBA8 texture
+    if (surface->format != SDL_PIXELFORMAT_RGBA32) {
+        SDL_Surface* converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(surface);
+        surface = converted;
+
+        if (!surface) {
+            return glyph;
+        }
+    }
+
+    glm::ivec2 position;
+
+    const bool is_fitting = surface->w > 0 && surface->h > 0 && surface->w <= _page_size && surface->h <= _page_size;
+    bool is_placed        = is_fitting && !_pages.empty() && _packer.insert(surface->w, surface->h, position);
+
+    if (is_fitting && !is_placed && add_page(renderer)) {
+        is_placed = _packer.insert(surface->w, surface->h, position);
+    }
+
+    if (is_placed) {
+        const SDL_Rect rect = {position.x, position.y, surface->w, surface->h};
+        renderer.update_glyph_page(_pages.back().get(), rect, surface->pixels, surface->pitch);
+
+        const float size = static_cast<float>(_page_size);
+
+        glyph.page   = _pages.back().get();
+        glyph.uv     = {rect.x / size, rect.y / size, (rect.x + rect.w) / size, (rect.y + rect.h) / size};
+        glyph.width  = static_cast<float>(surface->w);
+        glyph.height = static_cast<float>(surface->h);
+    }
+
+    SDL_DestroySurface(surface);
+    return glyph;
+}
+
+TTF_Font* GlyphAtlas::get_font() const {
+    return _font;
+}
+
+size_t GlyphAtlas::get_page_count() const {
+    return _pages.size();
+}
+
+
+void Renderer::draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+
+    // Label2D passes "%s", skip formatting into a temporary string
+    if (SDL_strcmp(fmt, "%s") == 0) {
+        const char* text = va_arg(args, const char*);
+        va_end(args);
+
+        draw_text_layout(transform.world_position, color, get_text_layout(font_name, text ? text : ""));
+        return;
+    }
+
+    std::string text = vformat(fmt, args);
+    va_end(args);
+
+    draw_text_internal(transform.world_position, color, font_name, text);
+}
+
+void Renderer::draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name, const std::string& text) {
+    draw_text_layout(pos, color, get_text_layout(font_name, text));
+}
+
+GlyphAtlas* Renderer::get_glyph_atlas(const std::string& font_name) {
+    const auto it = _fonts.find(font_name);
+
+    if (it == _fonts.end() || !it->second->get_font()) {
+        return nullptr;
+    }
+
+    auto& atlas = _glyph_atlases[it->second->get_font()];
+
+    if (!atlas) {
+        atlas = std::make_unique<GlyphAtlas>(it->second->get_font());
+    }
+
+    return atlas.get();
+}
+
+const TextLayout& Renderer::get_text_layout(const std::string& font_name, std::string_view text) {
+    // Reused key buffer, a cache hit allocates nothing
+    _text_key.assign(font_name);
+    _text_key.push_back('\x1f');
+    _text_key.append(text);
+
+    auto [it, is_new]      = _text_layouts.try_emplace(_text_key);
+    TextLayout& layout     = it->second;
+    layout.last_used_frame = _text_frame_index;
+
+    if (!is_new) {
+        return layout;
+    }
+
+    float x = 0.0f;
+
+    for_each_text_run(text, [&](const TextRun& run) {
+        GlyphAtlas* atlas = get_glyph_atlas(!font_name.empty() ? font_name : run.is_emoji ? _emoji_font_name : _default_font_name);
+
+        if (!atlas) {
+            return;
+        }
+
+        const bool is_color = run.is_emoji && font_name.empty();
+
+        const size_t end = run.offset + run.length;
+        size_t i         = run.offset;
+        Uint32 previous  = 0;
+
+        while (i < end) {
+            const Uint32 codepoint = utf8_decode(text.data(), end, i);
+
+            int kerning = 0;
+            if (previous != 0 && TTF_GetGlyphKerning(atlas->get_font(), previous, codepoint, &kerning)) {
+                x += static_cast<float>(kerning);
+            }
+
+            const Glyph& glyph = atlas->get_glyph(*this, codepoint);
+
+            if (glyph.page) {
+                layout.quads.push_back({glyph.page, glyph.uv, {x, 0.0f, glyph.width, glyph.height}, is_color});
+            }
+
+            x += glyph.advance;
+            previous = codepoint;
+        }
+    });
+
+    layout.width = x;
+    return layout;
+}
+
+void Renderer::draw_text_layout(const glm::vec2& pos, const glm::vec4& color, const TextLayout& layout) {
+    for (const TextQuad& quad : layout.quads) {
+        const float x0 = pos.x + quad.dest.x;
+        const float y0 = pos.y + quad.dest.y;
+        const float x1 = x0 + quad.dest.z;
+        const float y1 = y0 + quad.dest.w;
+
+        const glm::vec2 positions[4] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}};
+        const glm::vec2 uvs[4]       = {{quad.uv.x, quad.uv.y}, {quad.uv.z, quad.uv.y}, {quad.uv.z, quad.uv.w}, {quad.uv.x, quad.uv.w}};
+
+        // Emoji keep their own colors, as when the text was rendered with TTF_RenderText_Blended
+        const glm::vec4 tint = quad.is_emoji ? glm::vec4(1.0f, 1.0f, 1.0f, color.a) : color;
+
+        push_glyph_quad(quad.page, positions, uvs, tint);
+    }
+}
+
+void Renderer::advance_text_frame() {
+    // Texts not drawn for a while (changing scores, timers...) are dropped, glyphs stay in the atlas
+    constexpr Uint64 MAX_UNUSED_FRAMES = 120;
+
+    _text_frame_index++;
+
+    if (_text_frame_index % MAX_UNUSED_FRAMES != 0) {
+        return;
+    }
+
+    std::erase_if(_text_layouts, [&](const auto& entry) { return _text_frame_index - entry.second.last_used_frame > MAX_UNUSED_FRAMES; });
+}
+
+void Renderer::clear_text_cache() {
+    _text_layouts.clear();
+    _glyph_atlases.clear();
+}
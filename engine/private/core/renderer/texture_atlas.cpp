@@ -0,0 +1,352 @@
+#include "core/renderer/texture_atlas.h"
+
+#include "core/io/file_system.h"
+#include "core/renderer/renderer.h"
+
+
+#pragma region ATLAS_PACKER
+
+AtlasPacker::AtlasPacker(int width, int height, int padding) : _width(width), _height(height), _padding(padding) {
+    reset();
+}
+
+void AtlasPacker::reset() {
+    _skyline.clear();
+    _skyline.push_back({0, 0, _width});
+    _used_area = 0;
+}
+
+int AtlasPacker::fit(size_t index, int width, int height) const {
+    const int x = _skyline[index].x;
+
+    if (x + width > _width) {
+        return -1;
+    }
+
+    int y          = _skyline[index].y;
+    int width_left = width;
+
+    // The rect rests on the highest node it spans
+    for (size_t i = index; width_left > 0; i++) {
+        y = SDL_max(y, _skyline[i].y);
+
+        if (y + height > _height) {
+            return -1;
+        }
+
+        width_left -= _skyline[i].width;
+    }
+
+    return y;
+}
+
+bool AtlasPacker::insert(int width, int height, glm::ivec2& position) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    if (width > _width || height > _height) {
+        return false;
+    }
+
+    // Padding is kept on the right/bottom only, the page border needs none
+    const int padded_width  = SDL_min(width + _padding, _width);
+    const int padded_height = SDL_min(height + _padding, _height);
+
+    int best_bottom = INT_MAX;
+    int best_width  = INT_MAX;
+    int best_index  = -1;
+    int best_y      = 0;
+
+    for (size_t i = 0; i < _skyline.size(); i++) {
+        const int y = fit(i, padded_width, padded_height);
+
+        if (y < 0) {
+            continue;
+        }
+
+        const int bottom = y + padded_height;
+
+        if (bottom < best_bottom || (bottom == best_bottom && _skyline[i].width < best_width)) {
+            best_bottom = bottom;
+            best_width  = _skyline[i].width;
+            best_index  = static_cast<int>(i);
+            best_y      = y;
+        }
+    }
+
+    if (best_index < 0) {
+        return false;
+    }
+
+    position = {_skyline[best_index].x, best_y};
+
+    _skyline.insert(_skyline.begin() + best_index, {position.x, best_y + padded_height, padded_width});
+
+    // Trim the nodes now covered by the new one
+    for (size_t i = best_index + 1; i < _skyline.size();) {
+        const SkylineNode& previous = _skyline[i - 1];
+        SkylineNode& node           = _skyline[i];
+
+        const int overlap = previous.x + previous.width - node.x;
+
+        if (overlap <= 0) {
+            break;
+        }
+
+        node.x += overlap;
+        node.width -= overlap;
+
+        if (node.width > 0) {
+            break;
+        }
+
+        _skyline.erase(_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < _skyline.size();) {
+        if (_skyline[i].y == _skyline[i + 1].y) {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        } else {
+            i++;
+        }
+    }
+
+    _used_area += static_cast<Uint64>(padded_width) * padded_height;
+    return true;
+}
+
+int AtlasPacker::get_width() const {
+    return _width;
+}
+
+int AtlasPacker::get_height() const {
+    return _height;
+}
+
+float AtlasPacker::get_occupancy() const {
+    const Uint64 area = static_cast<Uint64>(_width) * _height;
+    return area > 0 ? static_cast<float>(static_cast<double>(_used_area) / static_cast<double>(area)) : 0.0f;
+}
+
+#pragma endregion
+
+
+#pragma region TEXTURE_ATLAS
+
+TextureAtlas::~TextureAtlas() {
+    free_pending();
+}
+
+void TextureAtlas::configure(int page_size, int padding, int max_image_size) {
+    _page_size      = SDL_max(page_size, 64);
+    _padding        = SDL_max(padding, 0);
+    _max_image_size = SDL_clamp(max_image_size, 1, _page_size);
+}
+
+bool TextureAtlas::queue_image(const std::string& name, const std::string& path) {
+    FileAccess file(path, ModeFlags::READ);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Atlas: failed to open %s", path.c_str());
+        return false;
+    }
+
+    const auto& buffer = file.get_file_as_bytes();
+
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels =
+        stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(buffer.data()), static_cast<int>(buffer.size()), &width, &height, &channels, STBI_rgb_alpha);
+
+    if (!pixels) {
+        LOG_ERROR("Atlas: failed to decode %s, %s", path.c_str(), stbi_failure_reason());
+        return false;
+    }
+
+    if (width > _max_image_size || height > _max_image_size) {
+        LOG_DEBUG("Atlas: %s (%dx%d) exceeds max_image_size %d, kept standalone", name.c_str(), width, height, _max_image_size);
+        stbi_image_free(pixels);
+        return false;
+    }
+
+    _pending.push_back({name, width, height, pixels});
+    return true;
+}
+
+bool TextureAtlas::build(Renderer& renderer) {
+    if (_pending.empty()) {
+        return true;
+    }
+
+    PROFILE_SCOPE("TextureAtlas::build");
+
+    // Tallest first keeps the skyline flat
+    std::sort(_pending.begin(), _pending.end(), [](const PendingImage& a, const PendingImage& b) {
+        return a.height != b.height ? a.height > b.height : a.width > b.width;
+    });
+
+    struct Placement {
+        size_t page = 0;
+        glm::ivec2 position;
+    };
+
+    std::vector<AtlasPacker> packers;
+    std::vector<Placement> placements(_pending.size());
+
+    for (size_t i = 0; i < _pending.size(); i++) {
+        const PendingImage& image = _pending[i];
+
+        size_t page = 0;
+        for (; page < packers.size(); page++) {
+            if (packers[page].insert(image.width, image.height, placements[i].position)) {
+                break;
+            }
+        }
+
+        if (page == packers.size()) {
+            packers.emplace_back(_page_size, _page_size, _padding);
+            packers.back().insert(image.width, image.height, placements[i].position);
+        }
+
+        placements[i].page = page;
+    }
+
+    const size_t first_page = _pages.size();
+    const size_t page_bytes = static_cast<size_t>(_page_size) * _page_size * 4;
+    bool is_ok              = true;
+
+    for (size_t page = 0; page < packers.size(); page++) {
+        // Owned by the renderer once uploaded, which releases it with free()
+        auto* pixels = static_cast<unsigned char*>(calloc(page_bytes, 1));
+
+        if (!pixels) {
+            LOG_ERROR("Atlas: failed to allocate a %dx%d page", _page_size, _page_size);
+            is_ok = false;
+            break;
+        }
+
+        for (size_t i = 0; i < _pending.size(); i++) {
+            if (placements[i].page != page) {
+                continue;
+            }
+
+            const PendingImage& image = _pending[i];
+            const size_t row_bytes    = static_cast<size_t>(image.width) * 4;
+
+            for (int row = 0; row < image.height; row++) {
+                const size_t offset = (static_cast<size_t>(placements[i].position.y + row) * _page_size + placements[i].position.x) * 4;
+                SDL_memcpy(pixels + offset, image.pixels + row * row_bytes, row_bytes);
+            }
+        }
+
+        const std::string page_name = "__atlas_page_" + std::to_string(first_page + page);
+
+        auto texture = renderer.create_texture(page_name, _page_size, _page_size, pixels);
+
+        if (!texture) {
+            LOG_ERROR("Atlas: failed to upload %s", page_name.c_str());
+            is_ok = false;
+            break;
+        }
+
+        LOG_INFO("Atlas: %s %dx%d, %.1f%% used", page_name.c_str(), _page_size, _page_size, packers[page].get_occupancy() * 100.0f);
+        _pages.push_back(texture);
+    }
+
+    if (is_ok) {
+        for (size_t i = 0; i < _pending.size(); i++) {
+            const PendingImage& image = _pending[i];
+            const size_t page         = first_page + placements[i].page;
+
+            const glm::vec4 rect = {placements[i].position.x, placements[i].position.y, image.width, image.height};
+
+            _regions[image.name] = {_pages[page], rect, static_cast<int>(page)};
+        }
+    }
+
+    free_pending();
+    return is_ok;
+}
+
+bool TextureAtlas::load_manifest(Renderer& renderer, const std::string& path) {
+    FileAccess file(path, ModeFlags::READ);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Atlas: failed to open manifest %s", path.c_str());
+        return false;
+    }
+
+    const Json manifest = Json::parse(file.get_file_as_str(), nullptr, false);
+
+    if (manifest.is_discarded() || !manifest.contains("pages") || !manifest.contains("regions")) {
+        LOG_ERROR("Atlas: invalid manifest %s", path.c_str());
+        return false;
+    }
+
+    const size_t slash          = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    const size_t first_page     = _pages.size();
+
+    for (const auto& page : manifest["pages"]) {
+        const std::string page_path = directory + page.value("file", "");
+
+        auto texture = renderer.load_texture(page_path, page_path);
+
+        if (!texture) {
+            LOG_ERROR("Atlas: failed to load page %s", page_path.c_str());
+            return false;
+        }
+
+        _pages.push_back(texture);
+    }
+
+    for (const auto& [name, region] : manifest["regions"].items()) {
+        const size_t page = first_page + region.value("page", 0);
+
+        if (page >= _pages.size()) {
+            LOG_ERROR("Atlas: region %s references missing page %zu", name.c_str(), page);
+            continue;
+        }
+
+        _regions[name] = {_pages[page],
+                          {region.value("x", 0.0f), region.value("y", 0.0f), region.value("w", 0.0f), region.value("h", 0.0f)},
+                          static_cast<int>(page)};
+    }
+
+    LOG_INFO("Atlas: loaded %s (%zu pages, %zu regions)", path.c_str(), _pages.size() - first_page, manifest["regions"].size());
+    return true;
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& name) const {
+    if (_regions.empty()) {
+        return nullptr;
+    }
+
+    const auto it = _regions.find(name);
+    return it != _regions.end() ? &it->second : nullptr;
+}
+
+size_t TextureAtlas::get_page_count() const {
+    return _pages.size();
+}
+
+size_t TextureAtlas::size() const {
+    return _regions.size();
+}
+
+void TextureAtlas::clear() {
+    _regions.clear();
+    _pages.clear();
+    free_pending();
+}
+
+void TextureAtlas::free_pending() {
+    for (auto& image : _pending) {
+        stbi_image_free(image.pixels);
+    }
+    _pending.clear();
+}
+
+#pragma endregion
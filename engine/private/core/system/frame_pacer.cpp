@@ -0,0 +1,95 @@
+#include "core/system/frame_pacer.h"
+
+
+void FramePacer::set_target_fps(int fps) {
+    _target_fps    = fps;
+    _next_deadline = 0;
+}
+
+void FramePacer::set_background_fps(int fps) {
+    _background_fps = fps;
+    _next_deadline  = 0;
+}
+
+void FramePacer::set_vsync(bool is_enabled, float refresh_rate) {
+    _is_vsync      = is_enabled;
+    _refresh_rate  = refresh_rate;
+    _next_deadline = 0;
+}
+
+void FramePacer::set_throttled(bool is_throttled) {
+    if (_is_throttled != is_throttled) {
+        _is_throttled  = is_throttled;
+        _next_deadline = 0;
+    }
+}
+
+bool FramePacer::is_throttled() const {
+    return _is_throttled;
+}
+
+Uint64 FramePacer::get_target_ticks() const {
+    int fps = _target_fps;
+
+    if (_is_throttled && _background_fps > 0) {
+        fps = fps > 0 ? SDL_min(fps, _background_fps) : _background_fps;
+    } else if (_is_vsync && fps > 0 && _refresh_rate > 0.0f && static_cast<float>(fps) >= _refresh_rate - 1.0f) {
+        // The swap interval already blocks on vblank, waiting here would only risk missing it
+        return 0;
+    }
+
+    if (fps <= 0) {
+        return 0;
+    }
+
+    return SDL_GetPerformanceFrequency() / static_cast<Uint64>(fps);
+}
+
+double FramePacer::get_target_frame_time() const {
+    const Uint64 ticks = get_target_ticks();
+    return static_cast<double>(ticks) / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+void FramePacer::wait() {
+#if defined(SDL_PLATFORM_EMSCRIPTEN)
+    // Browser drives the loop through requestAnimationFrame
+    return;
+#else
+    const Uint64 target = get_target_ticks();
+
+    if (target == 0) {
+        _next_deadline = 0;
+        return;
+    }
+
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 now        = SDL_GetPerformanceCounter();
+
+    if (_next_deadline == 0) {
+        _next_deadline = now + target;
+    }
+
+    if (now >= _next_deadline) {
+        // Overran the budget, skip ahead instead of bursting frames to catch up
+        if (now - _next_deadline > target) {
+            _next_deadline = now;
+        }
+        _next_deadline += target;
+        return;
+    }
+
+    const Uint64 spin_ticks = static_cast<Uint64>(spin_threshold * static_cast<double>(freq));
+    const Uint64 remaining  = _next_deadline - now;
+
+    if (remaining > spin_ticks) {
+        const Uint64 sleep_ticks = remaining - spin_ticks;
+        SDL_DelayNS(sleep_ticks * SDL_NS_PER_SECOND / freq);
+    }
+
+    while (SDL_GetPerformanceCounter() < _next_deadline) {
+        SDL_CPUPauseInstruction();
+    }
+
+    _next_deadline += target;
+#endif
+}
@@ -0,0 +1,338 @@
+#include "core/system/input.h"
+
+#include "core/system/logging.h"
+#include "core/system/profiler.h"
+
+
+void Input::initialize(const std::vector<InputActionDesc>& actions) {
+    for (const auto& desc : actions) {
+        add_action(desc.name);
+
+        for (const auto& binding : desc.bindings) {
+            bind(desc.name, binding);
+        }
+    }
+
+    float x = 0.0f;
+    float y = 0.0f;
+    SDL_GetMouseState(&x, &y);
+    _mouse_position = {x, y};
+
+    LOG_INFO("Input: %zu actions registered", _actions.size());
+}
+
+void Input::begin_frame() {
+    for (const SDL_Scancode scancode : _dirty_keys) {
+        _keys[scancode] &= KEY_HELD;
+    }
+    _dirty_keys.clear();
+
+    for (const int index : _dirty_actions) {
+        _actions[index].state.is_pressed  = false;
+        _actions[index].state.is_released = false;
+    }
+    _dirty_actions.clear();
+
+    _action_events.clear();
+    _events.clear();
+
+    _mouse_delta = {0.0f, 0.0f};
+    _wheel_delta = {0.0f, 0.0f};
+}
+
+void Input::process_event(const SDL_Event& event) {
+    switch (event.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        {
+            const SDL_Scancode scancode = event.key.scancode;
+            if (scancode <= SDL_SCANCODE_UNKNOWN || scancode >= SDL_SCANCODE_COUNT || event.key.repeat) {
+                break;
+            }
+
+            const bool is_down = event.type == SDL_EVENT_KEY_DOWN;
+            Uint8& flags       = _keys[scancode];
+
+            if (is_down == ((flags & KEY_HELD) != 0)) {
+                break;
+            }
+
+            flags = static_cast<Uint8>(is_down ? (flags | KEY_HELD | KEY_PRESSED) : ((flags & ~KEY_HELD) | KEY_RELEASED));
+            _dirty_keys.push_back(scancode);
+
+            on_binding_changed(InputSource::KEY, scancode, is_down);
+            break;
+        }
+
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        {
+            const Uint32 mask  = SDL_BUTTON_MASK(event.button.button);
+            const bool is_down = event.button.down;
+
+            if (is_down == ((_mouse_buttons & mask) != 0)) {
+                break;
+            }
+
+            _mouse_buttons = is_down ? (_mouse_buttons | mask) : (_mouse_buttons & ~mask);
+            _mouse_position = {event.button.x, event.button.y};
+
+            on_binding_changed(InputSource::MOUSE_BUTTON, event.button.button, is_down);
+            break;
+        }
+
+    case SDL_EVENT_MOUSE_MOTION:
+        _mouse_position = {event.motion.x, event.motion.y};
+        _mouse_delta += glm::vec2(event.motion.xrel, event.motion.yrel);
+        break;
+
+    case SDL_EVENT_MOUSE_WHEEL:
+        {
+            const float flip = event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1.0f : 1.0f;
+            _wheel_delta += glm::vec2(event.wheel.x, event.wheel.y) * flip;
+            break;
+        }
+
+    case SDL_EVENT_WINDOW_FOCUS_LOST:
+        {
+            // Key up events are never delivered to an unfocused window, release everything
+            for (int scancode = 0; scancode < SDL_SCANCODE_COUNT; ++scancode) {
+                if (_keys[scancode] & KEY_HELD) {
+                    _keys[scancode] = static_cast<Uint8>((_keys[scancode] & ~KEY_HELD) | KEY_RELEASED);
+                    _dirty_keys.push_back(static_cast<SDL_Scancode>(scancode));
+                    on_binding_changed(InputSource::KEY, scancode, false);
+                }
+            }
+            break;
+        }
+
+    default:
+        break;
+    }
+
+    coalesce_event(event);
+}
+
+void Input::coalesce_event(const SDL_Event& event) {
+    if (!_events.empty()) {
+        SDL_Event& last = _events.back();
+
+        if (event.type == SDL_EVENT_MOUSE_MOTION && last.type == SDL_EVENT_MOUSE_MOTION && last.motion.which == event.motion.which) {
+            const float xrel = last.motion.xrel + event.motion.xrel;
+            const float yrel = last.motion.yrel + event.motion.yrel;
+
+            last             = event;
+            last.motion.xrel = xrel;
+            last.motion.yrel = yrel;
+            return;
+        }
+
+        if (event.type == SDL_EVENT_MOUSE_WHEEL && last.type == SDL_EVENT_MOUSE_WHEEL && last.wheel.which == event.wheel.which
+            && last.wheel.direction == event.wheel.direction) {
+            const float x = last.wheel.x + event.wheel.x;
+            const float y = last.wheel.y + event.wheel.y;
+
+            last         = event;
+            last.wheel.x = x;
+            last.wheel.y = y;
+            return;
+        }
+    }
+
+    _events.push_back(event);
+}
+
+void Input::dispatch() {
+    if (_action_events.empty()) {
+        return;
+    }
+
+    PROFILE_SCOPE("Input::dispatch");
+
+    for (const auto& action_event : _action_events) {
+        const auto it = _subscribers.find(action_event.action);
+        if (it == _subscribers.end()) {
+            continue;
+        }
+
+        // Indexed loop, a callback may subscribe or unsubscribe while we iterate
+        auto& subscribers = it->second;
+        for (size_t i = 0; i < subscribers.size(); ++i) {
+            const InputActionCallback callback = subscribers[i].callback;
+            callback(_actions[action_event.action].name, action_event.is_pressed);
+        }
+    }
+}
+
+int Input::get_binding_key(InputSource source, int code) {
+    return (static_cast<int>(source) << 16) | (code & 0xFFFF);
+}
+
+const Input::Action* Input::find_action(const std::string& name) const {
+    const auto it = _action_lookup.find(name);
+    return it != _action_lookup.end() ? &_actions[it->second] : nullptr;
+}
+
+bool Input::is_binding_held(const InputBinding& binding) const {
+    switch (binding.source) {
+    case InputSource::KEY:
+        return binding.code > SDL_SCANCODE_UNKNOWN && binding.code < SDL_SCANCODE_COUNT && (_keys[binding.code] & KEY_HELD) != 0;
+    case InputSource::MOUSE_BUTTON:
+        return (_mouse_buttons & SDL_BUTTON_MASK(binding.code)) != 0;
+    }
+
+    return false;
+}
+
+void Input::on_binding_changed(InputSource source, int code, bool is_down) {
+    const auto it = _binding_actions.find(get_binding_key(source, code));
+    if (it == _binding_actions.end()) {
+        return;
+    }
+
+    for (const int index : it->second) {
+        Action& action = _actions[index];
+
+        bool is_held = is_down;
+        if (!is_down) {
+            // Another binding of the same action may still be down
+            for (const auto& binding : action.bindings) {
+                if (is_binding_held(binding)) {
+                    is_held = true;
+                    break;
+                }
+            }
+        }
+
+        if (is_held == action.state.is_held) {
+            continue;
+        }
+
+        action.state.is_held = is_held;
+        if (is_held) {
+            action.state.is_pressed = true;
+        } else {
+            action.state.is_released = true;
+        }
+
+        _dirty_actions.push_back(index);
+        _action_events.push_back({index, is_held});
+    }
+}
+
+#pragma region ACTIONS
+
+bool Input::add_action(const std::string& name) {
+    if (_action_lookup.contains(name)) {
+        return false;
+    }
+
+    _action_lookup[name] = static_cast<int>(_actions.size());
+    _actions.push_back({name, {}, {}});
+    return true;
+}
+
+bool Input::bind(const std::string& action, InputBinding binding) {
+    const auto it = _action_lookup.find(action);
+    if (it == _action_lookup.end()) {
+        LOG_ERROR("Input: cannot bind unknown action %s", action.c_str());
+        return false;
+    }
+
+    _actions[it->second].bindings.push_back(binding);
+    _binding_actions[get_binding_key(binding.source, binding.code)].push_back(it->second);
+    return true;
+}
+
+bool Input::bind_key(const std::string& action, SDL_Scancode scancode) {
+    return bind(action, {InputSource::KEY, scancode});
+}
+
+bool Input::bind_mouse_button(const std::string& action, Uint8 button) {
+    return bind(action, {InputSource::MOUSE_BUTTON, button});
+}
+
+bool Input::has_action(const std::string& action) const {
+    return find_action(action) != nullptr;
+}
+
+bool Input::is_action_held(const std::string& action) const {
+    const Action* found = find_action(action);
+    return found && found->state.is_held;
+}
+
+bool Input::is_action_pressed(const std::string& action) const {
+    const Action* found = find_action(action);
+    return found && found->state.is_pressed;
+}
+
+bool Input::is_action_released(const std::string& action) const {
+    const Action* found = find_action(action);
+    return found && found->state.is_released;
+}
+
+float Input::get_axis(const std::string& negative, const std::string& positive) const {
+    return (is_action_held(positive) ? 1.0f : 0.0f) - (is_action_held(negative) ? 1.0f : 0.0f);
+}
+
+glm::vec2 Input::get_vector(const std::string& left, const std::string& right, const std::string& up, const std::string& down) const {
+    const glm::vec2 direction = {get_axis(left, right), get_axis(up, down)};
+    const float length        = glm::length(direction);
+
+    return length > 1.0f ? direction / length : direction;
+}
+
+bool Input::subscribe(const std::string& action, const void* owner, InputActionCallback callback) {
+    const auto it = _action_lookup.find(action);
+    if (it == _action_lookup.end()) {
+        LOG_ERROR("Input: cannot subscribe to unknown action %s", action.c_str());
+        return false;
+    }
+
+    _subscribers[it->second].push_back({owner, std::move(callback)});
+    return true;
+}
+
+void Input::unsubscribe(const void* owner) {
+    for (auto& [_, subscribers] : _subscribers) {
+        std::erase_if(subscribers, [owner](const Subscriber& subscriber) { return subscriber.owner == owner; });
+    }
+}
+
+#pragma endregion
+
+#pragma region DEVICES
+
+bool Input::is_key_held(SDL_Scancode scancode) const {
+    return scancode > SDL_SCANCODE_UNKNOWN && scancode < SDL_SCANCODE_COUNT && (_keys[scancode] & KEY_HELD) != 0;
+}
+
+bool Input::is_key_pressed(SDL_Scancode scancode) const {
+    return scancode > SDL_SCANCODE_UNKNOWN && scancode < SDL_SCANCODE_COUNT && (_keys[scancode] & KEY_PRESSED) != 0;
+}
+
+bool Input::is_key_released(SDL_Scancode scancode) const {
+    return scancode > SDL_SCANCODE_UNKNOWN && scancode < SDL_SCANCODE_COUNT && (_keys[scancode] & KEY_RELEASED) != 0;
+}
+
+bool Input::is_mouse_button_held(Uint8 button) const {
+    return (_mouse_buttons & SDL_BUTTON_MASK(button)) != 0;
+}
+
+glm::vec2 Input::get_mouse_position() const {
+    return _mouse_position;
+}
+
+glm::vec2 Input::get_mouse_delta() const {
+    return _mouse_delta;
+}
+
+glm::vec2 Input::get_wheel_delta() const {
+    return _wheel_delta;
+}
+
+const std::vector<SDL_Event>& Input::get_events() const {
+    return _events;
+}
+
+#pragma endregion
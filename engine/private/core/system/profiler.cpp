@@ -0,0 +1,303 @@
+#include "core/system/profiler.h"
+
+#include "core/io/file_system.h"
+
+
+namespace {
+    // flecs hands us the system name owned by the system, keep our own copy per pointer
+    thread_local std::unordered_map<const char*, const char*> flecs_names;
+
+    // Only systems are recorded, internal traces (flecs.commit, flecs.emit, ...) fire on every component change
+    bool is_flecs_internal(const char* name) {
+        return !name || SDL_strncmp(name, "flecs.", 6) == 0;
+    }
+
+    void flecs_perf_trace_push(const char* filename, size_t line, const char* name) {
+        (void) filename;
+        (void) line;
+
+        if (is_flecs_internal(name)) {
+            return;
+        }
+
+        auto& profiler = Profiler::get_instance();
+
+        auto it = flecs_names.find(name);
+        if (it == flecs_names.end()) {
+            it = flecs_names.emplace(name, profiler.intern(name)).first;
+        }
+
+        profiler.begin_zone(it->second);
+    }
+
+    void flecs_perf_trace_pop(const char* filename, size_t line, const char* name) {
+        (void) filename;
+        (void) line;
+
+        if (is_flecs_internal(name)) {
+            return;
+        }
+
+        Profiler::get_instance().end_zone();
+    }
+
+    void append_json_string(std::string& out, const char* str) {
+        out += '"';
+        for (const char* c = str; *c; ++c) {
+            switch (*c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    out += ' ';
+                } else {
+                    out += *c;
+                }
+                break;
+            }
+        }
+        out += '"';
+    }
+} // namespace
+
+
+thread_local Profiler::ThreadBuffer* Profiler::_current_thread = nullptr;
+thread_local Uint32 Profiler::_open_depth                       = 0;
+
+
+Profiler& Profiler::get_instance() {
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::initialize() {
+    set_thread_name("Main");
+
+    ecs_os_api.perf_trace_push_ = flecs_perf_trace_push;
+    ecs_os_api.perf_trace_pop_  = flecs_perf_trace_pop;
+}
+
+void Profiler::set_enabled(bool is_enabled) {
+    _is_enabled = is_enabled;
+}
+
+bool Profiler::is_enabled() const {
+    return _is_enabled;
+}
+
+Uint64 Profiler::get_time_ns() {
+    static const Uint64 freq = SDL_GetPerformanceFrequency();
+
+    const Uint64 counter = SDL_GetPerformanceCounter();
+
+    // split to avoid overflowing counter * 1e9
+    return (counter / freq) * SDL_NS_PER_SECOND + (counter % freq) * SDL_NS_PER_SECOND / freq;
+}
+
+Profiler::ThreadBuffer& Profiler::get_thread_buffer() {
+    if (_current_thread) {
+        return *_current_thread;
+    }
+
+    auto buffer       = std::make_unique<ThreadBuffer>();
+    buffer->thread_id = SDL_GetCurrentThreadID();
+    buffer->thread_name = "Thread " + std::to_string(buffer->thread_id);
+    buffer->events.resize(events_per_thread);
+    buffer->open.reserve(64);
+
+    _current_thread = buffer.get();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _threads.push_back(std::move(buffer));
+
+    return *_current_thread;
+}
+
+void Profiler::set_thread_name(const char* name) {
+    ThreadBuffer& buffer = get_thread_buffer();
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.thread_name = name;
+}
+
+const char* Profiler::intern(const char* name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _interned.find(name);
+    if (it != _interned.end()) {
+        return it->second.get();
+    }
+
+    const size_t size = SDL_strlen(name) + 1;
+    auto copy         = std::make_unique<char[]>(size);
+    SDL_memcpy(copy.get(), name, size);
+
+    const char* result = copy.get();
+    _interned.emplace(name, std::move(copy));
+    return result;
+}
+
+void Profiler::begin_zone(const char* name) {
+    // Zones opened while disabled are only counted, so toggling mid-zone keeps begin/end pairs balanced
+    const Uint32 open_depth = _open_depth++;
+    if (!_is_enabled) {
+        return;
+    }
+
+    ThreadBuffer& buffer = get_thread_buffer();
+    buffer.open.push_back({{name, get_time_ns(), 0, static_cast<Uint32>(buffer.open.size())}, open_depth});
+}
+
+void Profiler::end_zone() {
+    if (_open_depth == 0) {
+        return;
+    }
+
+    const Uint32 open_depth = --_open_depth;
+    if (!_current_thread || _current_thread->open.empty()) {
+        return;
+    }
+
+    // The innermost zone was opened while disabled and never pushed
+    ThreadBuffer& buffer = *_current_thread;
+    if (buffer.open.back().open_depth != open_depth) {
+        return;
+    }
+
+    ProfileEvent event = buffer.open.back().event;
+    buffer.open.pop_back();
+
+    if (!_is_enabled) {
+        return;
+    }
+
+    event.end_ns = get_time_ns();
+
+    push_event(buffer, event);
+}
+
+void Profiler::push_event(ThreadBuffer& buffer, const ProfileEvent& event) {
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events[buffer.head] = event;
+    buffer.head                = (buffer.head + 1) % events_per_thread;
+    buffer.count               = SDL_min(buffer.count + 1, events_per_thread);
+}
+
+Profiler::ThreadBuffer& Profiler::get_track_buffer(const char* track) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _tracks.find(track);
+    if (it != _tracks.end()) {
+        return *it->second;
+    }
+
+    // Synthetic ids far from real thread ids keep the tracks apart in the viewer
+    auto buffer         = std::make_unique<ThreadBuffer>();
+    buffer->thread_id   = 0xFFFF0000ull + _tracks.size();
+    buffer->thread_name = track;
+    buffer->events.resize(events_per_thread);
+
+    ThreadBuffer* result = buffer.get();
+    _tracks.emplace(track, result);
+    _threads.push_back(std::move(buffer));
+
+    return *result;
+}
+
+void Profiler::record_zone(const char* track, const char* name, Uint64 start_ns, Uint64 end_ns, Uint32 depth) {
+    if (!_is_enabled) {
+        return;
+    }
+
+    push_event(get_track_buffer(track), {name, start_ns, end_ns, depth});
+}
+
+void Profiler::for_each_event(const std::function<void(const std::string& thread_name, const ProfileEvent& event)>& callback) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& buffer : _threads) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+
+        const size_t first = (buffer->head + events_per_thread - buffer->count) % events_per_thread;
+
+        for (size_t i = 0; i < buffer->count; ++i) {
+            callback(buffer->thread_name, buffer->events[(first + i) % events_per_thread]);
+        }
+    }
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& buffer : _threads) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->head  = 0;
+        buffer->count = 0;
+    }
+}
+
+std::string Profiler::get_chrome_trace() {
+    std::string json;
+    json.reserve(1024 * 1024);
+    json += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool is_first = true;
+    char line[256];
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& buffer : _threads) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+
+        const Uint64 tid = buffer->thread_id;
+
+        // thread name metadata
+        SDL_snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%llu,\"args\":{\"name\":",
+                     is_first ? "" : ",", static_cast<unsigned long long>(tid));
+        json += line;
+        append_json_string(json, buffer->thread_name.c_str());
+        json += "}}";
+        is_first = false;
+
+        const size_t first = (buffer->head + events_per_thread - buffer->count) % events_per_thread;
+
+        for (size_t i = 0; i < buffer->count; ++i) {
+            const ProfileEvent& event = buffer->events[(first + i) % events_per_thread];
+
+            json += ",{\"name\":";
+            append_json_string(json, event.name ? event.name : "unnamed");
+
+            // Chrome expects microseconds, fractional values keep the ns precision
+            SDL_snprintf(line, sizeof(line), ",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%llu,\"args\":{\"depth\":%u}}",
+                         static_cast<double>(event.start_ns) / 1000.0, static_cast<double>(event.end_ns - event.start_ns) / 1000.0,
+                         static_cast<unsigned long long>(tid), event.depth);
+            json += line;
+        }
+    }
+
+    json += "]}";
+    return json;
+}
+
+bool Profiler::dump_chrome_trace(const std::string& path) {
+    const std::string json = get_chrome_trace();
+
+    FileAccess file(path, ModeFlags::WRITE);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open profiler trace file: %s", path.c_str());
+        return false;
+    }
+
+    if (!file.store_string(json)) {
+        LOG_ERROR("Failed to write profiler trace file: %s", path.c_str());
+        return false;
+    }
+
+    LOG_INFO("Profiler trace written to %s (%zu bytes)", file.get_absolute_path().c_str(), json.size());
+    return true;
+}
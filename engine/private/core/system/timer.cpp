@@ -13,6 +13,7 @@ void Timer::start() {
     last         = now;
     delta        = 0.0;
     elapsed_time = 0.0;
+    _accumulator = 0.0;
 }
 
 void Timer::tick() {
@@ -20,6 +21,34 @@ void Timer::tick() {
     now  = SDL_GetPerformanceCounter();
 
     Uint64 freq = SDL_GetPerformanceFrequency();
-    delta       = static_cast<double>(now - last) / static_cast<double>(freq);
+    delta       = fixed_frame_delta > 0.0 ? fixed_frame_delta : static_cast<double>(now - last) / static_cast<double>(freq);
     elapsed_time += delta;
 }
+
+int Timer::consume_fixed_steps() {
+    if (fixed_delta <= 0.0) {
+        return 0;
+    }
+
+    _accumulator += delta;
+
+    int steps = 0;
+    while (_accumulator >= fixed_delta && steps < max_fixed_steps) {
+        _accumulator -= fixed_delta;
+        steps++;
+    }
+
+    if (_accumulator >= fixed_delta) {
+        _accumulator = SDL_fmod(_accumulator, fixed_delta);
+    }
+
+    return steps;
+}
+
+float Timer::get_fixed_alpha() const {
+    if (fixed_delta <= 0.0) {
+        return 1.0f;
+    }
+
+    return static_cast<float>(_accumulator / fixed_delta);
+}
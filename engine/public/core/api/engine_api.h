@@ -29,7 +29,11 @@ void entity_remove_component(flecs::entity& e, const std::string& component_name
 bool entity_is_valid(flecs::entity& e);
 
 
-// Input related API
+// Input related API, see `Input` (`GEngine->get_input()`) for actions, edges and deltas
 glm::vec2 get_mouse_position();
 
+/*!
+    @brief True while the key is held, read from the cached `Input` state.
+    @param key_code SDL scancode.
+*/
 bool is_key_pressed(int key_code);
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "core/component/logic/particle_pool.h"
 #include "core/renderer/base_struct.h"
 #include "core/system/logging.h"
+#include "core/system/profiler.h"
 
 // ==============================================================
 // ALL COMPONENTS ARE DEFINED HERE, PURE DATA AND SIMPLE LOGICS |
@@ -11,7 +13,10 @@
 
 
 /*!
- * @brief Represents a 2D transformation position, scale, and rotation.
+ * @brief Represents a 2D transformation position, scale, and rotation (radians).
+ *
+ * The `world_*` fields are written by the transform propagation systems (PreUpdate), parents before children.
+ * An entity is only recomputed when its local fields or its parent's world transform changed.
  * @ingroup Components
  */
 struct Transform2D {
@@ -24,6 +29,18 @@ struct Transform2D {
     glm::vec2 world_position = {0, 0};
     glm::vec2 world_scale    = {1, 1};
     float world_rotation     = 0;
+
+    glm::mat3 world_matrix = glm::mat3(1.0f); /// parent world * T(position) * R(rotation) * S(scale)
+
+    bool is_dirty = true; /// Forces the next propagation, changes of the local fields are detected without it
+
+    // Propagation cache, owned by the transform systems
+    glm::vec2 propagated_position = {0, 0}; /// Local state the world transform was computed from
+    glm::vec2 propagated_scale    = {1, 1};
+    float propagated_rotation     = 0;
+    flecs::entity_t parent_id     = 0; /// Parent the world transform was computed from, a reparent recomputes it
+    Uint32 parent_version         = 0; /// `world_version` of that parent
+    Uint32 world_version          = 0; /// Incremented every time the world transform changes
 };
 
 /*!
@@ -51,6 +68,10 @@ struct Shape2D {
 
     /// vertices for `polygon`
     std::vector<glm::vec2> vertices;
+
+    // Triangulation cache of `polygon`, owned by the render system and rebuilt when `vertices` change
+    std::vector<int> triangles; /// 3 indices into `vertices` per triangle
+    std::vector<glm::vec2> triangulated_vertices; /// `vertices` the triangles were computed from
 };
 
 /*!
@@ -65,13 +86,25 @@ struct Shape2D {
  * local speed = 100
  * function _ready()
  *     print("Entity started!")
+ *
+ *     -- woken only when the action changes, actions are declared in project.xml <input>
+ *     Input.subscribe("jump", function(is_pressed)
+ *         print("jump " .. tostring(is_pressed))
+ *     end)
  * end
  *
  * function _process(dt)
- *     self.transform.position.x = self.transform.position.x + speed * dt
- *     self.transform.position.y = self.transform.position.y + speed * dt
+ *     local direction = Input.get_vector("move_left", "move_right", "move_up", "move_down")
+ *     self.transform.position.x = self.transform.position.x + direction.x * speed * dt
+ *     self.transform.position.y = self.transform.position.y + direction.y * speed * dt
+ * end
+ *
+ * -- called at a fixed rate (`physics_fps`), zero or more times per frame
+ * function _physics_process(fixed_dt)
+ *     self.transform.rotation = self.transform.rotation + fixed_dt
  * end
  * 
+ * -- raw events, mouse motion/wheel are coalesced to one event per frame
  * function _input(event)
  *    print("Input event received: " .. event.type)
  * end
@@ -86,6 +119,7 @@ struct Script {
     std::string path     = "";
     lua_State* lua_state = nullptr;
     bool ready_called    = false;
+    bool has_input       = false; /// Script defines `_input(event)`, cached when loaded
 
     ~Script();
 };
@@ -114,6 +148,107 @@ struct Sprite2D {
     bool flip_v              = false;
 };
 
+/*!
+ * @brief `CHUNK_SIZE`² tiles of a TileMap2D and their cached quads.
+ * @ingroup Components
+ */
+struct TileChunk2D {
+    std::vector<Uint16> tiles; /// Row major tile ids, left empty until a tile of the chunk is set
+    Uint32 tile_count = 0; /// Non-empty tiles
+
+    // Geometry cache, owned by the render system: rebuilt when dirty, released after a while off-screen
+    std::vector<glm::vec2> positions; /// 4 corners per tile (TL, TR, BR, BL), local to the map
+    std::vector<glm::vec2> uvs;
+    bool is_dirty           = true;
+    Uint64 last_drawn_frame = 0;
+};
+
+/*!
+ * @brief Grid of tiles drawn from one tileset texture, stored and drawn per chunk.
+ *
+ * Tile ids index the tileset cells left to right, top to bottom, starting at 1. 0 is an empty cell. The top-left corner
+ * of the map is at the transform position. Edit it with `resize_tilemap`/`set_tile` or `load_tilemap` (see
+ * `tilemap_2d.h`), so only the chunks actually touched are rebuilt.
+ * @ingroup Components
+ */
+struct TileMap2D {
+    static constexpr int CHUNK_SIZE = 32;
+
+    std::string texture_name = ""; /// Tileset, a texture or an atlas region
+    glm::vec2 tile_size      = {16, 16}; /// Size of a tile, in the world and in the tileset
+    glm::vec4 color          = {1, 1, 1, 1};
+
+    int width    = 0; /// In tiles
+    int height   = 0;
+    int chunks_x = 0;
+    int chunks_y = 0;
+    std::vector<TileChunk2D> chunks; /// Row major, `chunks_x` * `chunks_y`
+
+    // Render cache, the chunks are rebuilt when the tileset they were built from changes
+    glm::vec4 built_source       = {0, 0, 0, 0}; /// Tileset rect in its texture (x, y, w, h)
+    glm::vec2 built_texture_size = {0, 0};
+    glm::vec2 built_tile_size    = {0, 0};
+    Uint64 frame                 = 0; /// Frames drawn
+};
+
+/*!
+ * @brief Emits 2D particles from the entity position, simulated on worker threads and drawn as colored quads.
+ *
+ * The simulation is skipped while the particles were not on screen the previous frame, the pool is kept as is.
+ * Changing `max_particles` reallocates the pool on the next update.
+ * @ingroup Components
+ */
+struct ParticleEmitter2D {
+    size_t max_particles     = 1000;
+    float rate               = 100; /// Particles per second
+    float lifetime           = 1; /// Seconds
+    float lifetime_variation = 0; /// Random +/- seconds
+    float direction          = -glm::half_pi<float>(); /// Radians, world space, up by default
+    float spread             = glm::pi<float>() / 8.0f; /// Radians on each side of `direction`
+    float speed              = 100;
+    float speed_variation    = 0; /// Random +/- speed
+    glm::vec2 gravity        = {0, 0};
+    float damping            = 0; /// Fraction of the velocity lost per second
+    glm::vec4 color_start    = {1, 1, 1, 1};
+    glm::vec4 color_end      = {1, 1, 1, 0};
+    float size               = 4; /// Side of the particle quads
+    std::string texture_name = ""; /// Optional, a texture or an atlas region
+    bool is_emitting         = true;
+
+    // Runtime state, owned by the particle systems
+    ParticlePool pool;
+    float emit_accumulator = 0;
+    Uint32 random_state    = 0; /// Seeded from the entity by the first update while 0
+    bool is_visible        = true; /// Set by the render pass, cleared once consumed by the update
+};
+
+/*!
+ * @brief Emits 3D particles from the entity position in a cone, drawn as camera facing billboards.
+ * @see ParticleEmitter2D
+ * @ingroup Components
+ */
+struct ParticleEmitter3D {
+    size_t max_particles     = 1000;
+    float rate               = 100;
+    float lifetime           = 1;
+    float lifetime_variation = 0;
+    glm::vec3 direction      = {0, 1, 0}; /// World space
+    float spread             = glm::pi<float>() / 8.0f; /// Cone half angle, radians
+    float speed              = 2;
+    float speed_variation    = 0;
+    glm::vec3 gravity        = {0, 0, 0};
+    float damping            = 0;
+    glm::vec4 color_start    = {1, 1, 1, 1};
+    glm::vec4 color_end      = {1, 1, 1, 0};
+    float size               = 0.1f; /// Billboard side, world units
+    bool is_emitting         = true;
+
+    ParticlePool pool;
+    float emit_accumulator = 0;
+    Uint32 random_state    = 0; /// Seeded from the entity by the first update while 0
+    bool is_visible        = true; /// Overlapped the last 3D view, set by the update
+};
+
 
 struct SceneRoot {};
 
@@ -126,9 +261,16 @@ namespace tags {
     struct Alive {}; // Marks entities that are alive (children of active scene)
 
     struct MainCamera {}; // Marks the main camera entity
+
+    struct Static {}; // Marks models and meshes that never move, their shadows are cached (see `Shadows::is_caching_static`)
 }; // namespace tags
 
 
+namespace phases {
+    struct FixedUpdate {}; // Systems run by the fixed-timestep pipeline (`Performance::physics_fps`)
+}; // namespace phases
+
+
 /*!
  * @brief Scene change request component to signal a scene switch.
  * @ingroup Systems
@@ -157,6 +299,31 @@ struct Transform3D {
     }
 };
 
+/*!
+ * @brief Keeps the previous simulation state of a Transform2D for render interpolation.
+ *
+ * Entities with this component are drawn blended between the last two fixed steps, so they
+ * should be moved in `_physics_process` (or any `phases::FixedUpdate` system).
+ * @ingroup Components
+ */
+struct Interpolation2D {
+    glm::vec2 position = {0, 0};
+    glm::vec2 scale    = {1, 1};
+    float rotation     = 0;
+
+    bool is_valid = false; /// False until the first fixed step captured a state
+};
+
+/*!
+ * @brief Keeps the previous simulation state of a Transform3D for render interpolation.
+ * @ingroup Components
+ */
+struct Interpolation3D {
+    Transform3D previous = {};
+
+    bool is_valid = false; /// False until the first fixed step captured a state
+};
+
 /*!
  * @brief Represents a physics body for 2D or 3D physics simulations.
  * Jolt Physics -> BodyID
@@ -188,6 +355,9 @@ struct Model {
     std::shared_ptr<Assimp::Importer> importer = nullptr;
     const aiScene* scene                       = nullptr;
     glm::mat4 global_inverse_transform         = glm::mat4(1.0f);
+
+    BoundingBox bounds;                          // Bind pose box of every mesh, in model space
+    std::vector<BoundingBox> animation_bounds;   // Box swept by the skinned meshes over each animation
     
     bool is_loaded = false;
 
@@ -250,6 +420,29 @@ public:
     glm::mat4 get_projection(int w, int h) const {
         return glm::ortho(0.0f, static_cast<float>(w), static_cast<float>(h), 0.0f, -1.0f, 1.0f);
     }
+
+    /*!
+        @brief Converts a viewport point (e.g. the mouse position) to world space.
+    */
+    glm::vec2 screen_to_world(glm::vec2 point) const {
+        return glm::vec2(glm::inverse(get_view()) * glm::vec4(point, 0.0f, 1.0f));
+    }
+
+    /*!
+        @brief World-space bounds of what a `w` x `h` viewport shows, zoom and rotation included.
+    */
+    Rect2D get_visible_rect(int w, int h) const {
+        const glm::mat4 inverse = glm::inverse(get_view());
+
+        const glm::vec2 corners[4] = {
+            glm::vec2(inverse * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
+            glm::vec2(inverse * glm::vec4(static_cast<float>(w), 0.0f, 0.0f, 1.0f)),
+            glm::vec2(inverse * glm::vec4(static_cast<float>(w), static_cast<float>(h), 0.0f, 1.0f)),
+            glm::vec2(inverse * glm::vec4(0.0f, static_cast<float>(h), 0.0f, 1.0f)),
+        };
+
+        return Rect2D::from_points(corners, 4);
+    }
 };
 
 // enum MOVEMENT { FORWARD, BACKWARD, LEFT, RIGHT };
@@ -331,6 +524,12 @@ inline void serialize_components(flecs::world& ecs) {
 
     ecs.component<tags::ActiveScene>().add(flecs::Exclusive);
 
+    ecs.component<phases::FixedUpdate>();
+
+    ecs.component<Interpolation2D>().member<glm::vec2>("position").member<glm::vec2>("scale").member<float>("rotation");
+
+    ecs.component<Interpolation3D>().member<Transform3D>("previous");
+
     ecs.component<Model>();
 
 
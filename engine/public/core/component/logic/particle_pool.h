@@ -0,0 +1,94 @@
+#pragma once
+
+#include "stdafx.h"
+
+
+/*!
+    @file particle_pool.h
+    @brief ParticlePool class definition.
+
+    Structure of arrays storage of the particles of one emitter: every attribute is a separate float stream, so the
+    update touches contiguous memory and processes 4 particles per instruction (SSE2, scalar on other targets).
+
+    - The capacity is fixed by `set_capacity`, the only allocation. Emitting into a full pool drops the particle.
+    - Live particles are always the first `size()` of every stream. A dead particle is replaced by the last one, so
+      the order is not kept.
+    - Colors are not stored per emission: every update blends the emitter start and end colors by the particle age.
+
+    @ingroup Systems
+    @version 0.0.1
+*/
+class ParticlePool {
+public:
+    enum Stream : Uint8 {
+        POSITION_X,
+        POSITION_Y,
+        POSITION_Z,
+        VELOCITY_X,
+        VELOCITY_Y,
+        VELOCITY_Z,
+        COLOR_R,
+        COLOR_G,
+        COLOR_B,
+        COLOR_A,
+        AGE,
+        INVERSE_LIFETIME, /// 1 / lifetime, the normalized age is a multiplication
+        STREAM_COUNT
+    };
+
+    /*!
+        @brief Reallocates the streams, every particle is dropped.
+    */
+    void set_capacity(size_t capacity);
+
+    void clear();
+
+    /*!
+        @return false if the pool is full, the particle is dropped
+    */
+    bool emit(glm::vec3 position, glm::vec3 velocity, float lifetime);
+
+    /*!
+        @brief Moves, ages and colors every particle, then drops the expired ones.
+        @param acceleration Added to the velocities (gravity, wind)
+        @param damping Fraction of the velocity lost per second
+    */
+    void update(float dt, glm::vec3 acceleration, float damping, glm::vec4 color_start, glm::vec4 color_end);
+
+    /*!
+        @return First element of a stream, `size()` values are valid
+    */
+    [[nodiscard]] const float* get_stream(Stream stream) const;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] size_t get_capacity() const;
+
+    /*!
+        @brief Bounds of the positions computed by the last `update`, min > max when it had no particle.
+    */
+    [[nodiscard]] glm::vec3 get_bounds_min() const;
+
+    [[nodiscard]] glm::vec3 get_bounds_max() const;
+
+private:
+    [[nodiscard]] float* stream(Stream stream);
+
+    std::vector<float> _data; /// STREAM_COUNT streams of `_stride` floats
+    size_t _stride   = 0;
+    size_t _capacity = 0;
+    size_t _count    = 0;
+
+    glm::vec3 _bounds_min = glm::vec3(FLT_MAX);
+    glm::vec3 _bounds_max = glm::vec3(-FLT_MAX);
+};
+
+/*!
+    @brief Xorshift step, a uniform value in [0, 1). Emitters keep their own state, so worker threads never share one.
+*/
+float next_particle_random(Uint32& state);
+
+/*!
+    @brief Non-zero xorshift state mixed from `value` (e.g. an entity id), neighbouring values give unrelated sequences.
+*/
+[[nodiscard]] Uint32 seed_particle_random(Uint64 value);
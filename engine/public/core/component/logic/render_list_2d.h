@@ -0,0 +1,133 @@
+#pragma once
+
+#include "core/component/components.h"
+#include "core/component/logic/spatial_hash_2d.h"
+
+
+/*!
+    @file render_list_2d.h
+    @brief RenderList2D class definition.
+
+    Persistent, z-sorted list of every drawable 2D entity (`Transform2D` with `TileMap2D`, `Shape2D`, `Sprite2D`,
+    `ParticleEmitter2D` and/or `Label2D`).
+
+    Membership is maintained by observers, so nothing is queried while drawing. Each entry caches `flecs::ref`s to its
+    components, which avoids the `has`/`get_mut` lookups per entity. The list is only re-sorted when something changed:
+
+    - Added entities and entities whose `z_index` changed are sorted among themselves and merged into the list, O(n + k log k).
+    - Ties keep the order in which entities joined the list (stable), regardless of how many times they were re-sorted.
+
+    Every entry also has its world bounds in a SpatialHash2D, refreshed when `Transform2D::world_version` changes or
+    when a shape, a sprite or a tilemap is set (`set`, or `modified` after an in-place change). Tilemaps are loaded and
+    resized in place, their size is compared every sync.
+    Drawing with a view rectangle only visits the entries under it, then restores their z order, so off-screen entities
+    cost nothing. Labels have no known size and are never culled. A visible tilemap is then culled per chunk.
+    Particles move on their own, the bounds of emitters are refreshed every sync from their pool.
+
+    @ingroup Systems
+    @version 0.0.1
+*/
+class RenderList2D {
+public:
+    /*!
+        @brief Registers the observers keeping the list in sync, call once per world.
+    */
+    void attach(flecs::world& world);
+
+    /*!
+        @brief Applies pending additions/removals and `z_index` changes. Cheap when nothing changed.
+    */
+    void sync();
+
+    /*!
+        @brief Draws every entry in z order (tilemaps, shapes, sprites, particles, then labels of the same entity).
+    */
+    void draw();
+
+    /*!
+        @brief Draws the entries overlapping `view` (world space, see `Camera2D::get_visible_rect`) in z order.
+    */
+    void draw(const Rect2D& view);
+
+    /*!
+        @brief Entities whose bounds overlap `rect`, in draw order (the last one is drawn on top).
+    */
+    void query_rect(const Rect2D& rect, std::vector<flecs::entity>& entities) const;
+
+    /*!
+        @brief Entities whose bounds contain `point`, in draw order, e.g. mouse picking with `Camera2D::screen_to_world`.
+    */
+    void query_point(glm::vec2 point, std::vector<flecs::entity>& entities) const;
+
+    [[nodiscard]] const SpatialHash2D& get_spatial_hash() const;
+
+    [[nodiscard]] size_t size() const;
+
+    /*!
+        @brief Entities in draw order, for debugging and tests.
+    */
+    [[nodiscard]] std::vector<flecs::entity> get_draw_order() const;
+
+    /*!
+        @brief Entities `draw(view)` would draw, in draw order.
+    */
+    [[nodiscard]] std::vector<flecs::entity> get_draw_order(const Rect2D& view) const;
+
+private:
+    enum DrawableFlags : Uint8 {
+        DRAW_SHAPE     = 1 << 0,
+        DRAW_SPRITE    = 1 << 1,
+        DRAW_LABEL     = 1 << 2,
+        DRAW_TILEMAP   = 1 << 3,
+        DRAW_PARTICLES = 1 << 4
+    };
+
+    struct Entry {
+        flecs::entity entity;
+        Uint64 sequence = 0; /// Order of arrival, tie-breaker for equal z_index
+        int z_index     = 0; /// z_index the list was sorted with
+        Uint8 drawables = 0;
+
+        Uint32 proxy             = SpatialHash2D::INVALID_HANDLE; /// Handle of the bounds in the spatial hash
+        Uint32 bounds_version    = 0; /// `world_version` the bounds were computed with
+        glm::vec2 tilemap_extent = {0, 0}; /// Local size of the tilemap the bounds were computed with
+
+        flecs::ref<Transform2D> transform;
+        flecs::ref<Shape2D> shape;
+        flecs::ref<Sprite2D> sprite;
+        flecs::ref<Label2D> label;
+        flecs::ref<TileMap2D> tilemap;
+        flecs::ref<ParticleEmitter2D> particles;
+    };
+
+    static bool is_before(const Entry& a, const Entry& b);
+
+    void mark_pending(flecs::entity e);
+
+    bool make_entry(flecs::entity e, Uint64 sequence, Entry& entry) const;
+
+    /// World bounds of everything the entry draws
+    static Rect2D compute_bounds(Entry& entry);
+
+    /// `view` only narrows the tilemap chunks, the entry itself is already known to be visible
+    static void draw_entry(Entry& entry, const Rect2D& view);
+
+    /// Indices into `_entries` of the items overlapping `rect`, sorted (z order)
+    void collect(const Rect2D& rect, std::vector<Uint32>& indices) const;
+
+    std::vector<Entry> _entries;
+    std::vector<Entry> _merge_buffer;
+    std::vector<Entry> _resorted; /// Entries leaving their slot this sync (new or z_index changed)
+
+    std::unordered_map<flecs::entity_t, Uint64> _sequences; /// Entities currently in the list
+    std::vector<flecs::entity_t> _pending; /// Entities whose components changed since the last sync
+    std::vector<flecs::entity_t> _stale_bounds; /// Entities whose drawables were set since the last sync
+
+    SpatialHash2D _spatial_hash;
+    std::vector<Uint32> _proxy_entries; /// Proxy handle -> index in `_entries`, rebuilt when the order changes
+    mutable std::vector<Uint32> _visible; /// Reused by `draw(view)` and the queries
+
+    Uint64 _next_sequence = 0;
+
+    flecs::world_t* _world = nullptr;
+};
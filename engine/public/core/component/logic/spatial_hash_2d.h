@@ -0,0 +1,160 @@
+#pragma once
+
+#include "core/renderer/base_struct.h"
+
+
+/*!
+    @file spatial_hash_2d.h
+    @brief SpatialHash2D class definition.
+
+    Uniform grid broadphase over 2D bounds. Cells are hashed, so the world has no fixed size and empty space costs
+    nothing. An item is listed in every cell its bounds overlap:
+
+    - Moving an item only touches the cell lists when its cell range changed, a small motion is a compare.
+    - Items spanning more than `MAX_ITEM_CELLS` cells are kept aside and tested by every query.
+    - A query visits the cells under the rectangle (or every occupied cell when that is fewer) and reports each
+      overlapping item once.
+
+    Handles are small dense integers, reused after `remove`, so callers can index their own arrays with them.
+
+    @note Queries mark the items they visit, they must not run concurrently with each other or with updates.
+    @ingroup Systems
+    @version 0.0.1
+*/
+class SpatialHash2D {
+public:
+    static constexpr Uint32 INVALID_HANDLE = UINT32_MAX;
+    static constexpr int MAX_ITEM_CELLS    = 64;
+
+    explicit SpatialHash2D(float cell_size = 256.0f);
+
+    /*!
+        @param user_data Returned by `get_user_data`, e.g. an entity id
+        @return Handle of the new item
+    */
+    Uint32 insert(const Rect2D& bounds, Uint64 user_data);
+
+    void update(Uint32 handle, const Rect2D& bounds);
+
+    void remove(Uint32 handle);
+
+    void clear();
+
+    /*!
+        @brief Calls `callback(handle)` once for every item whose bounds overlap `rect`, in no particular order.
+    */
+    template <typename Callback>
+    void query(const Rect2D& rect, Callback&& callback) const;
+
+    /*!
+        @brief Appends the handles of the items containing `point`.
+    */
+    void query_point(glm::vec2 point, std::vector<Uint32>& handles) const;
+
+    [[nodiscard]] const Rect2D& get_bounds(Uint32 handle) const;
+
+    [[nodiscard]] Uint64 get_user_data(Uint32 handle) const;
+
+    [[nodiscard]] size_t size() const;
+
+    /*!
+        @brief Every handle in use is below this value.
+    */
+    [[nodiscard]] size_t get_capacity() const;
+
+    [[nodiscard]] float get_cell_size() const;
+
+private:
+    struct CellRange {
+        int min_x = 0;
+        int min_y = 0;
+        int max_x = -1;
+        int max_y = -1;
+
+        bool operator==(const CellRange&) const = default;
+
+        /// Widened before subtracting, a clamped axis spans 2^31 + 1 cells
+        [[nodiscard]] Sint64 get_count() const {
+            return (static_cast<Sint64>(max_x) - min_x + 1) * (static_cast<Sint64>(max_y) - min_y + 1);
+        }
+    };
+
+    struct Item {
+        Rect2D bounds;
+        CellRange cells;
+        Uint64 user_data  = 0;
+        bool is_alive     = false;
+        bool is_oversized = false;
+    };
+
+    [[nodiscard]] CellRange get_cells(const Rect2D& bounds) const;
+
+    static Uint64 get_cell_key(int x, int y);
+
+    void link(Uint32 handle);
+
+    void unlink(Uint32 handle);
+
+    /// Starts a query, the returned stamp marks the items already reported
+    Uint32 next_query_stamp() const;
+
+    std::unordered_map<Uint64, std::vector<Uint32>> _cells;
+    std::vector<Item> _items;
+    std::vector<Uint32> _free_handles;
+    std::vector<Uint32> _oversized;
+
+    mutable std::vector<Uint32> _query_stamps; /// Per handle, last query that reported it
+    mutable Uint32 _query_stamp = 0;
+
+    float _cell_size         = 256.0f;
+    float _inverse_cell_size = 1.0f / 256.0f;
+    size_t _count            = 0;
+};
+
+
+template <typename Callback>
+void SpatialHash2D::query(const Rect2D& rect, Callback&& callback) const {
+    if (_count == 0) {
+        return;
+    }
+
+    const Uint32 stamp = next_query_stamp();
+
+    const auto visit = [&](const std::vector<Uint32>& handles) {
+        for (const Uint32 handle : handles) {
+            if (_query_stamps[handle] == stamp) {
+                continue;
+            }
+
+            _query_stamps[handle] = stamp;
+
+            if (_items[handle].bounds.overlaps(rect)) {
+                callback(handle);
+            }
+        }
+    };
+
+    const CellRange range = get_cells(rect);
+
+    // Zoomed far out, walking the occupied cells is cheaper than probing every cell of the rectangle
+    if (range.get_count() > static_cast<Sint64>(_cells.size())) {
+        for (const auto& [key, handles] : _cells) {
+            const int x = static_cast<Sint32>(key >> 32);
+            const int y = static_cast<Sint32>(key & 0xFFFFFFFF);
+
+            if (x >= range.min_x && x <= range.max_x && y >= range.min_y && y <= range.max_y) {
+                visit(handles);
+            }
+        }
+    } else {
+        for (int y = range.min_y; y <= range.max_y; y++) {
+            for (int x = range.min_x; x <= range.max_x; x++) {
+                if (const auto it = _cells.find(get_cell_key(x, y)); it != _cells.end()) {
+                    visit(it->second);
+                }
+            }
+        }
+    }
+
+    visit(_oversized);
+}
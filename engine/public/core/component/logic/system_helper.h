@@ -17,4 +17,42 @@ glm::vec3 interpolate_scale(float animTime, const aiNodeAnim* nodeAnim);
 void read_node_hierarchy(float animTime, const aiNode* node, const glm::mat4& parentTransform, const aiAnimation* animation,
                          const Model& model, std::unordered_map<std::string, glm::mat4>& bone_map);
 
-int sort_by_z_index(flecs::entity_t e1, const Transform2D* t1, flecs::entity_t e2, const Transform2D* t2);
\ No newline at end of file
+int sort_by_z_index(flecs::entity_t e1, const Transform2D* t1, flecs::entity_t e2, const Transform2D* t2);
+
+/*!
+    @brief Affine matrix of a 2D transform: T(position) * R(rotation) * S(scale).
+*/
+glm::mat3 compose_transform_2d(glm::vec2 position, glm::vec2 scale, float rotation);
+
+/*!
+    @brief Recomputes the world transform of `t` if its local state or its parent changed.
+    @param parent Nearest ancestor with a Transform2D, already propagated this frame (nullptr for roots)
+    @param previous Previous fixed step, blended with `alpha` when valid (nullptr if not interpolated)
+    @param parent_id Entity owning `parent`, versions of two parents can match so a reparent is detected with it
+    @return true if the world transform was rewritten
+*/
+bool propagate_transform_2d(Transform2D& t, const Transform2D* parent, const Interpolation2D* previous, float alpha,
+                            flecs::entity_t parent_id = 0);
+
+/*!
+    @brief Triangles of a `POLYGON` shape, re-triangulated only when its vertices changed since the last call.
+*/
+const std::vector<int>& get_polygon_triangles(Shape2D& shape);
+
+/*!
+    @brief Blends two angles (radians) along the shortest arc, a wrapped angle (2pi -> 0) does not spin the long way.
+    @return `to` when `alpha` is 1
+*/
+float mix_angle(float from, float to, float alpha);
+
+/*!
+    @brief Blends the local fields of a Transform2D with its previous fixed step.
+    @param alpha Interpolation factor, see `Timer::get_fixed_alpha`
+*/
+Transform2D interpolate_transform_2d(const Transform2D& current, const Interpolation2D& previous, float alpha);
+
+/*!
+    @brief Blends a Transform3D with its previous fixed step, the rotations along the shortest arc (quaternion slerp).
+    @param alpha Interpolation factor, see `Timer::get_fixed_alpha`
+*/
+Transform3D interpolate_transform_3d(const Transform3D& current, const Interpolation3D& previous, float alpha);
@@ -30,12 +30,37 @@ void render_labels_system(Transform2D& t, Label2D& l);
 */
 void render_sprites_system(Transform2D& t, Sprite2D& s);
 
+/*!
+@brief System to render the chunks of a TileMap2D overlapping `view` (world space), one draw per chunk.
+Chunk quads are rebuilt when their tiles changed and released after `TILE_CHUNK_EVICT_FRAMES` frames off-screen.
+@ingroup Systems
+
+*/
+void render_tilemaps_system(Transform2D& t, TileMap2D& map, const Rect2D& view);
+
+/*!
+@brief System to emit and simulate the particles of a ParticleEmitter2D (see `ParticlePool::update`).
+Skipped while the emitter was off-screen the previous frame, its particles stay where they are.
+@note Only touches its own emitter, runs as a multi-threaded system.
+@ingroup Systems
+
+*/
+void update_particles_2d_system(flecs::entity e, const Transform2D& t, ParticleEmitter2D& emitter);
+
+/*!
+@brief System to render the particles of a ParticleEmitter2D in one submission, marks it visible for the next update.
+@ingroup Systems
+
+*/
+void render_particles_2d_system(ParticleEmitter2D& emitter);
+
 /*!
  * @brief System to update 2D transforms.
+ * Must run parents first (cascade), unchanged entities are skipped, see `propagate_transform_2d`.
  * @ingroup Systems
 
  */
-void update_transforms_system(flecs::entity e, Transform2D& t);
+void update_transforms_system(Transform2D& t, const Interpolation2D* previous, const Transform2D* parent, flecs::entity_t parent_id);
 
 /*!
 
@@ -56,10 +81,52 @@ void render_world_2d_system(flecs::entity e, Camera2D& camera);
 void render_world_3d_system(flecs::entity e, Camera3D& camera);
 
 /*!
-@brief System to update and render animated 3D models.
+@brief Returns the transform used for drawing, blended with the previous fixed step if the entity has Interpolation3D.
+@ingroup Systems
+*/
+Transform3D get_render_transform_3d(flecs::entity e, const Transform3D& t);
+
+/*!
+@brief System to load pending models, must run on the main thread (GPU uploads).
+@ingroup Systems
+*/
+void load_model_system(flecs::entity e, Model& model);
+
+/*!
+@brief System to give the renderer the view of the active camera before the models are submitted, so they are culled
+against the frame being drawn.
+@ingroup Systems
+*/
+void prepare_view_3d_system(const Transform3D& t, const Camera3D& camera);
+
+/*!
+@brief System to submit loaded (and animated) models to the renderer batches.
+@note Thread-safe, runs as a multi-threaded system.
+@ingroup Systems
+*/
+void submit_models_system(flecs::entity e, const Transform3D& t, const Model& model);
+
+/*!
+@brief System to submit MeshInstance3D to the renderer batches.
+@note Thread-safe, runs as a multi-threaded system.
+@ingroup Systems
+*/
+void submit_meshes_system(flecs::entity e, const Transform3D& t, const MeshInstance3D& mesh);
+
+/*!
+@brief System to update the bone transforms of animated 3D models.
+@note Only touches its own Animation3D, runs as a multi-threaded system.
+@ingroup Systems
+*/
+void animation_system(flecs::entity e, const Model& model, Animation3D& anim);
+
+/*!
+@brief System to emit, simulate and submit the particles of a ParticleEmitter3D.
+Skipped while the particles and the emitter are outside the last 3D view (see `Renderer::is_box_visible_3d`).
+@note Only touches its own emitter, runs as a multi-threaded system.
 @ingroup Systems
 */
-void animation_system(flecs::entity e, Model& model, Animation3D& anim, Transform3D& transform);
+void update_particles_3d_system(flecs::entity e, const Transform3D& t, ParticleEmitter3D& emitter);
 
 #pragma endregion
 
@@ -89,7 +156,27 @@ void setup_scripts_system(flecs::entity e, Script& script);
 void process_scripts_system(Script& script);
 
 /*!
-@brief System to process events in scripts.
+@brief Calls `_input(event)` once per coalesced event of the frame, skipped for scripts without `_input`.
+
+Prefer `Input.subscribe(action, fn)` or polling `Input.is_action_pressed`, they do not build an event table per script.
+@ingroup Systems
+*/
+void process_event_scripts_system(const Script& script, const std::vector<SDL_Event>& events);
+
+/*!
+@brief System to call `_physics_process(fixed_dt)` in scripts, runs in the fixed-timestep pipeline.
+@ingroup Systems
+*/
+void process_physics_scripts_system(Script& script);
+
+/*!
+@brief Captures the 2D transform before a fixed step so rendering can interpolate.
+@ingroup Systems
+*/
+void store_previous_transform_2d_system(const Transform2D& t, Interpolation2D& previous);
+
+/*!
+@brief Captures the 3D transform before a fixed step so rendering can interpolate.
 @ingroup Systems
 */
-void process_event_scripts_system(const Script&, const SDL_Event& event);
+void store_previous_transform_3d_system(const Transform3D& t, Interpolation3D& previous);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/component/components.h"
+
+
+/*!
+    @file tilemap_2d.h
+    @brief Editing, loading and chunk building of TileMap2D.
+
+    A map only stores 2 bytes per tile, in chunks allocated on first use. Quads are built per chunk when it is first
+    drawn after a change, and released once it has been off-screen for `TILE_CHUNK_EVICT_FRAMES` frames, so the geometry
+    kept in memory follows what the camera sees, not the map size.
+
+    Files are picked by extension:
+
+    - `.json`: `{"width": w, "height": h, "tile_size": [tw, th], "texture": "name", "tiles": [ids...]}`, row major.
+    - Anything else is the binary format, little endian: "ETM1", Uint32 width, Uint32 height, float tile width,
+      float tile height, Uint16 texture name length and bytes, then (Uint16 count, Uint16 id) runs covering the map row
+      by row.
+
+    @ingroup Systems
+    @version 0.0.1
+*/
+
+/// Id of an empty cell
+constexpr Uint16 TILE_EMPTY = 0;
+
+/// Frames a chunk stays off-screen before its quads are released
+constexpr Uint64 TILE_CHUNK_EVICT_FRAMES = 120;
+
+/*!
+    @brief Resizes the map, every tile is cleared.
+*/
+void resize_tilemap(TileMap2D& map, int width, int height);
+
+/*!
+    @return TILE_EMPTY outside of the map
+*/
+[[nodiscard]] Uint16 get_tile(const TileMap2D& map, int x, int y);
+
+/*!
+    @brief Sets a tile and marks its chunk for rebuild, ignored outside of the map.
+*/
+void set_tile(TileMap2D& map, int x, int y, Uint16 tile);
+
+/*!
+    @brief Map rectangle before the transform, from (0, 0) to its size in world units.
+*/
+[[nodiscard]] Rect2D get_tilemap_local_bounds(const TileMap2D& map);
+
+/*!
+    @brief Chunks overlapping `view` (world space), as an inclusive range of chunk coordinates.
+    @return false if none does
+*/
+bool get_visible_chunks(const TileMap2D& map, const Transform2D& t, const Rect2D& view, glm::ivec2& min, glm::ivec2& max);
+
+/*!
+    @brief Rebuilds the quads of one chunk.
+    @param source Tileset rectangle in its texture (x, y, w, h), e.g. an atlas region
+    @param texture_size Size of the texture holding the tileset
+*/
+void build_tile_chunk(TileMap2D& map, int chunk_x, int chunk_y, glm::vec4 source, glm::vec2 texture_size);
+
+/*!
+    @brief Replaces the map with the content of a `.json` or binary file, see the file description.
+*/
+bool load_tilemap(TileMap2D& map, const std::string& path);
+
+/*!
+    @brief Writes the map in the binary format.
+*/
+bool save_tilemap(const TileMap2D& map, const std::string& path);
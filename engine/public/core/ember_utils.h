@@ -2,13 +2,101 @@
 
 #include "stdafx.h"
 
+#include <string_view>
+
+/// SSE2 paths of the engine (x86-64 always has it), scalar code otherwise
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EMBER_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+
+constexpr uint32_t UTF8_REPLACEMENT_CHARACTER = 0xFFFD;
+
+/*!
+    @brief Decodes the code point starting at `index` and advances `index` past it.
+
+    Never reads at or past `size`: truncated, overlong or otherwise invalid sequences yield U+FFFD and advance one byte.
+*/
+uint32_t utf8_decode(const char* text, size_t size, size_t& index);
+
+/*!
+    @brief Index of the first non-ASCII byte at or after `index` (`size` if none), 16 bytes per step with SSE2.
+*/
+size_t utf8_skip_ascii(const char* text, size_t size, size_t index);
 
 std::vector<uint32_t> utf8_to_utf32(const std::string& utf8);
 
 std::string utf32_to_utf8(uint32_t cp);
 
+/*!
+    @brief Emoji ranges rendered with the emoji font, a bitmap lookup (no range chain).
+*/
 bool is_character_emoji(uint32_t cp);
 
+/*!
+    @brief Zero width joiner, variation selector 16 and keycap, they belong to the run they appear in.
+*/
+inline bool is_emoji_joiner(uint32_t cp) {
+    return cp == 0x200D || cp == 0xFE0F || cp == 0x20E3;
+}
+
+/*!
+    @brief Consecutive code points using the same font, as a byte range of the source text.
+*/
+struct TextRun {
+    size_t offset = 0;
+    size_t length = 0;
+    bool is_emoji = false;
+};
+
+/*!
+    @brief Splits `text` into text/emoji runs without allocating or copying, calls `on_run(const TextRun&)` for each.
+*/
+template <typename Callback>
+void for_each_text_run(std::string_view text, Callback&& on_run) {
+    size_t run_start  = 0;
+    bool is_run_emoji = false;
+    size_t i          = 0;
+
+    while (i < text.size()) {
+        // ASCII is never emoji, whole spans are skipped at once
+        const size_t ascii_end = utf8_skip_ascii(text.data(), text.size(), i);
+
+        if (ascii_end != i) {
+            if (is_run_emoji) {
+                on_run(TextRun{run_start, i - run_start, true});
+                run_start    = i;
+                is_run_emoji = false;
+            }
+
+            i = ascii_end;
+            continue;
+        }
+
+        const size_t cp_start = i;
+        const uint32_t cp     = utf8_decode(text.data(), text.size(), i);
+
+        if (is_emoji_joiner(cp)) {
+            continue;
+        }
+
+        const bool is_emoji = is_character_emoji(cp);
+
+        if (is_emoji != is_run_emoji) {
+            if (cp_start > run_start) {
+                on_run(TextRun{run_start, cp_start - run_start, is_run_emoji});
+            }
+            run_start    = cp_start;
+            is_run_emoji = is_emoji;
+        }
+    }
+
+    if (text.size() > run_start) {
+        on_run(TextRun{run_start, text.size() - run_start, is_run_emoji});
+    }
+}
+
 template <typename NumType>
 inline NumType random_number(NumType min, NumType max) {
     static_assert(std::is_arithmetic_v<NumType>, "random_number requires an arithmetic type");
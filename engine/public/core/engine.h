@@ -1,8 +1,12 @@
 #pragma once
 #include "core/io/file_system.h"
+#include "core/component/logic/render_list_2d.h"
 #include "core/project_config.h"
+#include "core/renderer/null/null_renderer.h"
 #include "core/renderer/opengl/ogl_renderer.h"
 #include "core/renderer/sdl/sdl_renderer.h"
+#include "core/system/frame_pacer.h"
+#include "core/system/input.h"
 #include "core/system/timer.h"
 
 /*!
@@ -22,6 +26,12 @@ public:
 
     Timer& get_timer();
 
+    FramePacer& get_frame_pacer();
+
+    Input& get_input();
+
+    RenderList2D& get_render_list_2d();
+
     Renderer* get_renderer() const;
 
     SDL_Window* get_window() const;
@@ -30,8 +40,16 @@ public:
 
     flecs::world& get_world();
 
+    /*!
+        @brief Pipeline holding the `phases::FixedUpdate` systems, run `physics_fps` times per second.
+    */
+    flecs::entity get_fixed_pipeline() const;
+
     bool is_running = false;
 
+    /// Set before `initialize` to ignore the `<renderer>` backend of project.xml (benchmarks, tools)
+    std::optional<Backend> backend_override;
+
     SDL_Event event;
 
     ~Engine();
@@ -41,7 +59,11 @@ private:
 
     EngineConfig _config = {};
     Timer _timer         = {};
+    FramePacer _frame_pacer = {};
+    Input _input            = {};
+    RenderList2D _render_list_2d = {}; /// Declared before the world, its observers fire while the world is destroyed
     flecs::world _world;
+    flecs::entity _fixed_pipeline;
     SDL_Window* _window = nullptr;
     Renderer* _renderer = nullptr;
 };
@@ -56,6 +78,16 @@ private:
 */
 void engine_core_loop();
 
+/*!
+
+    @brief Runs the fixed-timestep pipeline as many times as the accumulated frame time requires.
+
+    Called once per frame before `world.progress`, each step advances the simulation by `Timer::fixed_delta`.
+
+    @version 0.0.1
+*/
+void engine_fixed_update();
+
 /*!
 
     @brief Sets up the core systems in the provided Flecs world.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/io/file_system.h"
+#include "core/system/input.h"
 
 
 /**
@@ -40,7 +41,14 @@ enum class Backend {
     /**
      * @brief Automatically choose the best backend for the platform.
      */
-    AUTO
+    AUTO,
+
+    /**
+     * @brief Headless renderer, records draw counts and sizes without any GPU work.
+     *
+     * CPU-side benchmarks and GPU-less CI, runs with a hidden window (or none).
+     */
+    NONE
 };
 
 /*!
@@ -85,6 +93,18 @@ enum class TextureFiltering {
     NEAREST ///< Pixelated filtering.
 };
 
+/**
+ * @brief Vertical synchronization modes.
+ *
+ * Parsed from `<vsync>` in `project.xml` (`true`, `false` or `adaptive`).
+ * @ingroup Configuration
+ */
+enum class VSyncMode {
+    DISABLED, ///< Present immediately, the frame pacer limits the frame rate.
+    ENABLED, ///< Block on vertical blank.
+    ADAPTIVE ///< Block on vertical blank, tear instead of waiting when a frame is late.
+};
+
 /*!
  * @brief Viewport configuration settings.
  * @ingroup Configuration
@@ -121,6 +141,7 @@ struct Application {
     const char* icon_path    = "res/icon.png";
     const char* description  = "EEngine";
     int max_fps              = 60;
+    int background_fps       = 10; /// Frame rate while minimized or unfocused, `<= 0` disables throttling
 
     bool is_fullscreen = false;
     bool is_resizable  = true;
@@ -133,9 +154,11 @@ struct Application {
  * @ingroup Configuration
  */
 struct Performance {
-    bool is_multithreaded = false;
-    int physics_fps       = 60;
-    int worker_threads    = -1; // Default to -1 (auto-detect based on CPU cores)
+    bool is_multithreaded         = false;
+    int physics_fps               = 60;
+    int worker_threads            = -1; // Default to -1 (auto-detect based on CPU cores)
+    bool is_profiling             = false; // CPU zones recorded by the Profiler (F10 dumps a trace)
+    bool is_profiling_gpu_batches = false; // OpenGL only: one GPU timer zone per instanced batch
 
     bool load(const tinyxml2::XMLElement* root);
 };
@@ -153,6 +176,55 @@ struct RendererDevice {
     [[nodiscard]] const char* get_backend_str() const;
 };
 
+/*!
+ * @brief Action map read from `<input>`, each `<action name="...">` lists `<key>` (SDL scancode name) and `<mouse>` (left, middle, right, x1, x2) bindings.
+ * @ingroup Configuration
+ */
+struct InputMap {
+    std::vector<InputActionDesc> actions;
+
+    bool load(const tinyxml2::XMLElement* root);
+};
+
+/*!
+ * @brief Texture atlas settings read from `<atlas>`: an offline `<manifest>` (tools/pack_atlas.py) and/or `<image name="...">`
+ * entries packed into shared pages at startup.
+ * @ingroup Configuration
+ */
+struct TextureAtlasConfig {
+    struct Image {
+        std::string name;
+        std::string path;
+    };
+
+    int page_size      = 2048;
+    int padding        = 1;
+    int max_image_size = 256; /// Larger images stay standalone textures
+
+    std::string manifest;
+    std::vector<Image> images;
+
+    bool load(const tinyxml2::XMLElement* root);
+};
+
+constexpr int MAX_SHADOW_CASCADES = 4;
+
+/*!
+ * @brief Cascaded shadow map settings read from `<shadows>`, each cascade covers a slice of the camera view.
+ * @ingroup Configuration
+ */
+struct Shadows {
+    int cascade_count  = 3;      /// 1 to MAX_SHADOW_CASCADES
+    int resolution     = 2048;   /// Width and height of each cascade map
+    int depth_bits     = 24;     /// 16 or 24
+    float distance     = 150.0f; /// View distance covered by the cascades, no shadow past it
+    float split_lambda = 0.75f;  /// Split scheme, 0 uniform to 1 logarithmic (more texels close to the camera)
+
+    bool is_caching_static = true; /// Casters tagged `tags::Static` are kept in a second map, redrawn only when it is invalidated
+
+    bool load(const tinyxml2::XMLElement* root);
+};
+
 enum class WindowMode { WINDOWED, /// Windowed mode.
     MAXIMIZED, /// Maximized mode.
     MINIMIZED, /// Minimized mode.
@@ -202,10 +274,20 @@ struct EngineConfig {
 
     Window& get_window();
 
+    InputMap& get_input_map();
+
+    TextureAtlasConfig& get_texture_atlas();
+
+    Shadows& get_shadows();
+
     bool is_vsync() const;
 
     void set_vsync(bool enabled);
 
+    VSyncMode get_vsync_mode() const;
+
+    void set_vsync_mode(VSyncMode mode);
+
 private:
     Application _app;
 
@@ -219,7 +301,13 @@ private:
 
     Window _window;
 
-    bool _is_vsync_enabled = true;
+    InputMap _input_map;
+
+    TextureAtlasConfig _texture_atlas;
+
+    Shadows _shadows;
+
+    VSyncMode _vsync_mode = VSyncMode::ENABLED;
 
     tinyxml2::XMLDocument _doc = {};
 };
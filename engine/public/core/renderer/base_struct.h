@@ -1,6 +1,7 @@
 #pragma once
 
 #include "stdafx.h"
+#include "core/renderer/bounds.h"
 /*!
     @brief Cube map orientation options
     
@@ -61,6 +62,39 @@ struct Tokens {
 };
 
 
+/*!
+    @brief Axis aligned 2D rectangle, edges included.
+
+    @version 0.0.1
+*/
+struct Rect2D {
+    glm::vec2 min = {0, 0};
+    glm::vec2 max = {0, 0};
+
+    [[nodiscard]] bool overlaps(const Rect2D& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+    }
+
+    [[nodiscard]] bool contains(glm::vec2 point) const {
+        return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+    }
+
+    /*!
+        @brief Smallest rectangle holding `points`.
+    */
+    static Rect2D from_points(const glm::vec2* points, size_t count) {
+        Rect2D rect = {points[0], points[0]};
+
+        for (size_t i = 1; i < count; i++) {
+            rect.min = glm::min(rect.min, points[i]);
+            rect.max = glm::max(rect.max, points[i]);
+        }
+
+        return rect;
+    }
+};
+
+
 /*!
 
     @brief Font class
@@ -187,6 +221,7 @@ struct Bone {
     std::string name;
     glm::mat4 offset_matrix   = glm::mat4(1.f); // Inverse bind pose matrix
     glm::mat4 final_transform = glm::mat4(1.f); // Final transform to upload to GPU
+    BoundingBox bounds;                          // Bind pose box of the vertices it moves, in mesh space
 
     Bone() = default;
 };
@@ -217,6 +252,9 @@ struct Mesh {
     std::unordered_map<std::string, int> bone_map; // Bone name -> bone index
     std::vector<Bone> bones; // All bones in this mesh
 
+    BoundingBox bounds;           // Bind pose, in mesh space
+    BoundingBox unskinned_bounds; // Vertices no bone moves (skinned meshes), empty when every vertex is weighted
+
     virtual void bind() = 0;
 
     virtual void upload_to_gpu() = 0;
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "stdafx.h"
+
+
+/*!
+    @file bounds.h
+    @brief Bounding volumes of the 3D meshes and the frustum tests run on them before anything is batched.
+
+    Boxes are computed once at import in mesh space (bind pose). Skinned models also keep one box per animation
+    clip, swept over the whole clip, so a playing character never needs its vertices to be skinned on the CPU.
+
+    A frustum stores its planes as SoA lanes, tests run 4 planes or 4 spheres per SSE2 instruction with a
+    scalar fallback.
+
+    @version 0.0.1
+*/
+
+
+/*!
+    @brief Axis aligned box, empty (min > max) until a point is added.
+*/
+struct BoundingBox {
+    glm::vec3 min = glm::vec3(FLT_MAX);
+    glm::vec3 max = glm::vec3(-FLT_MAX);
+
+    [[nodiscard]] bool is_valid() const {
+        return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+
+    void expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void merge(const BoundingBox& other) {
+        if (other.is_valid()) {
+            expand(other.min);
+            expand(other.max);
+        }
+    }
+
+    [[nodiscard]] glm::vec3 get_center() const {
+        return (min + max) * 0.5f;
+    }
+
+    [[nodiscard]] glm::vec3 get_extents() const {
+        return (max - min) * 0.5f;
+    }
+
+    /*!
+        @brief Box enclosing this one once transformed by the affine `matrix` (still axis aligned, so larger).
+    */
+    [[nodiscard]] BoundingBox transformed(const glm::mat4& matrix) const;
+};
+
+
+/// Bits of the passes an instance is drawn in, see `Renderer::get_visible_passes`
+constexpr Uint8 RENDER_PASS_MAIN   = 1 << 0;
+constexpr Uint8 RENDER_PASS_SHADOW = 1 << 1;
+constexpr Uint8 RENDER_PASS_ALL    = RENDER_PASS_MAIN | RENDER_PASS_SHADOW;
+
+/// Not a pass: the shadow of the instance goes to the static shadow cache instead of being drawn every frame
+constexpr Uint8 RENDER_PASS_STATIC = 1 << 2;
+
+
+/*!
+    @brief The 6 planes of a view-projection, normals pointing inside.
+    A default frustum accepts everything.
+*/
+class Frustum {
+public:
+    /*!
+        @brief Planes of the clip volume of `view_projection` (OpenGL depth range, -w..w), in world space.
+    */
+    void set_matrix(const glm::mat4& view_projection);
+
+    [[nodiscard]] bool is_sphere_visible(const glm::vec3& center, float radius) const;
+
+    /*!
+        @brief Conservative: a box crossing a frustum corner outside of it may be reported visible.
+    */
+    [[nodiscard]] bool is_box_visible(const glm::vec3& min, const glm::vec3& max) const;
+
+    /*!
+        @brief Tests `count` spheres given as SoA streams, 4 at a time, and ORs `pass` into `passes[i]` of the visible ones.
+    */
+    void cull_spheres(const float* x, const float* y, const float* z, const float* radius, size_t count, Uint8 pass,
+                      Uint8* passes) const;
+
+private:
+    // 6 planes padded to 8 lanes, the padding planes (0, 0, 0, 1) accept everything
+    alignas(16) float _nx[8] = {};
+    alignas(16) float _ny[8] = {};
+    alignas(16) float _nz[8] = {};
+    alignas(16) float _d[8]  = {1, 1, 1, 1, 1, 1, 1, 1};
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "core/renderer/null/null_struct.h"
+#include "core/renderer/renderer.h"
+
+
+/*!
+    @brief Work recorded by the NullRenderer instead of being sent to a GPU.
+
+    @version 0.0.1
+*/
+struct NullRenderStats {
+    Uint64 draw_calls      = 0; /// draw_* calls received
+    Uint64 instances       = 0; /// 3D instances pushed into the batches
+    Uint64 batches         = 0; /// instanced batches that would be issued at flush
+    Uint64 flushes         = 0;
+    Uint64 vertices        = 0; /// 2D vertices that would be generated
+    Uint64 submitted_bytes = 0; /// per-frame data that would be streamed (instances, 2D vertices)
+
+    Uint64 shadow_instances      = 0; /// 3D instances drawn into the shadow maps, once per cascade
+    Uint64 static_shadow_redraws = 0; /// cascades of the static shadow cache that were redrawn
+
+    Uint64 textures_loaded = 0;
+    Uint64 meshes_loaded   = 0;
+    Uint64 fonts_loaded    = 0;
+    Uint64 uploaded_bytes  = 0; /// static data (textures, meshes) that would be uploaded once
+
+    NullRenderStats& operator+=(const NullRenderStats& other);
+};
+
+
+/*!
+
+    @file null_renderer.h
+    @brief NullRenderer class definition.
+
+    Headless renderer used for CPU-side benchmarks and GPU-less CI. Every entry point does the same CPU work as the real
+    backends (image decoding, mesh parsing, instance batching, text segmentation) but records counts and byte sizes
+    instead of issuing GPU work.
+
+    @note Works with a hidden window or without any window at all (`window` may be null).
+    @version 0.0.1
+
+*/
+class NullRenderer final : public Renderer {
+public:
+    bool initialize(SDL_Window* window) override;
+
+    void clear(glm::vec4 color) override;
+
+    void present() override;
+
+    void* get_context() override {
+        return nullptr;
+    }
+
+    bool set_vsync(VSyncMode mode) override;
+
+    bool load_font(const std::string& name, const std::string& path, int size) override;
+
+    std::shared_ptr<Texture> load_texture(const std::string& name, const std::string& path, const aiTexture* ai_embedded_tex) override;
+
+    std::unique_ptr<Mesh> load_mesh(aiMesh* mesh, const aiScene* scene, const std::string& base_dir) override;
+
+    std::shared_ptr<Model> load_model(const char* path) override;
+
+    void draw_texture(const Transform2D& transform, Texture* texture, const glm::vec4& dest, const glm::vec4& source, bool flip_h,
+                      bool flip_v, const glm::vec4& color) override;
+
+    void draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) override;
+
+    void draw_text_3d(const Transform3D& transform, const glm::mat4& view, const glm::mat4& projection, const glm::vec4& color,
+                      const std::string& font_name, const char* fmt, ...) override;
+
+    void draw_rect(const Transform2D& transform, float w, float h, glm::vec4 color, bool is_filled) override;
+
+    void draw_triangle(const Transform2D& transform, float size, glm::vec4 color, bool is_filled) override;
+
+    void draw_line(const Transform2D& transform, glm::vec2 end, glm::vec4 color) override;
+
+    void draw_circle(const Transform2D& transform, float radius, glm::vec4 color, bool is_filled) override;
+
+    void draw_polygon(const Transform2D& transform, const std::vector<glm::vec2>& points, glm::vec4 color, bool is_filled) override;
+
+    void draw_polygon_triangles(const Transform2D& transform, const std::vector<glm::vec2>& points, const std::vector<int>& triangles,
+                                glm::vec4 color) override;
+
+    void draw_texture_quads(const Transform2D& transform, Texture* texture, const std::vector<glm::vec2>& positions,
+                            const std::vector<glm::vec2>& uvs, const glm::vec4& color) override;
+
+    void draw_particles_2d(const ParticlePool& pool, Texture* texture, const glm::vec4& uv, float size) override;
+
+    void draw_particles_3d(const ParticlePool& pool, float size) override;
+
+    void draw_line_3d(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color) override;
+
+    void draw_triangle_3d(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3, const glm::vec4& color, bool is_filled) override;
+
+    void draw_model(const Transform3D& t, const Model* model, bool is_static = false, int stage = 0) override;
+
+    void draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count,
+                             int animation = -1, int stage = 0) override;
+
+    void draw_mesh(const Transform3D& transform, const MeshInstance3D& cube, const Shader* shader, bool is_static = false,
+                   int stage = 0) override;
+
+    void draw_environment(const glm::mat4& view, const glm::mat4& projection) override;
+
+    void flush(const glm::mat4& view, const glm::mat4& projection) override;
+
+    /*!
+        @brief Work recorded during the last presented frame.
+    */
+    [[nodiscard]] const NullRenderStats& get_frame_stats() const;
+
+    /*!
+        @brief Work recorded since initialization (or the last `reset_stats`), loads included.
+    */
+    [[nodiscard]] const NullRenderStats& get_total_stats() const;
+
+    void reset_stats();
+
+    ~NullRenderer() override = default;
+
+private:
+    NullRenderStats _frame      = {}; /// frame in progress
+    NullRenderStats _last_frame = {};
+    NullRenderStats _total      = {};
+
+    NullMesh _cube_mesh = {}; /// batch key for MeshInstance3D, same as the cube of the other backends
+
+    StaticShadowCache _static_shadows = {}; /// same invalidation as the OpenGL static shadow maps
+
+    void record(const NullRenderStats& stats);
+
+    void record_vertices_2d(Uint64 count);
+
+    std::vector<Tokens> parse_text(const std::string& text) override;
+
+    void draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name, const std::string& text) override;
+
+    std::shared_ptr<Texture> upload_texture(const std::string& name, std::shared_ptr<Texture> texture) override;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core/renderer/base_struct.h"
+
+
+/*!
+
+    @file null_struct.h
+    @brief Null (headless) structures for Texture and Mesh.
+
+    CPU-side data is kept as the other backends keep it, nothing is ever uploaded.
+
+    @version 0.0.1
+
+*/
+class NullTexture final : public Texture {
+public:
+    NullTexture() = default;
+
+    void bind(Uint32 slot = 0) override {
+    }
+
+    bool is_valid() const override {
+        return width > 0 && height > 0;
+    }
+};
+
+
+struct NullMesh final : Mesh {
+    void bind() override {
+    }
+
+    void upload_to_gpu() override {
+    }
+
+    void draw(EDrawMode mode = EDrawMode::TRIANGLES) override {
+    }
+
+    void unbind() override {
+    }
+
+    /// Size of the vertex and index data a GPU backend would upload
+    [[nodiscard]] Uint64 get_size_bytes() const;
+
+protected:
+    void destroy() override {
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/renderer/opengl/ogl_struct.h"
+
+
+/*!
+    @file ogl_batch_2d.h
+    @brief OpenglBatch2D class definition.
+
+    2D pass of the OpenglRenderer, drawn after the 3D pass. Every draw is transformed on the CPU into one world-space
+    vertex array (the Camera2D view and the projection are applied by the shader) and gets its own depth from the
+    submission order. Draws are then split in two:
+
+    - Opaque draws (opaque color, untextured or `OpenglTexture::is_opaque`) are grouped per texture and drawn first with
+      depth test and write. The depth keeps their z order, so they batch regardless of it.
+    - Translucent draws (text, alpha) follow in submission order, depth tested against the opaque ones, merged while the
+      texture does not change.
+
+    Untextured vertices carry a negative u and skip the sampling, so shapes join any batch. The frame is one vertex and
+    one index upload into OpenglStreamBuffers, then a draw call per texture.
+
+    @version 0.0.1
+*/
+
+
+/*!
+    @brief Vertex of the 2D pass, 24 bytes.
+*/
+struct OpenglVertex2D {
+    glm::vec3 position = {0, 0, 0}; /// xy world, z depth (NDC)
+    glm::vec2 uv       = {0, 0};
+    Uint32 color       = 0xFFFFFFFF; /// RGBA8
+};
+
+
+class OpenglBatch2D {
+public:
+    /// Draws per frame with a distinct depth, later ones share the nearest depth
+    static constexpr Uint32 MAX_LAYERS = 1u << 20;
+
+    bool initialize();
+
+    void destroy();
+
+    /*!
+        @brief Adds one draw (a sprite, a shape, a glyph...) above the previous ones.
+        @param texture GL texture name, 0 for untextured geometry
+        @param uvs nullptr for untextured geometry
+        @param indices Relative to `positions`
+    */
+    void push(Uint32 texture, bool is_opaque, const glm::vec2* positions, const glm::vec2* uvs, size_t vertex_count, const int* indices,
+              size_t index_count, glm::vec4 color);
+
+    /*!
+        @brief Adds `quad_count` translucent quads above the previous draws, for geometry built by the caller (particles).
+        @return 4 vertices per quad (TL, TR, BR, BL) to fill: the depth is set, the xy, uv and color are left to the caller
+    */
+    OpenglVertex2D* push_quads(Uint32 texture, size_t quad_count);
+
+    /*!
+        @brief Uploads and draws the frame, then starts a new one.
+    */
+    void flush(const glm::mat4& view, const glm::mat4& projection);
+
+    [[nodiscard]] bool is_empty() const;
+
+    /*!
+        @brief Draw calls issued by the last `flush`.
+    */
+    [[nodiscard]] int get_draw_call_count() const;
+
+    /*!
+        @brief Color as stored in OpenglVertex2D (RGBA8), clamped.
+    */
+    [[nodiscard]] static Uint32 pack_color(glm::vec4 color);
+
+private:
+    struct DrawCommand {
+        Uint32 texture = 0;
+        size_t first   = 0; /// First index
+        size_t count   = 0;
+    };
+
+    /// NDC depth of the next draw, later draws are nearer
+    float next_depth();
+
+    /// Extends the last translucent command or starts a new one
+    void add_translucent(Uint32 texture, size_t index_count);
+
+    void draw(const DrawCommand& command, size_t index_offset, Uint32& bound_texture);
+
+    OpenglShader* _shader = nullptr;
+    Uint32 _vao           = 0;
+
+    OpenglStreamBuffer _vertex_buffer;
+    OpenglStreamBuffer _index_buffer;
+
+    std::vector<OpenglVertex2D> _vertices;
+
+    std::unordered_map<Uint32, std::vector<Uint32>> _opaque; /// Indices per texture, kept allocated across frames
+    std::vector<Uint32> _translucent;
+    std::vector<DrawCommand> _translucent_commands;
+
+    // Reused by `flush`
+    std::vector<Uint32> _upload_indices;
+    std::vector<DrawCommand> _opaque_commands;
+
+    Uint32 _layer    = 0;
+    int _draw_calls  = 0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core/component/logic/particle_pool.h"
+#include "core/renderer/opengl/ogl_struct.h"
+
+
+/*!
+    @file ogl_particles.h
+    @brief OpenglParticles class definition.
+
+    3D particle pass of the OpenglRenderer, drawn after the environment. Pools are copied at submission into one array
+    of 20 bytes instances (position, size, RGBA8 color), uploaded once into an OpenglStreamBuffer and drawn with a single
+    instanced call: the quad corners come from `gl_VertexID` and are turned towards the camera by the vertex shader.
+
+    Particles are blended over the scene, depth tested but not written, in submission order (no sorting).
+
+    @version 0.0.1
+*/
+
+
+/*!
+    @brief Instance of the particle pass, 20 bytes.
+*/
+struct OpenglParticleInstance {
+    glm::vec3 position = {0, 0, 0};
+    float size         = 1;
+    Uint32 color       = 0xFFFFFFFF; /// RGBA8
+};
+
+
+class OpenglParticles {
+public:
+    bool initialize();
+
+    void destroy();
+
+    /*!
+        @brief Copies the live particles of `pool`, not thread-safe (the renderer holds its batch mutex).
+    */
+    void push(const ParticlePool& pool, float size);
+
+    /*!
+        @brief Uploads and draws the particles pushed since the last flush.
+    */
+    void flush(const glm::mat4& view, const glm::mat4& projection);
+
+    /*!
+        @brief Particles drawn by the last `flush`.
+    */
+    [[nodiscard]] size_t get_instance_count() const;
+
+private:
+    OpenglShader* _shader = nullptr;
+    Uint32 _vao           = 0;
+
+    OpenglStreamBuffer _instance_buffer;
+
+    std::vector<OpenglParticleInstance> _instances;
+
+    size_t _drawn = 0;
+};
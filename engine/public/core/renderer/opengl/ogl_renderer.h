@@ -1,9 +1,21 @@
 #pragma once
 
+#include "core/renderer/opengl/ogl_batch_2d.h"
+#include "core/renderer/opengl/ogl_particles.h"
 #include "core/renderer/opengl/ogl_struct.h"
 #include "core/renderer/renderer.h"
 
 
+/*!
+    @file ogl_renderer.h
+    @brief OpenglRenderer class definition.
+
+    2D draws (sprites, shapes, text) are not drawn immediately: they are collected by an OpenglBatch2D and drawn in
+    `present()`, over the 3D pass, with the Camera2D view. Opaque sprites are batched per texture whatever their z order,
+    translucent ones keep the submission order (see `ogl_batch_2d.h`).
+
+    @version 0.0.1
+*/
 class OpenglRenderer final : public Renderer {
 public:
     bool initialize(SDL_Window* window) override;
@@ -16,9 +28,11 @@ public:
         return _context;
     }
 
+    bool set_vsync(VSyncMode mode) override;
+
     bool load_font(const std::string& name, const std::string& path, int size) override;
 
-    std::shared_ptr<Texture> load_texture(const std::string& name, const std::string& path, const aiTexture* ai_embedded_tex);
+    std::shared_ptr<Texture> load_texture(const std::string& name, const std::string& path, const aiTexture* ai_embedded_tex) override;
     
     std::unique_ptr<Mesh> load_mesh(aiMesh* mesh, const aiScene* scene, const std::string& base_dir) override;
 
@@ -26,8 +40,6 @@ public:
                       bool flip_v, const glm::vec4& color) override;
 
 
-    void draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) override;
-
     void draw_text_3d(const Transform3D& transform, const glm::mat4& view, const glm::mat4& projection, const glm::vec4& color,
                       const std::string& font_name, const char* fmt, ...) override;
 
@@ -41,6 +53,16 @@ public:
 
     void draw_polygon(const Transform2D& transform, const std::vector<glm::vec2>& points, glm::vec4 color, bool is_filled) override;
 
+    void draw_polygon_triangles(const Transform2D& transform, const std::vector<glm::vec2>& points, const std::vector<int>& triangles,
+                                glm::vec4 color) override;
+
+    void draw_texture_quads(const Transform2D& transform, Texture* texture, const std::vector<glm::vec2>& positions,
+                            const std::vector<glm::vec2>& uvs, const glm::vec4& color) override;
+
+    void draw_particles_2d(const ParticlePool& pool, Texture* texture, const glm::vec4& uv, float size) override;
+
+    void set_view_2d(const glm::mat4& view) override;
+
     void draw_line_3d(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color) override;
 
     void draw_triangle_3d(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3, const glm::vec4& color, bool is_filled) override;
@@ -49,20 +71,41 @@ public:
 
     ~OpenglRenderer() override;
 
-    void draw_model(const Transform3D& t, const Model* model) override;
+    void draw_model(const Transform3D& t, const Model* model, bool is_static = false, int stage = 0) override;
 
-    void draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count) override;
+    void draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count,
+                             int animation = -1, int stage = 0) override;
 
-    void draw_mesh(const Transform3D& transform, const MeshInstance3D& cube, const Shader* shader) override;
+    void draw_mesh(const Transform3D& transform, const MeshInstance3D& cube, const Shader* shader, bool is_static = false,
+                   int stage = 0) override;
+
+    void draw_particles_3d(const ParticlePool& pool, float size) override;
 
     void draw_environment(const glm::mat4& view, const glm::mat4& projection) override;
 
     std::shared_ptr<Model> load_model(const char* path) override;
 
+    /*!
+        @brief GPU time of the shadow, main and environment passes (and batches if enabled) of the last resolved frame.
+    */
+    [[nodiscard]] const OpenglGpuTimer& get_gpu_timer() const;
+
+    /*!
+        @brief Draw calls of the last 2D pass.
+    */
+    [[nodiscard]] int get_batch_2d_draw_calls() const;
+
 
 private:
     SDL_GLContext _context = nullptr;
 
+    OpenglGpuTimer _gpu_timer = {};
+
+    /// Per-batch GPU zone names ("batch/<mesh>"), interned once per mesh
+    std::unordered_map<const Mesh*, const char*> _batch_zone_names;
+
+    const char* get_batch_zone_name(const Mesh* mesh);
+
     void setup_default_shaders();
 
     void setup_cubemap();
@@ -74,10 +117,70 @@ private:
     OpenglShader* skybox_shader  = nullptr;
     OpenglShader* shadow_shader  = nullptr;
 
+    OpenglBatch2D _batch_2d;
+    OpenglParticles _particles_3d;
+
+    OpenglInstanceArena _instance_arena;
+    std::vector<OpenglInstance3D> _instance_staging; /// Instances of every batch, in batch order
+    size_t _instance_base = 0;                       /// Arena offset of the instances of the frame
+
+    /*!
+        @brief Writes the instances of every batch into the frame arena, grouped so each pass draws one range per batch.
+    */
+    void upload_instances();
+
+    /*!
+        @brief Binds the VAO of `ogl_mesh` with its instance attributes starting at `first_instance` of the frame.
+        The pointers are only specified again when the range moved.
+    */
+    void bind_instances(OpenglMesh* ogl_mesh, size_t first_instance);
+
+    Uint32 _bone_texture     = 0; /// RGBA32F, 3 texels per bone, see `Renderer::add_bone_palette`
+    int _bone_texture_height = 0;
+
+    /*!
+        @brief Uploads the bone palette of the frame, grows the texture by rows when it is too small.
+    */
+    void upload_bone_palette();
+
+    StaticShadowCache _static_shadows = {}; /// Cascades of the static shadow maps that are up to date
+
+    /*!
+        @brief Draws the static or the dynamic shadow range of every batch into the attached cascade layer.
+    */
+    void draw_shadow_casters(bool is_static);
+
+    glm::vec4 _clear_color = {0, 0, 0, 1};
+    bool _is_frame_cleared = false; /// The 3D pass cleared the frame, see `present`
+    float _view_scale_2d   = 1.0f; /// Uniform part of the Camera2D zoom, keeps outlines 1px wide
+
+    // Reused by the 2D draws, avoids allocating per call
+    std::vector<glm::vec2> _scratch_points;
+    std::vector<int> _scratch_indices;
+    std::vector<int> _scratch_triangles;
+    std::vector<glm::vec2> _outline_positions;
+    std::vector<int> _outline_indices;
+
+    /*!
+        @brief Adds the closed outline through the world `points` to the 2D batch, 1px wide on screen.
+    */
+    void push_outline(const glm::vec2* points, size_t count, glm::vec4 color);
+
+    /*!
+        @brief Adds untextured geometry to the 2D batch.
+    */
+    void push_shape(const glm::vec2* points, size_t count, const int* indices, size_t index_count, glm::vec4 color);
+
 protected:
 
 
     std::vector<Tokens> parse_text(const std::string& text) override;
 
-    void draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name, const std::string& text) override;
+    std::shared_ptr<Texture> upload_texture(const std::string& name, std::shared_ptr<Texture> texture) override;
+
+    std::unique_ptr<Texture> create_glyph_page(int size) override;
+
+    void update_glyph_page(Texture* page, const SDL_Rect& rect, const void* pixels, int pitch) override;
+
+    void push_glyph_quad(Texture* page, const glm::vec2* positions, const glm::vec2* uvs, const glm::vec4& color) override;
 };
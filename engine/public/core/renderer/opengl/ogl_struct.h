@@ -1,5 +1,6 @@
 #pragma once
 #include "core/renderer/base_struct.h"
+#include "core/system/profiler.h"
 
 
 class OpenglShader final : public Shader {
@@ -94,6 +95,101 @@ public:
 
     void bind(Uint32 slot = 0) override;
 
+    bool is_opaque = true; /// Every texel is fully opaque or fully transparent, see OpenglBatch2D
+};
+
+
+/*!
+    @brief GPU buffer streamed every frame, its memory is reused as a ring.
+
+    Each write lands after the previous one through an unsynchronized mapping, so the CPU never waits for the GPU
+    reading older ranges. When the ring is full the buffer is orphaned, the driver hands a fresh block while the old one
+    is still in use. Requests larger than the ring grow it.
+
+    @version 0.0.1
+*/
+class OpenglStreamBuffer {
+public:
+    /*!
+        @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+    */
+    void initialize(Uint32 target, size_t capacity);
+
+    /*!
+        @brief Copies `size` bytes into the ring, the buffer is left bound.
+        @return Byte offset of the data in the buffer
+    */
+    size_t write(const void* data, size_t size);
+
+    void bind() const;
+
+    void destroy();
+
+    [[nodiscard]] Uint32 get_id() const;
+
+    [[nodiscard]] size_t get_capacity() const;
+
+private:
+    Uint32 _target   = 0;
+    Uint32 _id       = 0;
+    size_t _capacity = 0;
+    size_t _head     = 0;
+};
+
+/*!
+    @brief Per instance attributes of the 3D batches, 76 bytes: model matrix (locations 3-6) and color (location 7).
+*/
+struct OpenglInstance3D {
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec3 color = {1, 1, 1};
+    Sint32 bone_offset = -1; /// First bone in the frame bone palette, -1 if not skinned
+};
+
+/*!
+    @brief Instance data of a frame, uploaded once and read by every pass of the frame.
+
+    The buffer is split in `FRAME_COUNT` regions used in turn (triple buffering). A region is only written again once
+    the fence of the frame that read it has signaled, so the upload needs neither orphaning nor a synchronized mapping,
+    and the CPU only waits when the GPU is frames behind. Without fences (WebGL, whose client waits cannot block) the
+    buffer is orphaned when the regions wrap around instead. A frame larger than a region grows them all.
+
+    @version 0.0.1
+*/
+class OpenglInstanceArena {
+public:
+    static constexpr int FRAME_COUNT = 3;
+
+    void initialize(size_t frame_capacity);
+
+    /*!
+        @brief Copies the instances of a frame into the next region, the buffer is left bound to GL_ARRAY_BUFFER.
+        @return Byte offset of the data in the buffer
+    */
+    size_t upload(const void* data, size_t size);
+
+    /*!
+        @brief Fences the region of the last upload, call once the draws reading it are issued.
+    */
+    void end_frame();
+
+    void destroy();
+
+    [[nodiscard]] Uint32 get_id() const;
+
+    /*!
+        @brief Bytes a frame can upload without growing the buffer.
+    */
+    [[nodiscard]] size_t get_frame_capacity() const;
+
+private:
+    void release_fences();
+
+    Uint32 _id             = 0;
+    size_t _frame_capacity = 0;
+    int _region            = -1; /// Region of the last upload
+    bool _has_fences       = false;
+
+    GLsync _fences[FRAME_COUNT] = {};
 };
 
 class OpenglMesh : public Mesh {
@@ -101,7 +197,10 @@ public:
     Uint32 vao        = 0;
     Uint32 vbo        = 0;
     Uint32 ebo        = 0;
-    
+
+    // Instance attributes of the VAO (see OpenglInstanceArena): enabled once, pointed at the frame data when it moves
+    bool has_instance_layout = false;
+    size_t instance_offset   = SIZE_MAX;
 
     // Skinning support
     Uint32 bone_id_vbo     = 0;  // VBO for bone IDs (ivec4)
@@ -120,3 +219,91 @@ public:
 
     ~OpenglMesh();
 };
+
+
+/*!
+    @brief GPU time of a zone, resolved a few frames after it was recorded.
+
+    @version 0.0.1
+*/
+struct GpuZoneResult {
+    const char* name   = nullptr;
+    Uint64 duration_ns = 0;
+    Uint32 depth       = 0;
+};
+
+/*!
+
+    @brief GPU pass timing with `glQueryCounter(GL_TIMESTAMP)`.
+
+    Zones are bracketed by two timestamp queries (so they can nest, unlike `GL_TIME_ELAPSED`). Queries live in a ring of
+    `QUERY_FRAMES` frames and are only read back once `GL_QUERY_RESULT_AVAILABLE` says so, a frame whose results are still
+    pending when its slot is reused is dropped instead of stalling the pipeline.
+
+    Resolved zones are sent to the Profiler on the "GPU" track, next to the CPU zones.
+
+    @note Not available on GLES 3.0 (no timer queries in core).
+    @version 0.0.1
+
+*/
+class OpenglGpuTimer {
+public:
+    static constexpr int QUERY_FRAMES = 4;
+    static constexpr int MAX_ZONES    = 128; /// per frame
+
+    bool initialize();
+
+    [[nodiscard]] bool is_supported() const;
+
+    /*!
+        @brief Reads back the oldest frame of the ring (if ready) and starts recording a new one.
+    */
+    void begin_frame();
+
+    /*!
+        @param name Must outlive the profiler (string literal or `Profiler::intern`)
+    */
+    void begin_zone(const char* name);
+
+    void end_zone();
+
+    /*!
+        @brief Zones of the most recently resolved frame.
+    */
+    [[nodiscard]] const std::vector<GpuZoneResult>& get_last_results() const;
+
+    void destroy();
+
+    ~OpenglGpuTimer();
+
+private:
+    struct Zone {
+        const char* name = nullptr;
+        Uint32 depth     = 0;
+        Uint32 begin_query = 0;
+        Uint32 end_query   = 0;
+    };
+
+    struct Frame {
+        std::vector<Zone> zones;
+        int used      = 0;
+        bool has_data = false;
+    };
+
+    void resolve(Frame& frame);
+
+    void calibrate();
+
+    bool _is_supported = false;
+    bool _is_recording = false; /// follows `Profiler::is_enabled` at the start of each frame
+
+    Frame _frames[QUERY_FRAMES];
+    int _frame_index = 0;
+
+    std::vector<int> _open; /// indices of zones not closed yet
+
+    Sint64 _gpu_to_cpu_ns = 0; /// offset between the GL and SDL clocks
+    Uint64 _frame_count   = 0;
+
+    std::vector<GpuZoneResult> _last_results;
+};
@@ -2,7 +2,11 @@
 
 #include "core/component/logic/system_logic.h"
 #include "core/ember_utils.h"
+#include "core/project_config.h"
 #include "core/renderer/base_struct.h"
+#include "core/renderer/shadow_cascades.h"
+#include "core/renderer/text_layout.h"
+#include "core/renderer/texture_atlas.h"
 
 
 /*!
@@ -18,14 +22,38 @@ struct InstancedBatch {
     EDrawMode mode = EDrawMode::TRIANGLES;
     EDrawCommand command = EDrawCommand::MODEL;
     
-    const glm::mat4* bone_transforms = nullptr;  /// Pointer to bone transforms (if has animation/bones)
-    int bone_count = 0;                          /// Number of bones
+    std::vector<Sint32> bone_offsets;            /// First palette bone of each instance, -1 if not skinned (see `Renderer::add_bone_palette`)
+    std::vector<Uint8> passes;                   /// RENDER_PASS_* of each instance, empty when every instance is drawn in every pass
+    size_t static_first   = 0;                   /// Offset of the static shadow range, drawn only into the cached maps (OpenGL)
+    size_t static_count   = 0;                   /// Instances of the static shadow range (OpenGL)
+    size_t first_instance = 0;                   /// Offset of the batch in the frame instance data, main pass range (OpenGL)
+    size_t main_count     = 0;                   /// Instances of the main pass range (OpenGL)
+    size_t shadow_first   = 0;                   /// Offset of the dynamic shadow range, overlaps the main one (OpenGL)
+    size_t shadow_count   = 0;                   /// Instances of the dynamic shadow range (OpenGL)
 };
 
-
-struct GpuBuffer {
-    Uint32 instance_buffer = 0;
-    Uint32 color_buffer = 0;
+/*!
+    @brief 3D submissions of one flecs stage (worker thread), merged into the frame batches by the flush.
+    A worker only writes to its own stage, the submit systems take no lock.
+*/
+struct RenderStage {
+    std::unordered_map<const Mesh*, InstancedBatch> batches;
+    std::vector<glm::vec4> bone_palette; /// Bone offsets of `batches` start at 0 in this palette until the merge
+    Uint64 static_signature = 0;         /// See `Renderer::add_static_caster`
+
+    Material mesh_material = {};    /// Last MeshInstance3D material, the backends set it on their shared cube at flush
+    bool has_mesh_material = false;
+
+    Uint64 draw_calls = 0; /// 3D draw calls received, for the backends reporting them (NullRenderer)
+
+    void clear() {
+        batches.clear();
+        bone_palette.clear();
+        static_signature  = 0;
+        mesh_material     = {};
+        has_mesh_material = false;
+        draw_calls        = 0;
+    }
 };
 
 /*!
@@ -45,11 +73,33 @@ public:
 
     virtual void* get_context() = 0;
 
+    /*!
+        @brief Applies the swap interval for the given vsync mode.
+
+        @note Adaptive sync falls back to regular vsync when the driver doesn't support it.
+        @return true if the mode was applied.
+    */
+    virtual bool set_vsync(VSyncMode mode) {
+        LOG_WARN("set_vsync not implemented for this renderer");
+        return false;
+    }
+
     void set_default_fonts(const std::string& text_font, const std::string& emoji_font);
 
     virtual bool load_font(const std::string& name, const std::string& path, int size = 16) = 0;
 
-    std::shared_ptr<Texture> load_texture(const std::string& name, const std::string& path = "", const aiTexture* ai_embedded_tex = nullptr);
+    virtual std::shared_ptr<Texture> load_texture(const std::string& name, const std::string& path = "", const aiTexture* ai_embedded_tex = nullptr);
+
+    /*!
+        @brief Uploads RGBA8 pixels as a named texture, returns the existing one if `name` is already loaded.
+        @param pixels Allocated with malloc/calloc, the renderer takes ownership and frees it
+    */
+    std::shared_ptr<Texture> create_texture(const std::string& name, int width, int height, unsigned char* pixels);
+
+    /*!
+        @brief Shared pages small sprite textures are packed into, see `texture_atlas.h`.
+    */
+    TextureAtlas& get_texture_atlas();
     
     
     virtual std::unique_ptr<Mesh> load_mesh(aiMesh* mesh, const aiScene* scene, const std::string& base_dir) {
@@ -62,7 +112,11 @@ public:
                               bool flip_h = false, bool flip_v = false, const glm::vec4& color = glm::vec4(1, 1, 1, 1)) = 0;
 
 
-    virtual void draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) = 0;
+    /*!
+        @brief Draws the text through the cached layouts of `text_layout.h`.
+        @param font_name Font of every run, empty to use the default (and emoji) fonts
+    */
+    virtual void draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...);
 
     virtual void draw_text_3d(const Transform3D& transform, const glm::mat4& view, const glm::mat4& projection, const glm::vec4& color,
                               const std::string& font_name, const char* fmt, ...) {
@@ -92,26 +146,93 @@ public:
     virtual void draw_polygon(const Transform2D& transform, const std::vector<glm::vec2>& points, glm::vec4 color = glm::vec4(1, 1, 1, 1),
                               bool is_filled = false) = 0;
 
+    /*!
+        @brief Draws a filled polygon already triangulated, see `triangulate_polygon`.
+        @param triangles 3 indices into `points` per triangle
+    */
+    virtual void draw_polygon_triangles(const Transform2D& transform, const std::vector<glm::vec2>& points, const std::vector<int>& triangles,
+                                        glm::vec4 color = glm::vec4(1, 1, 1, 1)) {
+        draw_polygon(transform, points, color, true);
+    }
+
+    /*!
+        @brief Draws textured quads sharing one texture as a single submission, e.g. a TileMap2D chunk.
+        @param positions 4 corners per quad (TL, TR, BR, BL), local to the transform (scaled, rotated, then moved)
+        @param uvs Normalized texture coordinates, one per position
+    */
+    virtual void draw_texture_quads(const Transform2D& transform, Texture* texture, const std::vector<glm::vec2>& positions,
+                                    const std::vector<glm::vec2>& uvs, const glm::vec4& color = glm::vec4(1, 1, 1, 1)) = 0;
+
+    /*!
+        @brief Draws the live particles of a pool as quads of `size` centered on their world positions, one submission.
+        @param texture Optional, `uv` is then the normalized rect (x, y, w, h) drawn on every quad
+    */
+    virtual void draw_particles_2d(const ParticlePool& pool, Texture* texture, const glm::vec4& uv, float size) = 0;
+
+    /*!
+        @brief View of the active Camera2D, applied to the 2D draws that follow (see `Camera2D::get_view`).
+    */
+    virtual void set_view_2d(const glm::mat4& view) {
+        _view_2d = view;
+    }
+
+    /*!
+        @brief Number of flecs stages submitting 3D draws, see `flecs::world::get_stage_count`.
+        Called on the main thread while no system runs.
+    */
+    void set_stage_count(int count);
+
+    /*!
+        @brief View and projection of the 3D camera of the frame, set before the models are submitted.
+        Updates the camera and light frustums the submitted instances are culled against.
+    */
+    void set_view_3d(const glm::mat4& view, const glm::mat4& projection);
+
+    /*!
+        @brief Whether a world-space box overlaps the last 3D view (see `set_view_3d`), always true before the first one.
+        Conservative: a box crossing a frustum corner may be reported visible.
+    */
+    [[nodiscard]] bool is_box_visible_3d(const glm::vec3& min, const glm::vec3& max) const;
+
     virtual ~Renderer() = default;
 
     virtual void flush(const glm::mat4& view, const glm::mat4& projection) {
         LOG_WARN("flush not implemented for this renderer");
     }
 
-    virtual void draw_model(const Transform3D& t, const Model* model) {
+    /*!
+        @param is_static The model never moves (`tags::Static`), its shadow can be cached
+        @param stage `flecs::world::get_stage_id` of the calling system, each worker fills its own `RenderStage`
+    */
+    virtual void draw_model(const Transform3D& t, const Model* model, bool is_static = false, int stage = 0) {
         LOG_WARN("draw_model not implemented for this renderer");
     }
 
-       virtual void draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count){
+    /*!
+        @brief Draws the skinned meshes of `model` posed with `bone_transforms`.
+        @param animation Clip being played, selects the bounds the model is culled with (-1: bind pose bounds)
+        @param stage See `draw_model`
+    */
+    virtual void draw_animated_model(const Transform3D& t, const Model* model, const glm::mat4* bone_transforms, int bone_count,
+                                     int animation = -1, int stage = 0) {
         LOG_WARN("draw_animated_model not implemented for this renderer");
     }
     
     // TODO: add shader parameter
-    virtual void draw_mesh(const Transform3D& transform, const MeshInstance3D& cube, const Shader* shader = nullptr) {
+    virtual void draw_mesh(const Transform3D& transform, const MeshInstance3D& cube, const Shader* shader = nullptr, bool is_static = false,
+                           int stage = 0) {
         LOG_WARN("draw_cube not implemented for this renderer");
     }
 
  
+    /*!
+        @brief Draws the live particles of a pool as camera facing billboards of `size` in the next flush.
+        @note Thread-safe, the particles are copied, the pool can be updated again right after.
+    */
+    virtual void draw_particles_3d(const ParticlePool& pool, float size) {
+        LOG_WARN("draw_particles_3d not implemented for this renderer");
+    }
+
     virtual void draw_environment(const glm::mat4& view, const glm::mat4& projection) {
         LOG_WARN("draw_environment not implemented for this renderer");
     }
@@ -125,8 +246,127 @@ protected:
 
     virtual std::vector<Tokens> parse_text(const std::string& text) = 0;
 
-    virtual void draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name,
-                                    const std::string& text) = 0;
+    virtual void draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name, const std::string& text);
+
+    /*!
+        @brief Backend texture of `size` x `size` RGBA8 texels, all transparent, glyphs are packed into.
+        @return nullptr if the page cannot be created, texts are then drawn without glyphs
+    */
+    virtual std::unique_ptr<Texture> create_glyph_page(int size) {
+        LOG_WARN("create_glyph_page not implemented for this renderer");
+        return nullptr;
+    }
+
+    /*!
+        @brief Copies a rasterized glyph into `rect` of a page of `create_glyph_page`.
+        @param pixels RGBA32 (bytes R, G, B, A), `pitch` bytes per row
+    */
+    virtual void update_glyph_page(Texture* page, const SDL_Rect& rect, const void* pixels, int pitch) {
+    }
+
+    /*!
+        @brief Adds one glyph quad to the 2D batch, glyph edges are antialiased so it is always translucent.
+        @param positions 4 corners (TL, TR, BR, BL), in world space before the 2D view
+        @param uvs Normalized page coordinates, one per position
+    */
+    virtual void push_glyph_quad(Texture* page, const glm::vec2* positions, const glm::vec2* uvs, const glm::vec4& color) {
+    }
+
+    /*!
+        @brief Cached layout of `text`, laid out on first use (or after being evicted).
+    */
+    const TextLayout& get_text_layout(const std::string& font_name, std::string_view text);
+
+    void draw_text_layout(const glm::vec2& pos, const glm::vec4& color, const TextLayout& layout);
+
+    /*!
+        @brief Ends the frame of the text cache, drops the layouts not drawn during the last frames.
+        Called by the backends in `present()`.
+    */
+    void advance_text_frame();
+
+    /*!
+        @brief Drops the layouts and the glyph pages, called by the backends before their context is destroyed.
+    */
+    void clear_text_cache();
+
+    /*!
+        @brief Backend texture object holding decoded pixels, not uploaded yet.
+    */
+    std::shared_ptr<Texture> make_texture(int width, int height, unsigned char* pixels, const std::string& path) const;
+
+    /*!
+        @brief Uploads `texture->pixels`, frees them and caches the texture under `name`.
+    */
+    virtual std::shared_ptr<Texture> upload_texture(const std::string& name, std::shared_ptr<Texture> texture);
+
+    TextureAtlas _texture_atlas;
+
+    glm::mat4 _view_2d = glm::mat4(1.0f);
+
+    /*!
+        @brief Stage of a submit system, nullptr (logged) when `stage` is not a stage of the world.
+    */
+    RenderStage* get_stage(int stage);
+
+    /*!
+        @brief Appends the skinning matrices of one animated instance to the palette of `stage`, 3 rows of a mat3x4 per bone.
+        Only the bones used by the skinned meshes of `model` are kept.
+        @return First bone of the instance in the stage palette
+    */
+    Sint32 add_bone_palette(RenderStage& stage, const Model* model, const glm::mat4* bone_transforms, int bone_count);
+
+    /*!
+        @brief Adds an instance of `mesh` to its batch in `stage`, `bone_offset` -1 when it is not skinned.
+        `passes` may carry `RENDER_PASS_STATIC`, it is dropped when the instance casts no shadow.
+    */
+    InstancedBatch& add_instance(RenderStage& stage, Mesh* mesh, const glm::mat4& model, const glm::vec3& color, Sint32 bone_offset = -1,
+                                 Uint8 passes = RENDER_PASS_ALL);
+
+    /*!
+        @brief Moves the submissions of every stage into `_instanced_batches` and `_bone_palette`, rebasing the bone offsets.
+        Called by the flush, on the main thread.
+    */
+    void merge_stages();
+
+    /*!
+        @brief Drops the submissions of the frame, merged or not.
+    */
+    void clear_stages();
+
+    /*!
+        @brief Passes (`RENDER_PASS_*`) in which a mesh space box drawn with `matrix` is visible, 0 when it is culled in all of them.
+        An empty box is always visible. Thread-safe, only reads the frustums of `set_view_3d`.
+    */
+    [[nodiscard]] Uint8 get_visible_passes(const BoundingBox& bounds, const glm::mat4& matrix) const;
+
+    /*!
+        @brief Visible passes of each mesh of `model`, after a test of the whole model; the meshes are tested 4 at a time.
+        @param passes One entry per mesh of `model`
+        @return Passes of the whole model, 0 when no mesh is visible
+    */
+    Uint8 cull_meshes(const Model* model, const glm::mat4& matrix, Uint8* passes) const;
+
+    /*!
+        @brief Adds a static caster to the signature of `stage`, culled or not (a cached cascade may still show it).
+        The signature is a sum, it does not depend on the submit order nor on the stage.
+    */
+    void add_static_caster(RenderStage& stage, const void* source, const glm::mat4& matrix);
+
+    /// One per flecs stage, see `set_stage_count`
+    std::vector<RenderStage> _stages = std::vector<RenderStage>(1);
+
+    /// Static casters of the merged stages, compared with `StaticShadowCache::signature`
+    Uint64 _static_caster_signature = 0;
+
+    /// Skinning palettes of every animated instance of the frame (mat3x4 rows), consumed by the flush
+    std::vector<glm::vec4> _bone_palette;
+
+    Frustum _view_frustum_3d;  /// Camera of the frame, main pass
+    Frustum _light_frustum_3d; /// Every shadow cascade, shadow pass
+
+    ShadowCascades _shadow_cascades;             /// Fitted to the camera by `set_view_3d`
+    glm::vec3 _light_direction_3d = {0, -1, 0}; /// Direction the sun light comes from
 
 
     // TODO: consider using resource manager for models, textures, fonts
@@ -139,8 +379,20 @@ protected:
     std::string _default_font_name;
     std::string _emoji_font_name;
 
-    // batching/instancing
+    std::unordered_map<TTF_Font*, std::unique_ptr<GlyphAtlas>> _glyph_atlases;
+    std::unordered_map<std::string, TextLayout> _text_layouts; /// Keyed by font name + text
+    std::string _text_key; /// Lookup key buffer, reused across calls
+
+    Uint64 _text_frame_index = 0;
+
+    // batching/instancing, filled from `_stages` by `merge_stages`
     std::unordered_map<const Mesh*, InstancedBatch> _instanced_batches;
 
-    std::unordered_map<const Mesh*, GpuBuffer> _buffers;
+    /// Guards the particle submissions, draw_particles_3d is called from multi-threaded systems
+    std::mutex _batch_mutex;
+
+private:
+    friend class GlyphAtlas; // Creates and fills its pages through the backend
+
+    GlyphAtlas* get_glyph_atlas(const std::string& font_name);
 };
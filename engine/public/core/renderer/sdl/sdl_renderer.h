@@ -12,6 +12,20 @@
 
     This file contains the definition of the SDLRenderer class, which is a concrete implementation of the Renderer interface using the SDL library for rendering operations.
 
+    Filled shapes and sprites are not drawn immediately: consecutive submissions sharing the same texture and blend
+    mode are transformed on the CPU into one vertex/index array and drawn with a single `SDL_RenderGeometry`. The
+    batch is flushed when the state changes, before any unbatched draw (lines) and in `present()`, so the submission
+    order (z order) is preserved.
+
+    The Camera2D view is applied on the CPU to the vertices entering the batch, outlines are built after it so they
+    stay 1px wide whatever the zoom.
+
+    Circles are tessellated from cached unit circles whose segment count follows the on-screen radius, and outlines
+    are 1px triangle strips, so a scene of circles and outlined shapes still ends up in a single batch.
+
+    Text goes through the same batch: glyphs live in per-font atlas pages and each drawn text keeps its layout
+    (see `text_layout.h`), so a label costs no texture creation and no re-layout while its text is unchanged.
+
     @note This renderer is mainly intended for 2D rendering. For 3D rendering, consider using other backends.
     @version 0.0.1
 
@@ -28,17 +42,17 @@ public:
         return (void*)_renderer;
     }
 
+    bool set_vsync(VSyncMode mode) override;
+
     bool load_font(const std::string& name, const std::string& path, int size) override;
     
-    std::shared_ptr<Texture> load_texture(const std::string& name, const std::string& path,const aiTexture* ai_embedded_tex);
+    std::shared_ptr<Texture> load_texture(const std::string& name, const std::string& path,const aiTexture* ai_embedded_tex) override;
 
     void draw_texture(const Transform2D& transform, Texture* texture, const glm::vec4& dest, const glm::vec4& source,
                       bool flip_h, bool flip_v, const glm::vec4& color) override;
 
     void flush(const glm::mat4& view, const glm::mat4& projection) override;
     
-    void draw_text(const Transform2D& transform, const glm::vec4& color, const std::string& font_name, const char* fmt, ...) override;
-
     void draw_line(const Transform2D& transform, glm::vec2 end, glm::vec4 color) override;
 
     void draw_rect(const Transform2D& transform, float w, float h, glm::vec4 color, bool is_filled) override;
@@ -49,15 +63,85 @@ public:
 
     void draw_polygon(const Transform2D& transform, const std::vector<glm::vec2>& points, glm::vec4 color, bool is_filled) override;
 
+    void draw_polygon_triangles(const Transform2D& transform, const std::vector<glm::vec2>& points, const std::vector<int>& triangles,
+                                glm::vec4 color) override;
+
+    void draw_texture_quads(const Transform2D& transform, Texture* texture, const std::vector<glm::vec2>& positions,
+                            const std::vector<glm::vec2>& uvs, const glm::vec4& color) override;
+
+    void draw_particles_2d(const ParticlePool& pool, Texture* texture, const glm::vec4& uv, float size) override;
+
+    void set_view_2d(const glm::mat4& view) override;
+
+    /*!
+        @brief Draws the pending batch with one `SDL_RenderGeometry`, no-op if empty.
+    */
+    void flush_batch();
+
+    /*!
+        @brief Number of `SDL_RenderGeometry` batches submitted during the last presented frame.
+    */
+    [[nodiscard]] int get_batch_count() const;
+
     ~SDLRenderer() override;
 
 
 private:
+    struct GeometryBatch {
+        SDL_Texture* texture     = nullptr; /// nullptr for untextured shapes
+        SDL_BlendMode blend_mode = SDL_BLENDMODE_NONE;
+
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+    };
+
     SDL_Window* _window     = nullptr;
     SDL_Renderer* _renderer = nullptr;
 
+    GeometryBatch _batch;
+
+    // 2D part of `_view_2d`: screen = linear * world + translation
+    glm::mat2 _view_linear      = glm::mat2(1.0f);
+    glm::vec2 _view_translation = {0, 0};
+    float _view_scale           = 1.0f; /// Uniform part of the zoom, for the circle level of detail
+    bool _is_view_identity      = true;
+
+    int _batch_count            = 0;
+    int _last_frame_batch_count = 0;
+
+    // Reused by the shape draws, avoids allocating per call
+    std::vector<SDL_Vertex> _scratch_vertices;
+    std::vector<int> _scratch_indices;
+    std::vector<SDL_FPoint> _scratch_points;
+    std::vector<int> _scratch_triangles;
+
+    std::vector<glm::vec2> _outline_points;
+    std::vector<glm::vec2> _outline_positions;
+    std::vector<SDL_Vertex> _outline_vertices;
+    std::vector<int> _outline_indices;
+
+    /*!
+        @brief Appends geometry to the current batch, flushing first if the texture or blend mode differs.
+        @param indices Relative to `vertices`
+        @param is_screen_space true if the vertices already went through the 2D view
+    */
+    void push_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count,
+                       bool is_screen_space = false);
+
+    [[nodiscard]] SDL_FPoint to_screen(SDL_FPoint point) const;
+
+    /*!
+        @brief Appends the closed outline through `points` as a 1px wide strip to the batch.
+    */
+    void push_outline(const SDL_FPoint* points, int count, glm::vec4 color);
 
     std::vector<Tokens> parse_text(const std::string& text) override;
 
-    void draw_text_internal(const glm::vec2& pos, const glm::vec4& color, const std::string& font_name, const std::string& text) override;
+    std::shared_ptr<Texture> upload_texture(const std::string& name, std::shared_ptr<Texture> texture) override;
+
+    std::unique_ptr<Texture> create_glyph_page(int size) override;
+
+    void update_glyph_page(Texture* page, const SDL_Rect& rect, const void* pixels, int pitch) override;
+
+    void push_glyph_quad(Texture* page, const glm::vec2* positions, const glm::vec2* uvs, const glm::vec4& color) override;
 };
@@ -24,6 +24,11 @@ public:
 
     SDL_Texture* get_texture() const;
 
+    /*!
+        @brief Takes ownership of `texture`, destroys the previous one.
+    */
+    void set_texture(SDL_Texture* texture);
+
 private:
     SDL_Texture* _texture = nullptr;
 };
\ No newline at end of file
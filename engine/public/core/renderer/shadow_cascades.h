@@ -0,0 +1,59 @@
+#pragma once
+
+#include "stdafx.h"
+#include "core/project_config.h"
+
+
+/*!
+    @file shadow_cascades.h
+    @brief Cascaded shadow maps of the sun, fitted to the camera every frame.
+
+    The view, up to `Shadows::distance`, is cut in slices (practical split scheme: a blend of uniform and logarithmic
+    splits). Each slice is enclosed in a sphere, so the cascade keeps its size when the camera turns, and its ortho
+    projection is snapped to whole shadow texels, so the shadow edges do not shimmer when the camera moves.
+
+    Static casters can be kept in a second set of maps (`StaticShadowCache`): a cascade keeps the same matrix while
+    the camera moves less than one of its texels, the cached map is then still valid and only copied.
+
+    @version 0.0.1
+*/
+
+
+/// How far in front of a cascade, towards the sun, casters are still rendered into it
+constexpr float SHADOW_CASTER_DISTANCE = 100.0f;
+
+struct ShadowCascades {
+    int count = 0;
+
+    std::array<glm::mat4, MAX_SHADOW_CASCADES> matrices = {}; /// World to light clip space of each cascade
+    std::array<float, MAX_SHADOW_CASCADES> splits       = {}; /// View depth where each cascade ends
+
+    glm::mat4 caster_matrix = glm::mat4(1.0f); /// Encloses every cascade and the casters in front of them, for culling
+
+    /*!
+        @brief Fits the cascades to the view of `projection` * `view`.
+        @param to_light Normalized direction from the scene to the sun
+    */
+    void fit(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& to_light, const Shadows& config);
+};
+
+/*!
+    @brief Tracks which cascades of the static shadow maps must be redrawn.
+
+    A cascade stays valid while its matrix and the static casters do not change. The casters are known by a
+    signature summed over the frame (see `Renderer::add_static_caster`), independent of the submit order.
+*/
+struct StaticShadowCache {
+    std::array<glm::mat4, MAX_SHADOW_CASCADES> matrices = {}; /// Matrix each cascade was drawn with
+    Uint64 signature = 0;                                     /// Static casters the maps were drawn with
+    Uint32 valid_mask = 0;                                    /// Bit c set while cascade c is up to date
+
+    /*!
+        @brief Cascades to redraw this frame (bit c for cascade c), they are considered up to date afterwards.
+    */
+    Uint32 update(const ShadowCascades& cascades, Uint64 frame_signature);
+
+    void invalidate() {
+        valid_mask = 0;
+    }
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "stdafx.h"
+
+
+/*!
+    @file shape_tessellation.h
+    @brief CPU tessellation of the 2D primitives, shared by the 2D batches of the backends.
+
+    Curved shapes are built from cached unit meshes: a circle of `n` segments is computed once, then every circle
+    drawn with that level of detail is the same table scaled, rotated and translated by its transform. The segment
+    count follows the on-screen radius so small circles stay cheap and large ones stay round.
+
+    Polygons are ear-clipped, concave outlines included. The result only depends on the vertex list, so callers
+    triangulate once and keep the indices while the vertices do not change (see `Shape2D::triangles`).
+
+    @version 0.0.1
+*/
+
+
+constexpr int CIRCLE_MIN_SEGMENTS = 8;
+constexpr int CIRCLE_MAX_SEGMENTS = 128;
+
+/// Max distance between the true circle and its polygon, in pixels
+constexpr float CIRCLE_MAX_ERROR = 0.25f;
+
+/*!
+    @brief Segment count keeping a circle of `screen_radius` pixels within `CIRCLE_MAX_ERROR` of round.
+    @return A multiple of 4 in [CIRCLE_MIN_SEGMENTS, CIRCLE_MAX_SEGMENTS], so only a few unit meshes exist
+*/
+int get_circle_segments(float screen_radius);
+
+/*!
+    @brief Points of a unit circle (radius 1, centered on the origin). Every level of detail is built by the first call,
+    so it can be called from any thread.
+    @param segments A value returned by `get_circle_segments`
+    @return `segments` points, counter clockwise starting at (1, 0), the first point is not repeated
+*/
+const std::vector<glm::vec2>& get_unit_circle(int segments);
+
+/*!
+    @brief Ear-clipping triangulation of a simple polygon (convex or concave, either winding).
+    @param indices Replaced with 3 indices into `points` per triangle
+    @return false if the polygon is degenerate or no ear is left (self-intersecting), `indices` then holds a best-effort fan
+*/
+bool triangulate_polygon(const std::vector<glm::vec2>& points, std::vector<int>& indices);
+
+/*!
+    @brief Closed outline through `points` as a strip of `width`, corners are mitered (capped on sharp angles).
+    @param positions Replaced with 2 points per corner, outside then inside
+    @param indices Replaced with 6 indices into `positions` per edge
+*/
+void build_outline(const glm::vec2* points, size_t count, float width, std::vector<glm::vec2>& positions, std::vector<int>& indices);
+
+/*!
+    @brief Indices of quads of 4 vertices (TL, TR, BR, BL), two triangles per quad, shared and grown on demand.
+    @return At least `quad_count` * 6 indices
+*/
+const std::vector<int>& get_quad_indices(size_t quad_count);
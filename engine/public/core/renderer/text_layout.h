@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/renderer/texture_atlas.h"
+
+class Renderer;
+
+
+/*!
+    @file text_layout.h
+    @brief Glyph atlas and cached text layouts shared by the renderers.
+
+    Glyphs are rasterized once (white, tinted per vertex) into the pages of a per-font atlas. `TTF_Font`s are loaded
+    per size, so an atlas is per font and size. A text is laid out once into quads referencing those pages, and the
+    layout is kept as long as the same text is drawn, so a label costs no texture upload and no re-layout per frame.
+
+    Pages are backend textures: the backend only creates and updates them (`Renderer::create_glyph_page`,
+    `Renderer::update_glyph_page`) and turns the quads into vertices of its 2D batch (`Renderer::push_glyph_quad`).
+
+    @version 0.0.1
+*/
+
+
+/*!
+    @brief A glyph rasterized into an atlas page.
+*/
+struct Glyph {
+    Texture* page = nullptr; /// nullptr for glyphs without pixels (spaces)
+    glm::vec4 uv  = {0, 0, 0, 0}; /// u0, v0, u1, v1
+    float width   = 0;
+    float height  = 0;
+    float advance = 0;
+};
+
+/*!
+    @brief Glyph pages of one font (and size), filled on demand.
+*/
+class GlyphAtlas {
+public:
+    explicit GlyphAtlas(TTF_Font* font, int page_size = 512);
+
+    GlyphAtlas(const GlyphAtlas&)            = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    /*!
+        @brief Returns the glyph of `codepoint`, rasterizing it into a page of `renderer` on first use.
+    */
+    const Glyph& get_glyph(Renderer& renderer, Uint32 codepoint);
+
+    [[nodiscard]] TTF_Font* get_font() const;
+
+    [[nodiscard]] size_t get_page_count() const;
+
+private:
+    bool add_page(Renderer& renderer);
+
+    TTF_Font* _font = nullptr;
+    int _page_size  = 512;
+
+    AtlasPacker _packer;
+    std::vector<std::unique_ptr<Texture>> _pages;
+    std::unordered_map<Uint32, Glyph> _glyphs;
+};
+
+/*!
+    @brief A glyph quad of a laid out text, relative to the text position.
+*/
+struct TextQuad {
+    Texture* page  = nullptr;
+    glm::vec4 uv   = {0, 0, 0, 0}; /// u0, v0, u1, v1
+    glm::vec4 dest = {0, 0, 0, 0}; /// x, y, w, h
+    bool is_emoji  = false; /// Color glyph, only the alpha of the label applies
+};
+
+/*!
+    @brief Cached layout of one text with one font, rebuilt only when the text changes.
+*/
+struct TextLayout {
+    std::vector<TextQuad> quads;
+    float width            = 0;
+    Uint64 last_used_frame = 0;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "core/renderer/base_struct.h"
+
+class Renderer;
+
+
+/*!
+    @file texture_atlas.h
+    @brief AtlasPacker and TextureAtlas class definitions.
+
+    Small textures are merged into shared pages so sprites using different images can still be drawn in the same
+    batch. Pages come from two sources:
+
+    - An offline manifest written by `tools/pack_atlas.py` (JSON: pages + named regions).
+    - Images queued at load time with `queue_image` and packed by `build`.
+
+    `Sprite2D::texture_name` is looked up in the atlas first, its `source` rect is then offset into the page, so
+    sprites need no change to benefit from it.
+
+    @version 0.0.1
+*/
+
+
+/*!
+    @brief Skyline bottom-left rectangle packer.
+
+    The skyline is the top edge of everything placed so far, a rectangle is placed where its bottom ends up the
+    lowest (ties go to the tightest fit). Good results for sprite sets of similar heights, O(skyline) per insert.
+*/
+class AtlasPacker {
+public:
+    explicit AtlasPacker(int width = 2048, int height = 2048, int padding = 1);
+
+    /*!
+        @brief Reserves a `width` x `height` rect (plus padding on its right/bottom).
+        @param position Top-left corner of the rect in the page
+        @return false if the page is full
+    */
+    bool insert(int width, int height, glm::ivec2& position);
+
+    void reset();
+
+    [[nodiscard]] int get_width() const;
+
+    [[nodiscard]] int get_height() const;
+
+    /*!
+        @brief Ratio of the page covered by inserted rects (padding included), 0..1.
+    */
+    [[nodiscard]] float get_occupancy() const;
+
+private:
+    struct SkylineNode {
+        int x     = 0;
+        int y     = 0;
+        int width = 0;
+    };
+
+    /// Lowest y a rect fits at when its left edge starts at node `index`, -1 if it does not fit
+    int fit(size_t index, int width, int height) const;
+
+    std::vector<SkylineNode> _skyline;
+
+    int _width   = 0;
+    int _height  = 0;
+    int _padding = 0;
+
+    Uint64 _used_area = 0;
+};
+
+
+/*!
+    @brief Location of a named image inside an atlas page.
+*/
+struct AtlasRegion {
+    std::shared_ptr<Texture> page;
+    glm::vec4 rect = {0, 0, 0, 0}; /// x, y, w, h in page pixels
+    int page_index = 0;
+};
+
+
+/*!
+    @brief Named regions of shared texture pages, see `texture_atlas.h`.
+*/
+class TextureAtlas {
+public:
+    ~TextureAtlas();
+
+    /*!
+        @param max_image_size Images larger than this (either side) stay standalone textures
+    */
+    void configure(int page_size, int padding, int max_image_size);
+
+    /*!
+        @brief Decodes an image to pack on the next `build`.
+        @return false if it cannot be decoded or is too large for the atlas, load it as a standalone texture instead
+    */
+    bool queue_image(const std::string& name, const std::string& path);
+
+    /*!
+        @brief Packs the queued images into new pages (largest first) and uploads them.
+    */
+    bool build(Renderer& renderer);
+
+    /*!
+        @brief Loads the pages and regions of an offline-packed manifest (`tools/pack_atlas.py`).
+        Page files are resolved relative to the manifest.
+    */
+    bool load_manifest(Renderer& renderer, const std::string& path);
+
+    /*!
+        @return The region of `name`, nullptr if the image is not in the atlas
+    */
+    [[nodiscard]] const AtlasRegion* find(const std::string& name) const;
+
+    [[nodiscard]] size_t get_page_count() const;
+
+    [[nodiscard]] size_t size() const;
+
+    void clear();
+
+private:
+    struct PendingImage {
+        std::string name;
+        int width             = 0;
+        int height            = 0;
+        unsigned char* pixels = nullptr; /// RGBA8, freed after `build`
+    };
+
+    void free_pending();
+
+    std::unordered_map<std::string, AtlasRegion> _regions;
+    std::vector<std::shared_ptr<Texture>> _pages;
+    std::vector<PendingImage> _pending;
+
+    int _page_size      = 2048;
+    int _padding        = 1;
+    int _max_image_size = 256;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "stdafx.h"
+
+
+/*!
+    @file frame_pacer.h
+    @brief FramePacer class definition.
+
+    Paces the main loop to a target frame time derived from `Application::max_fps`.
+    Waiting is hybrid: the pacer sleeps for the bulk of the remaining time and spins on the
+    high-resolution counter for the last `spin_threshold` to hit the deadline precisely.
+
+    - `max_fps <= 0` means unlimited (no waiting unless throttled).
+    - When vsync is active and the target is at or above the display refresh rate, the swap chain paces the frame and the pacer stays out of
+    the way.
+    - When the window is minimized or unfocused the pacer throttles to `background_fps`.
+
+    @ingroup Time
+    @version 0.0.1
+*/
+class FramePacer {
+public:
+    /*!
+        @brief Sets the target frame rate.
+        @param fps Frames per second, `<= 0` disables the limit.
+    */
+    void set_target_fps(int fps);
+
+    /*!
+        @brief Sets the frame rate used while the window is minimized or unfocused.
+        @param fps Frames per second, `<= 0` disables background throttling.
+    */
+    void set_background_fps(int fps);
+
+    /*!
+        @brief Informs the pacer whether the swap interval already blocks on vblank.
+        @param is_enabled True if vsync (or adaptive sync) is active.
+        @param refresh_rate Display refresh rate in Hz, `<= 0` if unknown.
+    */
+    void set_vsync(bool is_enabled, float refresh_rate = 0.0f);
+
+    /*!
+        @brief Marks the window as minimized, hidden or unfocused.
+    */
+    void set_throttled(bool is_throttled);
+
+    [[nodiscard]] bool is_throttled() const;
+
+    /*!
+        @brief Target duration of a frame in seconds, `0` if unlimited.
+    */
+    [[nodiscard]] double get_target_frame_time() const;
+
+    /*!
+        @brief Blocks until the next frame deadline.
+
+        Deadlines are absolute, so oversleeping one frame is compensated in the next one. If the frame
+        overran by more than a whole period the schedule is reset instead of trying to catch up.
+    */
+    void wait();
+
+    /// Remaining time (in seconds) below which the pacer spins instead of sleeping.
+    double spin_threshold = 0.002;
+
+private:
+    Uint64 get_target_ticks() const;
+
+    int _target_fps       = 60;
+    int _background_fps   = 10;
+    bool _is_vsync        = false;
+    float _refresh_rate   = 0.0f;
+    bool _is_throttled    = false;
+    Uint64 _next_deadline = 0;
+};
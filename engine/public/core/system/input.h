@@ -0,0 +1,209 @@
+#pragma once
+
+#include "stdafx.h"
+
+
+/*!
+    @file input.h
+    @brief Input class definition.
+
+    Engine-side input state. SDL events are fed once per frame, then the keyboard, mouse and the
+    action map are polled from C++ or Lua instead of every script decoding every event.
+
+    - Consecutive mouse motion and wheel events are coalesced into one event per frame.
+    - Actions (`project.xml` `<input>` or `add_action`) expose pressed/held/released edges and axes.
+    - Subscribers are only woken for the actions they subscribed to, so a frame costs
+      O(events + subscribers) instead of O(events x scripts).
+
+    @ingroup Input
+    @version 0.0.1
+*/
+
+
+/*!
+    @brief Physical source of an action binding.
+    @ingroup Input
+*/
+enum class InputSource {
+    KEY, /// Keyboard scancode (`SDL_Scancode`).
+    MOUSE_BUTTON /// Mouse button (`SDL_BUTTON_LEFT`, ...).
+};
+
+/*!
+    @brief A single key or button mapped to an action.
+    @ingroup Input
+*/
+struct InputBinding {
+    InputSource source = InputSource::KEY;
+    int code           = 0;
+};
+
+/*!
+    @brief Named action definition, as read from `project.xml`.
+    @ingroup Input
+*/
+struct InputActionDesc {
+    std::string name;
+    std::vector<InputBinding> bindings;
+};
+
+/*!
+    @brief Polled state of an action for the current frame.
+    @ingroup Input
+*/
+struct InputActionState {
+    bool is_held     = false;
+    bool is_pressed  = false; /// Went down this frame
+    bool is_released = false; /// Went up this frame
+};
+
+/*!
+    @brief Called when a subscribed action is pressed (`true`) or released (`false`).
+    @ingroup Input
+*/
+using InputActionCallback = std::function<void(const std::string& action, bool is_pressed)>;
+
+
+class Input {
+public:
+    /*!
+        @brief Registers the actions of the project and reads the initial mouse position.
+    */
+    void initialize(const std::vector<InputActionDesc>& actions);
+
+    /*!
+        @brief Clears per-frame edges, deltas and the coalesced event list. Call before polling SDL.
+    */
+    void begin_frame();
+
+    /*!
+        @brief Updates key, button and action state from one SDL event. O(1) per event plus the actions bound to it.
+    */
+    void process_event(const SDL_Event& event);
+
+    /*!
+        @brief Wakes the subscribers of every action that changed this frame, in event order.
+    */
+    void dispatch();
+
+#pragma region ACTIONS
+
+    /*!
+        @brief Creates an action without bindings, returns false if it already exists.
+    */
+    bool add_action(const std::string& name);
+
+    bool bind_key(const std::string& action, SDL_Scancode scancode);
+
+    bool bind_mouse_button(const std::string& action, Uint8 button);
+
+    [[nodiscard]] bool has_action(const std::string& action) const;
+
+    [[nodiscard]] bool is_action_held(const std::string& action) const;
+
+    [[nodiscard]] bool is_action_pressed(const std::string& action) const;
+
+    [[nodiscard]] bool is_action_released(const std::string& action) const;
+
+    /*!
+        @brief `-1`, `0` or `1` depending on which of the two actions is held (both cancel out).
+    */
+    [[nodiscard]] float get_axis(const std::string& negative, const std::string& positive) const;
+
+    /*!
+        @brief Normalized 2D direction built from four actions (e.g. `move_left`, `move_right`, `move_up`, `move_down`).
+    */
+    [[nodiscard]] glm::vec2 get_vector(const std::string& left, const std::string& right, const std::string& up, const std::string& down) const;
+
+    /*!
+        @brief Subscribes `owner` to an action, returns false if the action does not exist.
+        @param owner Any stable pointer (the script `lua_State`), used by `unsubscribe`.
+    */
+    bool subscribe(const std::string& action, const void* owner, InputActionCallback callback);
+
+    /*!
+        @brief Removes every subscription of `owner`, must be called before the owner is destroyed.
+    */
+    void unsubscribe(const void* owner);
+
+#pragma endregion
+
+#pragma region DEVICES
+
+    [[nodiscard]] bool is_key_held(SDL_Scancode scancode) const;
+
+    [[nodiscard]] bool is_key_pressed(SDL_Scancode scancode) const;
+
+    [[nodiscard]] bool is_key_released(SDL_Scancode scancode) const;
+
+    [[nodiscard]] bool is_mouse_button_held(Uint8 button) const;
+
+    [[nodiscard]] glm::vec2 get_mouse_position() const;
+
+    /*!
+        @brief Sum of the relative mouse motion received this frame.
+    */
+    [[nodiscard]] glm::vec2 get_mouse_delta() const;
+
+    /*!
+        @brief Sum of the wheel scroll received this frame.
+    */
+    [[nodiscard]] glm::vec2 get_wheel_delta() const;
+
+    /*!
+        @brief Events of this frame, with consecutive mouse motion/wheel events merged into one.
+    */
+    [[nodiscard]] const std::vector<SDL_Event>& get_events() const;
+
+#pragma endregion
+
+private:
+    enum KeyFlags : Uint8 { KEY_HELD = 1 << 0, KEY_PRESSED = 1 << 1, KEY_RELEASED = 1 << 2 };
+
+    struct Action {
+        std::string name;
+        std::vector<InputBinding> bindings;
+        InputActionState state;
+    };
+
+    struct Subscriber {
+        const void* owner = nullptr;
+        InputActionCallback callback;
+    };
+
+    static int get_binding_key(InputSource source, int code);
+
+    const Action* find_action(const std::string& name) const;
+
+    bool bind(const std::string& action, InputBinding binding);
+
+    bool is_binding_held(const InputBinding& binding) const;
+
+    void on_binding_changed(InputSource source, int code, bool is_down);
+
+    void coalesce_event(const SDL_Event& event);
+
+    std::array<Uint8, SDL_SCANCODE_COUNT> _keys = {};
+    std::vector<SDL_Scancode> _dirty_keys; /// Keys with edge flags to clear next frame
+
+    Uint32 _mouse_buttons = 0; /// SDL_BUTTON_MASK bits
+
+    glm::vec2 _mouse_position = {0.0f, 0.0f};
+    glm::vec2 _mouse_delta    = {0.0f, 0.0f};
+    glm::vec2 _wheel_delta    = {0.0f, 0.0f};
+
+    std::vector<Action> _actions;
+    std::unordered_map<std::string, int> _action_lookup;
+    std::unordered_map<int, std::vector<int>> _binding_actions; /// binding key -> action indices
+    std::vector<int> _dirty_actions; /// Actions with edge flags to clear next frame
+
+    struct ActionEvent {
+        int action      = -1;
+        bool is_pressed = false;
+    };
+
+    std::vector<ActionEvent> _action_events;
+    std::unordered_map<int, std::vector<Subscriber>> _subscribers; /// action index -> subscribers
+
+    std::vector<SDL_Event> _events;
+};
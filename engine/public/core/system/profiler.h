@@ -0,0 +1,205 @@
+#pragma once
+
+#include "stdafx.h"
+
+
+/*!
+    @brief A finished zone as stored in the per-thread ring buffers.
+
+    @ingroup Time
+    @version 0.0.1
+*/
+struct ProfileEvent {
+    const char* name = nullptr; /// Static or interned string, never freed while the profiler lives
+    Uint64 start_ns  = 0;
+    Uint64 end_ns    = 0;
+    Uint32 depth     = 0; /// Nesting level inside the thread
+};
+
+
+/*!
+    @file profiler.h
+    @brief Hierarchical CPU profiler.
+
+    Zones are opened and closed on the calling thread (RAII with `PROFILE_SCOPE` or `begin_zone`/`end_zone`) and written
+    into a ring buffer owned by that thread, so recording never contends with other threads. The most recent
+    `events_per_thread` zones of every thread are kept and can be written as Chrome/Perfetto trace JSON at any time
+    (`chrome://tracing`, https://ui.perfetto.dev).
+
+    Every flecs system is recorded too, through the flecs perf trace hooks.
+
+    @ingroup Time
+    @version 0.0.1
+*/
+class Profiler {
+public:
+    static constexpr size_t events_per_thread = 1 << 16;
+
+    static Profiler& get_instance();
+
+    /*!
+        @brief Installs the flecs hooks and names the calling thread "Main".
+    */
+    void initialize();
+
+    void set_enabled(bool is_enabled);
+
+    [[nodiscard]] bool is_enabled() const;
+
+    /*!
+        @brief Opens a zone on the calling thread.
+        @param name Must outlive the profiler (string literal), see `intern` otherwise.
+    */
+    void begin_zone(const char* name);
+
+    /*!
+        @brief Closes the innermost zone of the calling thread.
+    */
+    void end_zone();
+
+    /*!
+        @brief Records an already measured zone on a named track instead of the calling thread.
+
+        Used for work timed outside the CPU (e.g. GPU timer queries), the track shows up as its own row in the trace.
+        @param track Track name (string literal)
+        @param name Must outlive the profiler (string literal), see `intern` otherwise.
+    */
+    void record_zone(const char* track, const char* name, Uint64 start_ns, Uint64 end_ns, Uint32 depth = 0);
+
+    /*!
+        @brief Names the calling thread in the exported trace.
+    */
+    void set_thread_name(const char* name);
+
+    /*!
+        @brief Returns a copy of `name` that stays valid for the whole program.
+    */
+    const char* intern(const char* name);
+
+    /*!
+        @brief Writes every buffered zone as Chrome trace JSON.
+        @param path Destination (res:// or user://)
+        @return true if the file was written.
+    */
+    bool dump_chrome_trace(const std::string& path);
+
+    /*!
+        @brief Builds the Chrome trace JSON of every buffered zone.
+    */
+    std::string get_chrome_trace();
+
+    /*!
+        @brief Visits every buffered zone, oldest first, thread by thread.
+    */
+    void for_each_event(const std::function<void(const std::string& thread_name, const ProfileEvent& event)>& callback);
+
+    /*!
+        @brief Drops every buffered zone (open zones are kept).
+    */
+    void clear();
+
+    /*!
+        @brief Current time in nanoseconds from `SDL_GetPerformanceCounter`.
+    */
+    static Uint64 get_time_ns();
+
+private:
+    struct OpenZone {
+        ProfileEvent event;
+        Uint32 open_depth = 0; /// Value of `_open_depth` when opened, counting the zones skipped while disabled
+    };
+
+    struct ThreadBuffer {
+        Uint64 thread_id = 0; /// SDL_ThreadID, or a synthetic id for tracks
+        std::string thread_name;
+
+        std::mutex mutex; /// Only contended while exporting
+        std::vector<ProfileEvent> events;
+        size_t head  = 0; /// Next slot to write
+        size_t count = 0;
+
+        std::vector<OpenZone> open; /// Zones not yet closed (stack)
+    };
+
+    Profiler() = default;
+
+    ThreadBuffer& get_thread_buffer();
+
+    ThreadBuffer& get_track_buffer(const char* track);
+
+    static void push_event(ThreadBuffer& buffer, const ProfileEvent& event);
+
+    static thread_local ThreadBuffer* _current_thread;
+    static thread_local Uint32 _open_depth; /// Zones opened on this thread, recorded or not
+
+    std::atomic<bool> _is_enabled = false;
+
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _threads;
+    std::unordered_map<std::string, ThreadBuffer*> _tracks;
+    std::unordered_map<std::string, std::unique_ptr<char[]>> _interned;
+};
+
+
+/*!
+    @brief RAII zone, closes itself at the end of the scope.
+
+    @ingroup Time
+    @version 0.0.1
+*/
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : _is_recording(Profiler::get_instance().is_enabled()) {
+        if (_is_recording) {
+            Profiler::get_instance().begin_zone(name);
+        }
+    }
+
+    ~ProfileScope() {
+        if (_is_recording) {
+            Profiler::get_instance().end_zone();
+        }
+    }
+
+    ProfileScope(const ProfileScope&)            = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    bool _is_recording = false;
+};
+
+
+#define PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define PROFILE_CONCAT(a, b)          PROFILE_CONCAT_INTERNAL(a, b)
+
+/*!
+
+   @brief Profiles the rest of the enclosing scope under `name` (string literal)
+   @version 0.0.1
+   @ingroup Time
+*/
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(name)
+
+/*!
+
+   @brief Opens a zone that is closed by `PROFILE_END`, for spans that don't match a C++ scope
+   @version 0.0.1
+   @ingroup Time
+*/
+#define PROFILE_BEGIN(name) Profiler::get_instance().begin_zone(name)
+
+/*!
+
+   @brief Closes the zone opened by the matching `PROFILE_BEGIN`
+   @version 0.0.1
+   @ingroup Time
+*/
+#define PROFILE_END() Profiler::get_instance().end_zone()
+
+/*!
+
+   @brief Profiles the rest of the enclosing function
+   @version 0.0.1
+   @ingroup Time
+*/
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
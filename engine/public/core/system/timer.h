@@ -17,13 +17,33 @@ public:
     double delta;
     double elapsed_time;
 
+    double fixed_delta  = 1.0 / 60.0; /// Simulation step, from `Performance::physics_fps`
+    int max_fixed_steps = 5; /// Clamp against the spiral of death (a slow step causing even more steps)
+
+    double fixed_frame_delta = 0.0; /// When > 0 every tick reports this delta instead of the measured one (benchmarks, replays)
+
     int get_fps() const;
 
     void start();
 
     void tick();
 
+    /*!
+        @brief Feeds the frame delta into the accumulator and returns how many fixed steps to run.
+
+        If more than `max_fixed_steps` are pending, the excess time is dropped so the simulation slows down instead of stalling the frame.
+        @return Number of fixed steps (0..max_fixed_steps)
+    */
+    int consume_fixed_steps();
+
+    /*!
+        @brief Interpolation factor between the last two simulation states [0, 1).
+    */
+    float get_fixed_alpha() const;
+
 private:
     Uint64 now;
     Uint64 last;
+
+    double _accumulator = 0.0;
 };
@@ -4,11 +4,17 @@ in vec3 NORMAL; // vertex normal in world-space
 in vec3 WORLD_POSITION;
 in vec2 UV;
 in vec3 INSTANCE_COLOR;
-in vec4 FRAG_POS_LIGHT_SPACE;
+in float VIEW_DEPTH;
 
 uniform sampler2D ALBEDO_TEXTURE;
 uniform sampler2D NORMAL_MAP_TEXTURE;
-uniform sampler2D SHADOW_TEXTURE;
+uniform highp sampler2DArrayShadow SHADOW_TEXTURE; // one layer per cascade
+
+const int MAX_SHADOW_CASCADES = 4;
+
+uniform mat4 SHADOW_MATRICES[MAX_SHADOW_CASCADES];
+uniform float SHADOW_SPLITS[MAX_SHADOW_CASCADES]; // view depth where each cascade ends
+uniform int SHADOW_CASCADE_COUNT;
 
 // DIRECTIONAL LIGHT (SUN)
 // NOTE: LIGHT_DIRECTION is the direction the light is *coming FROM*
@@ -34,8 +40,23 @@ uniform bool USE_ALBEDO_TEXTURE;
 uniform bool USE_NORMAL_MAP_TEXTURE;
 
 
-float calculate_shadow(vec4 frag_pos_light_space, vec3 normal, vec3 light_dir)
+float calculate_shadow(vec3 normal, vec3 light_dir)
 {
+    // Closest cascade covering the fragment, no shadow past the last one
+    int cascade = -1;
+
+    for (int i = 0; i < MAX_SHADOW_CASCADES; i++) {
+        if (i < SHADOW_CASCADE_COUNT && VIEW_DEPTH <= SHADOW_SPLITS[i]) {
+            cascade = i;
+            break;
+        }
+    }
+
+    if (cascade < 0)
+    return 0.0;
+
+    vec4 frag_pos_light_space = SHADOW_MATRICES[cascade] * vec4(WORLD_POSITION, 1.0);
+
     vec3 proj_coords = frag_pos_light_space.xyz / frag_pos_light_space.w;
     proj_coords = proj_coords * 0.5 + 0.5;
 
@@ -50,7 +71,7 @@ float calculate_shadow(vec4 frag_pos_light_space, vec3 normal, vec3 light_dir)
 
     float bias = 0.0005 + 0.001 * (1.0 - NdotL);
 
-    vec2 texel_size = 1.0 / vec2(textureSize(SHADOW_TEXTURE, 0));
+    vec2 texel_size = 1.0 / vec2(textureSize(SHADOW_TEXTURE, 0).xy);
 
     const vec2 samples[32] = vec2[](
     vec2(-0.94201624, -0.39906216),
@@ -98,8 +119,8 @@ float calculate_shadow(vec4 frag_pos_light_space, vec3 normal, vec3 light_dir)
     for (int i = 0; i < sample_count; i++)
     {
         vec2 offset = samples[i] * texel_size * adaptive_radius;
-        float pcf_depth = texture(SHADOW_TEXTURE, proj_coords.xy + offset).r;
-        shadow += (current_depth - bias) > pcf_depth ? 1.0 : 0.0;
+        // Hardware compare, 1.0 when lit
+        shadow += 1.0 - texture(SHADOW_TEXTURE, vec4(proj_coords.xy + offset, float(cascade), current_depth - bias));
     }
     shadow /= float(sample_count);
     shadow = smoothstep(0.0, 1.0, shadow);
@@ -208,7 +229,7 @@ void main()
     // Half vector for Blinn-Phong
     vec3 H = normalize(V + L);
 
-    float shadow = calculate_shadow(FRAG_POS_LIGHT_SPACE, normal_ws, L);
+    float shadow = calculate_shadow(normal_ws, L);
 
     float NdotL = max(dot(N, L), 0.0);
 
@@ -11,27 +11,41 @@ layout(location = 7) in vec3 a_instance_color; // per-instance color
 // Bone data (for skeletal animation)
 layout(location = 8) in ivec4 a_bone_ids;
 layout(location = 9) in vec4 a_bone_weights;
+layout(location = 10) in int a_instance_bone_offset; // first palette bone, -1 if not skinned
 
 out vec3 NORMAL;
 out vec3 WORLD_POSITION;
 out vec2 UV;
 out vec3 INSTANCE_COLOR;
-out vec4 FRAG_POS_LIGHT_SPACE;
+out float VIEW_DEPTH; // distance along the camera axis, selects the shadow cascade
 
 uniform mat4 VIEW;
 uniform mat4 PROJECTION;
-uniform mat4 LIGHT_PROJECTION;
 
 const int MAX_BONES = 250; // ~16KB limit
 
 uniform bool USE_SKELETON;
-uniform mat4 BONES[MAX_BONES];
+uniform highp sampler2D BONE_PALETTE; // mat3x4 rows of every skinned instance of the frame
+
+mat4 get_bone(int bone) {
+    int width = textureSize(BONE_PALETTE, 0).x;
+    int texel = bone * 3;
+
+    vec4 r0 = texelFetch(BONE_PALETTE, ivec2(texel % width, texel / width), 0);
+    vec4 r1 = texelFetch(BONE_PALETTE, ivec2((texel + 1) % width, (texel + 1) / width), 0);
+    vec4 r2 = texelFetch(BONE_PALETTE, ivec2((texel + 2) % width, (texel + 2) / width), 0);
+
+    return mat4(r0.x, r1.x, r2.x, 0.0,
+                r0.y, r1.y, r2.y, 0.0,
+                r0.z, r1.z, r2.z, 0.0,
+                r0.w, r1.w, r2.w, 1.0);
+}
 
 void main() {
     vec3 pos = a_pos;
     vec3 norm = a_normal;
     
-    if (USE_SKELETON) {
+    if (USE_SKELETON && a_instance_bone_offset >= 0) {
         mat4 boneTransform = mat4(1.0); 
         float bone_weights_sum = 0.0;
         
@@ -43,9 +57,9 @@ void main() {
             if (id >= 0 && id < MAX_BONES) {
                
                 if (bone_weights_sum == 0.0) {
-                    boneTransform = BONES[id] * w; 
+                    boneTransform = get_bone(a_instance_bone_offset + id) * w; 
                 } else {
-                    boneTransform += BONES[id] * w; 
+                    boneTransform += get_bone(a_instance_bone_offset + id) * w; 
                 }
 
                 bone_weights_sum += w;
@@ -61,5 +75,5 @@ void main() {
     UV = a_tex_coord;
     gl_Position = PROJECTION * VIEW * vec4(WORLD_POSITION, 1.0);
     INSTANCE_COLOR = a_instance_color;
-    FRAG_POS_LIGHT_SPACE = LIGHT_PROJECTION * vec4(WORLD_POSITION, 1.0);
+    VIEW_DEPTH = -(VIEW * vec4(WORLD_POSITION, 1.0)).z;
 }
\ No newline at end of file
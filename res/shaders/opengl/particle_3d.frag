@@ -0,0 +1,14 @@
+in vec2 CORNER;
+in vec4 VERTEX_COLOR;
+out vec4 COLOR;
+
+void main() {
+    // Round particles with a soft edge
+    float edge = 1.0 - smoothstep(0.35, 0.5, length(CORNER));
+
+    COLOR = vec4(VERTEX_COLOR.rgb, VERTEX_COLOR.a * edge);
+
+    if (COLOR.a <= 0.0) {
+        discard;
+    }
+}
@@ -0,0 +1,21 @@
+layout(location = 0) in vec4 a_position_size;
+layout(location = 1) in vec4 a_color;
+
+out vec2 CORNER;
+out vec4 VERTEX_COLOR;
+
+uniform mat4 VIEW;
+uniform mat4 PROJECTION;
+
+void main() {
+    // Triangle strip of 4 vertices, the quad is built here
+    CORNER       = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) - 0.5;
+    VERTEX_COLOR = a_color;
+
+    // Camera right and up are the first two rows of the view rotation
+    vec3 right = vec3(VIEW[0][0], VIEW[1][0], VIEW[2][0]);
+    vec3 up    = vec3(VIEW[0][1], VIEW[1][1], VIEW[2][1]);
+    vec3 world = a_position_size.xyz + (right * CORNER.x + up * CORNER.y) * a_position_size.w;
+
+    gl_Position = PROJECTION * VIEW * vec4(world, 1.0);
+}
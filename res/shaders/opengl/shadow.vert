@@ -5,18 +5,33 @@ layout(location = 3) in mat4 a_instance_model; // per-instance model matrix
 // Bone data (for skeletal animation)
 layout(location = 8) in ivec4 a_bone_ids;
 layout(location = 9) in vec4 a_bone_weights;
+layout(location = 10) in int a_instance_bone_offset; // first palette bone, -1 if not skinned
 
 uniform mat4 LIGHT_PROJECTION;
 
 const int MAX_BONES = 250; // ~16KB limit
 
 uniform bool USE_SKELETON;
-uniform mat4 BONES[MAX_BONES];
+uniform highp sampler2D BONE_PALETTE; // mat3x4 rows of every skinned instance of the frame
+
+mat4 get_bone(int bone) {
+    int width = textureSize(BONE_PALETTE, 0).x;
+    int texel = bone * 3;
+
+    vec4 r0 = texelFetch(BONE_PALETTE, ivec2(texel % width, texel / width), 0);
+    vec4 r1 = texelFetch(BONE_PALETTE, ivec2((texel + 1) % width, (texel + 1) / width), 0);
+    vec4 r2 = texelFetch(BONE_PALETTE, ivec2((texel + 2) % width, (texel + 2) / width), 0);
+
+    return mat4(r0.x, r1.x, r2.x, 0.0,
+                r0.y, r1.y, r2.y, 0.0,
+                r0.z, r1.z, r2.z, 0.0,
+                r0.w, r1.w, r2.w, 1.0);
+}
 
 void main() {
     vec3 pos = a_position;
     
-    if (USE_SKELETON) {
+    if (USE_SKELETON && a_instance_bone_offset >= 0) {
         mat4 boneTransform = mat4(1.0); 
         float bone_weights_sum = 0.0;
         
@@ -28,9 +43,9 @@ void main() {
             if (id >= 0 && id < MAX_BONES) {
                
                 if (bone_weights_sum == 0.0) {
-                    boneTransform = BONES[id] * w; 
+                    boneTransform = get_bone(a_instance_bone_offset + id) * w; 
                 } else {
-                    boneTransform += BONES[id] * w; 
+                    boneTransform += get_bone(a_instance_bone_offset + id) * w; 
                 }
 
                 bone_weights_sum += w;
@@ -0,0 +1,17 @@
+in vec2 UV;
+in vec4 VERTEX_COLOR;
+out vec4 COLOR;
+
+uniform sampler2D TEXTURE;
+uniform float ALPHA_CUTOFF;
+
+void main() {
+    // Untextured shapes carry a negative u
+    vec4 texel = UV.x < 0.0 ? vec4(1.0) : texture(TEXTURE, UV);
+
+    COLOR = texel * VERTEX_COLOR;
+
+    if (COLOR.a < ALPHA_CUTOFF) {
+        discard;
+    }
+}
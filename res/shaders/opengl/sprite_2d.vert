@@ -0,0 +1,18 @@
+layout(location = 0) in vec3 a_pos;
+layout(location = 1) in vec2 a_uv;
+layout(location = 2) in vec4 a_color;
+
+out vec2 UV;
+out vec4 VERTEX_COLOR;
+
+uniform mat4 VIEW;
+uniform mat4 PROJECTION;
+
+void main() {
+    UV           = a_uv;
+    VERTEX_COLOR = a_color;
+
+    // The depth comes from the submission order, not from the camera
+    vec4 pos    = PROJECTION * VIEW * vec4(a_pos.xy, 0.0, 1.0);
+    gl_Position = vec4(pos.xy, a_pos.z * pos.w, pos.w);
+}
@@ -47,11 +47,13 @@ int main(int argc, char* argv[]) {
     auto car = world.entity()
                    .set<Model>({.path = "res://sprites/obj/Car.obj"})
                    .set<Transform3D>({.position = {5, 0, 0}})
+                   .add<tags::Static>()
                    .child_of(scene);
 
     auto plane = world.entity("plane")
                      .set<MeshInstance3D>({.size = {100, 0.f, 100}, .material = {.albedo = {0.3f, 1.f, 0.3f}}})
                      .set<Transform3D>({.position = {0, 0, 0}})
+                     .add<tags::Static>()
                      .child_of(scene);
 
     GEngine->run();
@@ -0,0 +1,83 @@
+#include "core/renderer/bounds.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("BoundingBox grows with its points") {
+    BoundingBox box;
+    CHECK_FALSE(box.is_valid());
+
+    box.expand({1, 2, 3});
+    box.expand({-1, 0, 5});
+    REQUIRE(box.is_valid());
+
+    CHECK(box.get_center().x == doctest::Approx(0.0f));
+    CHECK(box.get_center().z == doctest::Approx(4.0f));
+    CHECK(box.get_extents().y == doctest::Approx(1.0f));
+
+    MESSAGE("Merging an empty box changes nothing");
+    box.merge(BoundingBox{});
+    CHECK(box.max.z == doctest::Approx(5.0f));
+}
+
+TEST_CASE("BoundingBox follows a transform") {
+    const BoundingBox box = {glm::vec3(-1.0f), glm::vec3(1.0f)};
+
+    glm::mat4 matrix = glm::translate(glm::mat4(1.0f), {10, 0, 0});
+    matrix           = glm::rotate(matrix, glm::radians(45.0f), {0, 1, 0});
+    matrix           = glm::scale(matrix, {2, 2, 2});
+
+    const BoundingBox moved = box.transformed(matrix);
+
+    // A rotated cube of side 4 spans its diagonal on x and z
+    CHECK(moved.get_center().x == doctest::Approx(10.0f));
+    CHECK(moved.get_extents().x == doctest::Approx(2.0f * SDL_sqrtf(2.0f)));
+    CHECK(moved.get_extents().y == doctest::Approx(2.0f));
+}
+
+TEST_CASE("Frustum culls spheres and boxes outside of the view") {
+    Frustum everything;
+    CHECK(everything.is_sphere_visible({1e6f, 0, 0}, 1.0f));
+
+    const glm::mat4 view       = glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+    const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+
+    Frustum frustum;
+    frustum.set_matrix(projection * view);
+
+    CHECK(frustum.is_sphere_visible({0, 0, -10}, 1.0f));
+    CHECK_FALSE(frustum.is_sphere_visible({0, 0, 10}, 1.0f));
+    CHECK_FALSE(frustum.is_sphere_visible({0, 0, -200}, 1.0f));
+
+    MESSAGE("A sphere crossing a side plane is kept");
+    CHECK(frustum.is_sphere_visible({11, 0, -10}, 2.0f));
+    CHECK_FALSE(frustum.is_sphere_visible({13, 0, -10}, 2.0f));
+
+    CHECK(frustum.is_box_visible({-1, -1, -11}, {1, 1, -9}));
+    CHECK_FALSE(frustum.is_box_visible({-1, -1, 5}, {1, 1, 9}));
+}
+
+TEST_CASE("Frustum tests SoA spheres 4 at a time") {
+    const glm::mat4 view       = glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+    const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+
+    Frustum frustum;
+    frustum.set_matrix(projection * view);
+
+    // Past a multiple of 4, so the scalar tail runs too; every other sphere is behind the camera
+    constexpr size_t COUNT = 7;
+    float x[COUNT], y[COUNT], z[COUNT], radius[COUNT];
+    Uint8 passes[COUNT] = {};
+
+    for (size_t i = 0; i < COUNT; i++) {
+        x[i]      = static_cast<float>(i) - 3.0f;
+        y[i]      = 0.0f;
+        z[i]      = i % 2 == 0 ? -10.0f : 10.0f;
+        radius[i] = 0.5f;
+    }
+
+    frustum.cull_spheres(x, y, z, radius, COUNT, RENDER_PASS_SHADOW, passes);
+
+    for (size_t i = 0; i < COUNT; i++) {
+        CHECK(passes[i] == (i % 2 == 0 ? RENDER_PASS_SHADOW : 0));
+        CHECK(static_cast<bool>(passes[i]) == frustum.is_sphere_visible({x[i], y[i], z[i]}, radius[i]));
+    }
+}
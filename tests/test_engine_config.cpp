@@ -16,4 +16,10 @@ TEST_CASE("Parse config file") {
     // Window info
     CHECK_EQ(config.get_window().width, 1280);
     CHECK_EQ(config.get_window().height, 720);
+
+    // Shadows
+    CHECK_EQ(config.get_shadows().cascade_count, 3);
+    CHECK_EQ(config.get_shadows().resolution, 2048);
+    CHECK_EQ(config.get_shadows().depth_bits, 24);
+    CHECK(config.get_shadows().is_caching_static);
 }
@@ -0,0 +1,28 @@
+#include "core/system/frame_pacer.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("Frame pacer target frame time") {
+    FramePacer pacer;
+
+    pacer.set_target_fps(60);
+    CHECK(pacer.get_target_frame_time() == doctest::Approx(1.0 / 60.0).epsilon(0.001));
+
+    MESSAGE("Unlimited frame rate never waits");
+    pacer.set_target_fps(0);
+    CHECK(pacer.get_target_frame_time() == 0.0);
+
+    MESSAGE("VSync at or below the refresh rate leaves pacing to the swap chain");
+    pacer.set_target_fps(60);
+    pacer.set_vsync(true, 60.0f);
+    CHECK(pacer.get_target_frame_time() == 0.0);
+
+    MESSAGE("A cap below the refresh rate is still enforced with vsync");
+    pacer.set_target_fps(30);
+    pacer.set_vsync(true, 144.0f);
+    CHECK(pacer.get_target_frame_time() == doctest::Approx(1.0 / 30.0).epsilon(0.001));
+
+    MESSAGE("Throttled windows fall back to the background frame rate");
+    pacer.set_background_fps(10);
+    pacer.set_throttled(true);
+    CHECK(pacer.get_target_frame_time() == doctest::Approx(1.0 / 10.0).epsilon(0.001));
+}
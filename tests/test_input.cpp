@@ -0,0 +1,97 @@
+#include "core/system/input.h"
+#include <doctest/doctest.h>
+
+static SDL_Event make_key_event(SDL_EventType type, SDL_Scancode scancode) {
+    SDL_Event event    = {};
+    event.type         = type;
+    event.key.scancode = scancode;
+    event.key.down     = type == SDL_EVENT_KEY_DOWN;
+    return event;
+}
+
+static SDL_Event make_motion_event(float xrel, float yrel) {
+    SDL_Event event   = {};
+    event.type        = SDL_EVENT_MOUSE_MOTION;
+    event.motion.xrel = xrel;
+    event.motion.yrel = yrel;
+    return event;
+}
+
+TEST_CASE("Input action edges and held state") {
+    Input input;
+    input.add_action("jump");
+    input.bind_key("jump", SDL_SCANCODE_SPACE);
+    input.bind_key("jump", SDL_SCANCODE_W);
+
+    input.begin_frame();
+    input.process_event(make_key_event(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_SPACE));
+    CHECK(input.is_action_pressed("jump"));
+    CHECK(input.is_action_held("jump"));
+    CHECK(input.is_key_pressed(SDL_SCANCODE_SPACE));
+
+    MESSAGE("Edges only last one frame");
+    input.begin_frame();
+    CHECK_FALSE(input.is_action_pressed("jump"));
+    CHECK(input.is_action_held("jump"));
+
+    MESSAGE("A second binding keeps the action held");
+    input.process_event(make_key_event(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_W));
+    input.process_event(make_key_event(SDL_EVENT_KEY_UP, SDL_SCANCODE_SPACE));
+    CHECK(input.is_action_held("jump"));
+    CHECK_FALSE(input.is_action_released("jump"));
+
+    input.process_event(make_key_event(SDL_EVENT_KEY_UP, SDL_SCANCODE_W));
+    CHECK(input.is_action_released("jump"));
+    CHECK_FALSE(input.is_action_held("jump"));
+}
+
+TEST_CASE("Input axes and subscriptions") {
+    Input input;
+    input.add_action("left");
+    input.add_action("right");
+    input.bind_key("left", SDL_SCANCODE_A);
+    input.bind_key("right", SDL_SCANCODE_D);
+
+    int calls = 0;
+    int owner = 0;
+    CHECK(input.subscribe("right", &owner, [&](const std::string& action, bool is_pressed) {
+        CHECK(action == "right");
+        calls += is_pressed ? 1 : 10;
+    }));
+    CHECK_FALSE(input.subscribe("missing", &owner, [](const std::string&, bool) {}));
+
+    input.begin_frame();
+    input.process_event(make_key_event(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_D));
+    input.process_event(make_key_event(SDL_EVENT_KEY_DOWN, SDL_SCANCODE_A));
+    CHECK(input.get_axis("left", "right") == 0.0f);
+
+    input.process_event(make_key_event(SDL_EVENT_KEY_UP, SDL_SCANCODE_A));
+    CHECK(input.get_axis("left", "right") == 1.0f);
+
+    input.dispatch();
+    CHECK(calls == 1);
+
+    MESSAGE("Unsubscribed owners are not woken");
+    input.unsubscribe(&owner);
+    input.begin_frame();
+    input.process_event(make_key_event(SDL_EVENT_KEY_UP, SDL_SCANCODE_D));
+    input.dispatch();
+    CHECK(calls == 1);
+}
+
+TEST_CASE("Input coalesces mouse motion") {
+    Input input;
+
+    input.begin_frame();
+    for (int i = 0; i < 32; ++i) {
+        input.process_event(make_motion_event(1.0f, -2.0f));
+    }
+
+    CHECK(input.get_events().size() == 1);
+    CHECK(input.get_events().front().motion.xrel == doctest::Approx(32.0f));
+    CHECK(input.get_mouse_delta().y == doctest::Approx(-64.0f));
+
+    input.begin_frame();
+    CHECK(input.get_events().empty());
+    CHECK(input.get_mouse_delta().x == 0.0f);
+}
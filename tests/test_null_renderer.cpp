@@ -0,0 +1,175 @@
+#include "core/renderer/null/null_renderer.h"
+#include "core/engine.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("Null renderer records work instead of drawing") {
+    NullRenderer renderer;
+    REQUIRE(renderer.initialize(nullptr));
+
+    Transform2D t2d;
+    Transform3D t3d;
+    MeshInstance3D mesh;
+
+    renderer.clear(glm::vec4(0.0f));
+    renderer.draw_rect(t2d, 32, 32, glm::vec4(1.0f), true);
+    renderer.draw_line(t2d, {10, 0}, glm::vec4(1.0f));
+    renderer.draw_mesh(t3d, mesh, nullptr);
+    renderer.draw_mesh(t3d, mesh, nullptr);
+    renderer.flush(glm::mat4(1.0f), glm::mat4(1.0f));
+    renderer.present();
+
+    const auto& frame = renderer.get_frame_stats();
+    CHECK(frame.draw_calls == 4);
+    CHECK(frame.vertices == 6);
+    CHECK(frame.flushes == 1);
+
+    MESSAGE("Instances of the same mesh end up in a single batch");
+    CHECK(frame.instances == 2);
+    CHECK(frame.batches == 1);
+    CHECK(frame.submitted_bytes > 0);
+
+    MESSAGE("A new frame starts from zero while totals keep growing");
+    renderer.clear(glm::vec4(0.0f));
+    renderer.draw_rect(t2d, 32, 32, glm::vec4(1.0f), true);
+    renderer.present();
+
+    CHECK(renderer.get_frame_stats().draw_calls == 1);
+    CHECK(renderer.get_total_stats().draw_calls == 5);
+}
+
+TEST_CASE("Null renderer draws every animated instance of a mesh in one batch") {
+    NullRenderer renderer;
+    REQUIRE(renderer.initialize(nullptr));
+
+    auto mesh       = std::make_unique<NullMesh>();
+    mesh->has_bones = true;
+    mesh->bones.resize(3);
+
+    Model model;
+    model.meshes.push_back(std::move(mesh));
+
+    std::vector<glm::mat4> pose_a(MAX_BONES, glm::mat4(1.0f));
+    std::vector<glm::mat4> pose_b(MAX_BONES, glm::mat4(2.0f));
+
+    Transform3D t3d;
+
+    renderer.clear(glm::vec4(0.0f));
+    renderer.draw_animated_model(t3d, &model, pose_a.data(), static_cast<int>(pose_a.size()));
+    renderer.draw_animated_model(t3d, &model, pose_b.data(), static_cast<int>(pose_b.size()));
+    renderer.flush(glm::mat4(1.0f), glm::mat4(1.0f));
+    renderer.present();
+
+    const auto& frame = renderer.get_frame_stats();
+    CHECK(frame.batches == 1); // the skybox is not counted
+    CHECK(frame.instances == 2);
+
+    MESSAGE("Only the bones of the mesh are uploaded, 3 rows per bone and per instance");
+    const Uint64 instance_bytes = 2 * (sizeof(glm::mat4) + sizeof(glm::vec3) + sizeof(Sint32));
+    CHECK(frame.submitted_bytes == instance_bytes + 2 * 3 * 3 * sizeof(glm::vec4));
+}
+
+TEST_CASE("Null renderer culls instances outside of the camera and light frustums") {
+    NullRenderer renderer;
+    REQUIRE(renderer.initialize(nullptr));
+
+    const glm::mat4 view       = glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+
+    MeshInstance3D mesh;
+    Transform3D in_view, shadow_only, culled;
+    in_view.position     = {0, 0, -10};
+    shadow_only.position = {0, 0, 10};  // behind the camera, can still cast a shadow into the view
+    culled.position      = {0, 0, 500}; // behind the camera and out of the sun frustum
+
+    renderer.clear(glm::vec4(0.0f));
+    renderer.set_view_3d(view, projection);
+    renderer.draw_mesh(in_view, mesh, nullptr);
+    renderer.draw_mesh(shadow_only, mesh, nullptr);
+    renderer.draw_mesh(culled, mesh, nullptr);
+    renderer.flush(view, projection);
+    renderer.present();
+
+    const auto& frame = renderer.get_frame_stats();
+    CHECK(frame.draw_calls == 2);
+    CHECK(frame.instances == 2);
+}
+
+TEST_CASE("Null renderer only redraws the static shadows when they are invalidated") {
+    NullRenderer renderer;
+    REQUIRE(renderer.initialize(nullptr));
+
+    const glm::mat4 view       = glm::lookAt(glm::vec3(0, 5, 10), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 200.0f);
+    const int cascades         = GEngine->get_config().get_shadows().cascade_count;
+
+    MeshInstance3D mesh;
+    Transform3D ground, prop;
+    prop.position = {2, 1, 0};
+
+    const auto frame = [&](const glm::mat4& camera) {
+        renderer.clear(glm::vec4(0.0f));
+        renderer.set_view_3d(camera, projection);
+        renderer.draw_mesh(ground, mesh, nullptr, true);
+        renderer.draw_mesh(prop, mesh, nullptr);
+        renderer.flush(camera, projection);
+        renderer.present();
+
+        return renderer.get_frame_stats();
+    };
+
+    MESSAGE("The first frame fills the cache of every cascade");
+    NullRenderStats stats = frame(view);
+    CHECK(stats.static_shadow_redraws == cascades);
+    CHECK(stats.shadow_instances == 2 * cascades);
+
+    MESSAGE("Nothing moved, only the dynamic caster is drawn");
+    stats = frame(view);
+    CHECK(stats.static_shadow_redraws == 0);
+    CHECK(stats.shadow_instances == cascades);
+
+    MESSAGE("A static caster moved, every cascade is redrawn");
+    ground.position.x = 1.0f;
+    stats             = frame(view);
+    CHECK(stats.static_shadow_redraws == cascades);
+
+    MESSAGE("The camera moved, some cascades are redrawn");
+    stats = frame(glm::lookAt(glm::vec3(0, 5, 30), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0)));
+    CHECK(stats.static_shadow_redraws > 0);
+}
+
+TEST_CASE("Null renderer merges the submissions of every worker stage") {
+    NullRenderer renderer;
+    REQUIRE(renderer.initialize(nullptr));
+    renderer.set_stage_count(2);
+
+    auto mesh       = std::make_unique<NullMesh>();
+    mesh->has_bones = true;
+    mesh->bones.resize(3);
+
+    Model model;
+    model.meshes.push_back(std::move(mesh));
+
+    std::vector<glm::mat4> pose(MAX_BONES, glm::mat4(1.0f));
+
+    Transform3D t3d;
+    MeshInstance3D cube;
+
+    renderer.clear(glm::vec4(0.0f));
+    renderer.draw_animated_model(t3d, &model, pose.data(), static_cast<int>(pose.size()), -1, 0);
+    renderer.draw_animated_model(t3d, &model, pose.data(), static_cast<int>(pose.size()), -1, 1);
+    renderer.draw_mesh(t3d, cube, nullptr, false, 1);
+
+    MESSAGE("A stage the world does not have is rejected");
+    renderer.draw_mesh(t3d, cube, nullptr, false, 2);
+
+    renderer.flush(glm::mat4(1.0f), glm::mat4(1.0f));
+    renderer.present();
+
+    const auto& frame = renderer.get_frame_stats();
+    CHECK(frame.draw_calls == 3);
+    CHECK(frame.instances == 3);
+    CHECK(frame.batches == 2); // the skinned mesh of both stages, and the cube
+
+    MESSAGE("Both palettes are uploaded once");
+    CHECK(frame.submitted_bytes == 3 * (sizeof(glm::mat4) + sizeof(glm::vec3) + sizeof(Sint32)) + 2 * 3 * 3 * sizeof(glm::vec4));
+}
@@ -0,0 +1,123 @@
+#include "core/component/logic/particle_pool.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("ParticlePool has a fixed capacity") {
+    ParticlePool pool;
+    pool.set_capacity(3);
+
+    CHECK(pool.get_capacity() == 3);
+    CHECK(pool.emit({0, 0, 0}, {0, 0, 0}, 1.0f));
+    CHECK(pool.emit({0, 0, 0}, {0, 0, 0}, 1.0f));
+    CHECK(pool.emit({0, 0, 0}, {0, 0, 0}, 1.0f));
+    CHECK_FALSE(pool.emit({0, 0, 0}, {0, 0, 0}, 1.0f));
+    CHECK(pool.size() == 3);
+
+    pool.clear();
+    CHECK(pool.size() == 0);
+    CHECK(pool.emit({0, 0, 0}, {0, 0, 0}, 1.0f));
+}
+
+TEST_CASE("ParticlePool integrates every particle") {
+    ParticlePool pool;
+    pool.set_capacity(64);
+
+    // Past a multiple of 4, so the scalar tail runs too
+    for (int i = 0; i < 7; i++) {
+        pool.emit({static_cast<float>(i), 0, 0}, {0, 10, 0}, 10.0f);
+    }
+
+    pool.update(0.5f, {0, -4, 0}, 0.0f, {1, 1, 1, 1}, {1, 1, 1, 1});
+
+    REQUIRE(pool.size() == 7);
+
+    const float* x  = pool.get_stream(ParticlePool::POSITION_X);
+    const float* y  = pool.get_stream(ParticlePool::POSITION_Y);
+    const float* vy = pool.get_stream(ParticlePool::VELOCITY_Y);
+
+    for (size_t i = 0; i < pool.size(); i++) {
+        CHECK(x[i] == doctest::Approx(static_cast<float>(i)));
+        CHECK(vy[i] == doctest::Approx(8.0f));
+        CHECK(y[i] == doctest::Approx(4.0f));
+    }
+
+    CHECK(pool.get_bounds_min().x == doctest::Approx(0.0f));
+    CHECK(pool.get_bounds_max().x == doctest::Approx(6.0f));
+    CHECK(pool.get_bounds_max().y == doctest::Approx(4.0f));
+
+    MESSAGE("Damping removes a fraction of the velocity per second");
+    pool.update(0.5f, {0, 0, 0}, 1.0f, {1, 1, 1, 1}, {1, 1, 1, 1});
+    CHECK(vy[6] == doctest::Approx(4.0f));
+}
+
+TEST_CASE("ParticlePool recycles expired particles") {
+    ParticlePool pool;
+    pool.set_capacity(8);
+
+    for (int i = 0; i < 8; i++) {
+        // Every other particle expires after one second
+        pool.emit({static_cast<float>(i), 0, 0}, {0, 0, 0}, i % 2 == 0 ? 1.0f : 5.0f);
+    }
+
+    pool.update(1.5f, {0, 0, 0}, 0.0f, {1, 1, 1, 1}, {1, 1, 1, 1});
+    REQUIRE(pool.size() == 4);
+
+    // The survivors are packed at the front, in any order
+    const float* x = pool.get_stream(ParticlePool::POSITION_X);
+    float sum      = 0.0f;
+
+    for (size_t i = 0; i < pool.size(); i++) {
+        CHECK(static_cast<int>(x[i]) % 2 == 1);
+        sum += x[i];
+    }
+    CHECK(sum == doctest::Approx(1.0f + 3.0f + 5.0f + 7.0f));
+
+    // The freed slots are used again
+    for (int i = 0; i < 4; i++) {
+        CHECK(pool.emit({0, 0, 0}, {0, 0, 0}, 1.0f));
+    }
+    CHECK_FALSE(pool.emit({0, 0, 0}, {0, 0, 0}, 1.0f));
+}
+
+TEST_CASE("ParticlePool blends the colors by age") {
+    ParticlePool pool;
+    pool.set_capacity(5);
+
+    for (int i = 0; i < 5; i++) {
+        pool.emit({0, 0, 0}, {0, 0, 0}, 4.0f);
+    }
+
+    pool.update(1.0f, {0, 0, 0}, 0.0f, {1, 0, 0, 1}, {0, 0, 1, 0});
+
+    const float* r = pool.get_stream(ParticlePool::COLOR_R);
+    const float* b = pool.get_stream(ParticlePool::COLOR_B);
+    const float* a = pool.get_stream(ParticlePool::COLOR_A);
+
+    for (size_t i = 0; i < pool.size(); i++) {
+        CHECK(r[i] == doctest::Approx(0.75f));
+        CHECK(b[i] == doctest::Approx(0.25f));
+        CHECK(a[i] == doctest::Approx(0.75f));
+    }
+}
+
+TEST_CASE("Particle random values stay in [0, 1)") {
+    Uint32 state = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        const float value = next_particle_random(state);
+        CHECK(value >= 0.0f);
+        CHECK(value < 1.0f);
+    }
+}
+
+TEST_CASE("Particle seeds differ between neighbouring entities") {
+    Uint32 first  = seed_particle_random(500);
+    Uint32 second = seed_particle_random(501);
+
+    CHECK(first != 0);
+    CHECK(second != 0);
+    CHECK(first != second);
+    CHECK(seed_particle_random(0) != 0);
+
+    MESSAGE("Their sequences are unrelated from the first value");
+    CHECK(next_particle_random(first) != next_particle_random(second));
+}
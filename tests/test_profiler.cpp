@@ -0,0 +1,51 @@
+#include "core/system/profiler.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("Profiler records nested zones as Chrome trace events") {
+    auto& profiler = Profiler::get_instance();
+    profiler.clear();
+    profiler.set_enabled(true);
+
+    {
+        PROFILE_SCOPE("outer");
+        PROFILE_SCOPE("inner");
+    }
+
+    const std::string trace = profiler.get_chrome_trace();
+    CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+    CHECK(trace.find("\"name\":\"outer\"") != std::string::npos);
+    CHECK(trace.find("\"name\":\"inner\",\"cat\":\"cpu\",\"ph\":\"X\"") != std::string::npos);
+    CHECK(trace.find("\"depth\":1") != std::string::npos);
+
+    MESSAGE("Nothing is recorded while disabled");
+    profiler.clear();
+    profiler.set_enabled(false);
+    {
+        PROFILE_SCOPE("ignored");
+    }
+    CHECK(profiler.get_chrome_trace().find("ignored") == std::string::npos);
+}
+
+TEST_CASE("Profiler stays balanced when toggled inside a zone") {
+    auto& profiler = Profiler::get_instance();
+    profiler.clear();
+    profiler.set_enabled(false);
+
+    PROFILE_BEGIN("skipped");
+    profiler.set_enabled(true);
+    {
+        PROFILE_SCOPE("recorded");
+    }
+    PROFILE_END();
+
+    MESSAGE("The zone opened while disabled does not close the next recorded one");
+    PROFILE_BEGIN("outer");
+    PROFILE_END();
+
+    const std::string trace = profiler.get_chrome_trace();
+    CHECK(trace.find("\"name\":\"recorded\"") != std::string::npos);
+    CHECK(trace.find("\"name\":\"outer\"") != std::string::npos);
+    CHECK(trace.find("skipped") == std::string::npos);
+
+    profiler.set_enabled(false);
+}
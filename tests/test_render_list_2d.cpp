@@ -0,0 +1,128 @@
+#include "core/component/logic/render_list_2d.h"
+#include "core/component/logic/system_helper.h"
+#include "core/component/logic/tilemap_2d.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("RenderList2D keeps a stable z order") {
+    RenderList2D list; // outlives the world, its observers fire on world teardown
+    flecs::world world;
+    list.attach(world);
+
+    auto a = world.entity().set<Transform2D>({.z_index = 1}).set<Shape2D>({});
+    auto b = world.entity().set<Transform2D>({.z_index = 0}).set<Sprite2D>({});
+    auto c = world.entity().set<Transform2D>({.z_index = 1}).set<Label2D>({});
+    world.entity().set<Transform2D>({}); // nothing to draw
+
+    list.sync();
+    REQUIRE(list.size() == 3);
+    CHECK(list.get_draw_order() == std::vector<flecs::entity>{b, a, c});
+
+    MESSAGE("Changing z_index re-sorts, ties keep their arrival order");
+    a.get_mut<Transform2D>().z_index = 5;
+    b.get_mut<Transform2D>().z_index = 1;
+    list.sync();
+    CHECK(list.get_draw_order() == std::vector<flecs::entity>{b, c, a});
+
+    MESSAGE("New entities are merged in, removed ones dropped");
+    auto d = world.entity().set<Transform2D>({.z_index = 1}).set<Sprite2D>({});
+    c.destruct();
+    list.sync();
+    CHECK(list.get_draw_order() == std::vector<flecs::entity>{b, d, a});
+
+    MESSAGE("Disabled entities are not drawn");
+    d.add(flecs::Disabled);
+    list.sync();
+    CHECK(list.get_draw_order() == std::vector<flecs::entity>{b, a});
+
+    d.remove(flecs::Disabled);
+    list.sync();
+    CHECK(list.get_draw_order() == std::vector<flecs::entity>{b, d, a});
+}
+
+TEST_CASE("RenderList2D culls to the camera rectangle") {
+    RenderList2D list;
+    flecs::world world;
+    list.attach(world);
+
+    auto near = world.entity().set<Transform2D>({.position = {100, 100}, .z_index = 2}).set<Shape2D>({});
+    auto far  = world.entity().set<Transform2D>({.position = {5000, 100}}).set<Sprite2D>({});
+    auto back = world.entity().set<Transform2D>({.position = {120, 90}, .z_index = 1}).set<Shape2D>({});
+    auto label = world.entity().set<Transform2D>({.position = {9000, 9000}}).set<Label2D>({});
+
+    // Bounds follow the world transform, which the propagation systems write
+    for (auto e : {near, far, back, label}) {
+        propagate_transform_2d(e.get_mut<Transform2D>(), nullptr, nullptr, 1.0f);
+    }
+
+    list.sync();
+
+    Camera2D camera;
+    const Rect2D view = camera.get_visible_rect(800, 600);
+
+    CHECK(list.get_draw_order(view) == std::vector<flecs::entity>{label, back, near});
+
+    MESSAGE("Moving an entity updates its bounds");
+    far.get_mut<Transform2D>().position = {300, 300};
+    propagate_transform_2d(far.get_mut<Transform2D>(), nullptr, nullptr, 1.0f);
+    list.sync();
+
+    CHECK(list.get_draw_order(view) == std::vector<flecs::entity>{far, label, back, near});
+
+    MESSAGE("Picking returns the entities under the point, topmost last");
+    std::vector<flecs::entity> picked;
+    list.query_point({110, 95}, picked);
+    CHECK(picked == std::vector<flecs::entity>{label, back, near});
+
+    MESSAGE("The visible rectangle follows the camera");
+    camera.position = {4800, 0}; // shows world x in [4800, 5600]
+    CHECK(list.get_draw_order(camera.get_visible_rect(800, 600)) == std::vector<flecs::entity>{label});
+}
+
+TEST_CASE("RenderList2D refreshes the bounds of a resized drawable") {
+    RenderList2D list;
+    flecs::world world;
+    list.attach(world);
+
+    auto shape  = world.entity().set<Transform2D>({.position = {1000, 300}}).set<Shape2D>({});
+    auto sprite = world.entity().set<Transform2D>({.position = {300, -1000}}).set<Sprite2D>({});
+
+    for (auto e : {shape, sprite}) {
+        propagate_transform_2d(e.get_mut<Transform2D>(), nullptr, nullptr, 1.0f);
+    }
+
+    list.sync();
+
+    Camera2D camera;
+    const Rect2D view = camera.get_visible_rect(800, 600);
+    CHECK(list.get_draw_order(view).empty());
+
+    MESSAGE("Setting a drawable refreshes its bounds without moving its transform");
+    shape.set<Shape2D>({.size = {600, 32}});
+    list.sync();
+    CHECK(list.get_draw_order(view) == std::vector<flecs::entity>{shape});
+
+    MESSAGE("In-place changes are picked up once flagged with modified");
+    sprite.get_mut<Sprite2D>().source = {0, 0, 32, 1200};
+    sprite.modified<Sprite2D>();
+    list.sync();
+    CHECK(list.get_draw_order(view) == std::vector<flecs::entity>{shape, sprite});
+}
+
+TEST_CASE("RenderList2D follows a tilemap resized in place") {
+    RenderList2D list;
+    flecs::world world;
+    list.attach(world);
+
+    auto map = world.entity().set<Transform2D>({.position = {-1000, 0}}).set<TileMap2D>({.tile_size = {16, 16}});
+    resize_tilemap(map.get_mut<TileMap2D>(), 10, 10);
+    propagate_transform_2d(map.get_mut<Transform2D>(), nullptr, nullptr, 1.0f);
+    list.sync();
+
+    Camera2D camera;
+    const Rect2D view = camera.get_visible_rect(800, 600);
+    CHECK(list.get_draw_order(view).empty());
+
+    resize_tilemap(map.get_mut<TileMap2D>(), 100, 10);
+    list.sync();
+    CHECK(list.get_draw_order(view) == std::vector<flecs::entity>{map});
+}
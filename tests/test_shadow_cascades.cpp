@@ -0,0 +1,141 @@
+#include "core/renderer/shadow_cascades.h"
+#include <doctest/doctest.h>
+
+namespace {
+    struct CascadeView {
+        glm::mat4 view       = glm::lookAt(glm::vec3(3, 4, 10), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+        glm::vec3 to_light   = glm::normalize(glm::vec3(1.0f, 2.5f, 1.0f));
+    };
+} // namespace
+
+TEST_CASE("ShadowCascades splits the view up to the shadow distance") {
+    const CascadeView camera;
+
+    Shadows config;
+    config.cascade_count = 3;
+    config.distance      = 150.0f;
+
+    ShadowCascades cascades;
+    cascades.fit(camera.view, camera.projection, camera.to_light, config);
+
+    REQUIRE(cascades.count == 3);
+    CHECK(cascades.splits[0] > 0.1f);
+    CHECK(cascades.splits[0] < cascades.splits[1]);
+    CHECK(cascades.splits[1] < cascades.splits[2]);
+    CHECK(cascades.splits[2] == doctest::Approx(150.0f));
+
+    MESSAGE("The logarithmic part keeps the first cascade close to the camera");
+    CHECK(cascades.splits[0] < 50.0f);
+
+    MESSAGE("The cascade count is clamped");
+    config.cascade_count = 12;
+    cascades.fit(camera.view, camera.projection, camera.to_light, config);
+    CHECK(cascades.count == MAX_SHADOW_CASCADES);
+
+    config.cascade_count = 0;
+    cascades.fit(camera.view, camera.projection, camera.to_light, config);
+    CHECK(cascades.count == 1);
+}
+
+TEST_CASE("ShadowCascades enclose their slice of the view") {
+    const CascadeView camera;
+
+    Shadows config;
+    config.cascade_count = 4;
+
+    ShadowCascades cascades;
+    cascades.fit(camera.view, camera.projection, camera.to_light, config);
+
+    const glm::mat4 inverse_view = glm::inverse(camera.view);
+    const float tan_y            = SDL_tanf(glm::radians(30.0f));
+    const float tan_x            = tan_y * 16.0f / 9.0f;
+
+    float slice_near = 0.1f;
+
+    for (int c = 0; c < cascades.count; c++) {
+        CAPTURE(c);
+
+        for (const float depth : {slice_near, cascades.splits[c]}) {
+            for (int i = 0; i < 4; i++) {
+                const float x = (i & 1 ? 1.0f : -1.0f) * tan_x * depth;
+                const float y = (i & 2 ? 1.0f : -1.0f) * tan_y * depth;
+
+                const glm::vec4 corner = inverse_view * glm::vec4(x, y, -depth, 1.0f);
+                const glm::vec4 clip   = cascades.matrices[c] * corner;
+                const glm::vec4 caster = cascades.caster_matrix * corner;
+
+                CHECK(SDL_fabsf(clip.x) <= clip.w * 1.001f);
+                CHECK(SDL_fabsf(clip.y) <= clip.w * 1.001f);
+                CHECK(SDL_fabsf(clip.z) <= clip.w * 1.001f);
+
+                CHECK(SDL_fabsf(caster.x) <= caster.w * 1.001f);
+                CHECK(SDL_fabsf(caster.y) <= caster.w * 1.001f);
+            }
+        }
+
+        slice_near = cascades.splits[c];
+    }
+}
+
+TEST_CASE("ShadowCascades move by whole texels") {
+    CascadeView camera;
+
+    Shadows config;
+    config.cascade_count = 2;
+    config.resolution    = 1024;
+
+    ShadowCascades before;
+    before.fit(camera.view, camera.projection, camera.to_light, config);
+
+    // A small step of the camera, less than a texel of the far cascade
+    camera.view = glm::translate(camera.view, glm::vec3(0.013f, 0.0f, 0.007f));
+
+    ShadowCascades after;
+    after.fit(camera.view, camera.projection, camera.to_light, config);
+
+    for (int c = 0; c < config.cascade_count; c++) {
+        CAPTURE(c);
+
+        // The world origin lands on the same texel grid, whole texels apart
+        const glm::vec4 a = before.matrices[c] * glm::vec4(0, 0, 0, 1);
+        const glm::vec4 b = after.matrices[c] * glm::vec4(0, 0, 0, 1);
+
+        const float texels_x = (b.x - a.x) * 0.5f * static_cast<float>(config.resolution);
+        const float texels_y = (b.y - a.y) * 0.5f * static_cast<float>(config.resolution);
+
+        CHECK(SDL_fabsf(texels_x - SDL_roundf(texels_x)) < 0.01f);
+        CHECK(SDL_fabsf(texels_y - SDL_roundf(texels_y)) < 0.01f);
+    }
+}
+
+TEST_CASE("StaticShadowCache invalidates moved cascades and changed casters") {
+    CascadeView camera;
+
+    Shadows config;
+    config.cascade_count = 3;
+
+    ShadowCascades cascades;
+    cascades.fit(camera.view, camera.projection, camera.to_light, config);
+
+    StaticShadowCache cache;
+    CHECK(cache.update(cascades, 42) == 0b111);
+    CHECK(cache.update(cascades, 42) == 0);
+
+    MESSAGE("Other static casters, every cascade");
+    CHECK(cache.update(cascades, 43) == 0b111);
+
+    MESSAGE("A camera step smaller than a texel keeps the matrices");
+    ShadowCascades moved;
+    moved.fit(glm::translate(camera.view, glm::vec3(0.0001f, 0.0f, 0.0f)), camera.projection, camera.to_light, config);
+
+    Uint32 redraws = cache.update(moved, 43);
+    CHECK((redraws & 0b100) == 0); // the far cascade has the largest texels
+
+    MESSAGE("The sun moved, every cascade");
+    moved.fit(camera.view, camera.projection, glm::normalize(glm::vec3(-1.0f, 2.0f, 0.5f)), config);
+    CHECK(cache.update(moved, 43) == 0b111);
+
+    cache.invalidate();
+    CHECK(cache.update(moved, 43) == 0b111);
+}
@@ -0,0 +1,123 @@
+#include "core/component/logic/system_helper.h"
+#include "core/renderer/shape_tessellation.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("Circle segment count follows the on-screen radius") {
+    CHECK(get_circle_segments(0.0f) == CIRCLE_MIN_SEGMENTS);
+    CHECK(get_circle_segments(2.0f) == CIRCLE_MIN_SEGMENTS);
+    CHECK(get_circle_segments(100000.0f) == CIRCLE_MAX_SEGMENTS);
+    CHECK(get_circle_segments(4.0e6f) == CIRCLE_MAX_SEGMENTS); // the cosine rounds to 1
+    CHECK(get_circle_segments(FLT_MAX) == CIRCLE_MAX_SEGMENTS);
+    CHECK(get_circle_segments(NAN) == CIRCLE_MIN_SEGMENTS);
+
+    int previous = 0;
+    for (float radius = 1.0f; radius < 4096.0f; radius *= 2.0f) {
+        const int segments = get_circle_segments(radius);
+
+        CHECK(segments % 4 == 0);
+        CHECK(segments >= previous);
+        previous = segments;
+    }
+
+    MESSAGE("Below the cap, the polygon stays within CIRCLE_MAX_ERROR of the circle");
+    const float radius = 64.0f;
+    const int segments = get_circle_segments(radius);
+    const float sagitta = radius * (1.0f - SDL_cosf(glm::pi<float>() / static_cast<float>(segments)));
+    CHECK(sagitta <= CIRCLE_MAX_ERROR);
+}
+
+TEST_CASE("Unit circles are cached per segment count") {
+    const auto& circle = get_unit_circle(16);
+
+    REQUIRE(circle.size() == 16);
+    CHECK(&circle == &get_unit_circle(16));
+    CHECK(circle[0].x == doctest::Approx(1.0f));
+    CHECK(circle[4].y == doctest::Approx(1.0f));
+
+    for (const glm::vec2& point : circle) {
+        CHECK(glm::length(point) == doctest::Approx(1.0f));
+    }
+}
+
+namespace {
+
+    float triangles_area(const std::vector<glm::vec2>& points, const std::vector<int>& triangles) {
+        float area = 0.0f;
+
+        for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+            const glm::vec2 a = points[triangles[i]];
+            const glm::vec2 b = points[triangles[i + 1]];
+            const glm::vec2 c = points[triangles[i + 2]];
+            area += SDL_fabsf((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2.0f;
+        }
+
+        return area;
+    }
+
+} // namespace
+
+TEST_CASE("Concave polygons are ear-clipped in either winding") {
+    std::vector<glm::vec2> l_shape = {{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}};
+    std::vector<int> triangles;
+
+    CHECK(triangulate_polygon(l_shape, triangles));
+    CHECK(triangles.size() == 4 * 3);
+    CHECK(triangles_area(l_shape, triangles) == doctest::Approx(3.0f));
+
+    std::reverse(l_shape.begin(), l_shape.end());
+
+    CHECK(triangulate_polygon(l_shape, triangles));
+    CHECK(triangles_area(l_shape, triangles) == doctest::Approx(3.0f));
+
+    MESSAGE("Collinear vertices produce no sliver triangles");
+    const std::vector<glm::vec2> square = {{0, 0}, {1, 0}, {2, 0}, {2, 2}, {0, 2}};
+
+    CHECK(triangulate_polygon(square, triangles));
+    CHECK(triangles.size() == 3 * 3);
+    CHECK(triangles_area(square, triangles) == doctest::Approx(4.0f));
+
+    const std::vector<glm::vec2> line = {{0, 0}, {1, 0}, {2, 0}};
+    CHECK_FALSE(triangulate_polygon(line, triangles));
+    CHECK(triangles.empty());
+}
+
+TEST_CASE("Shape2D polygons are triangulated once per vertex change") {
+    Shape2D shape{.type = ShapeType::POLYGON, .vertices = {{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}}};
+
+    const std::vector<int>& triangles = get_polygon_triangles(shape);
+    REQUIRE(triangles.size() == 4 * 3);
+
+    // Unchanged vertices keep the cached indices
+    shape.triangles[0] = -1;
+    CHECK(get_polygon_triangles(shape)[0] == -1);
+
+    shape.vertices.pop_back();
+    CHECK(get_polygon_triangles(shape).size() == 3 * 3);
+    CHECK(get_polygon_triangles(shape)[0] != -1);
+}
+
+TEST_CASE("Outlines are closed strips of the requested width") {
+    const glm::vec2 square[4] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+
+    std::vector<glm::vec2> positions;
+    std::vector<int> indices;
+    build_outline(square, 4, 2.0f, positions, indices);
+
+    REQUIRE(positions.size() == 4 * 2);
+    CHECK(indices.size() == 4 * 6);
+
+    // Each corner is split across the edge, one vertex per side
+    for (size_t i = 0; i < 4; i++) {
+        const glm::vec2 offset = positions[2 * i] - square[i];
+        CHECK(SDL_fabsf(offset.x) == doctest::Approx(1.0f));
+        CHECK(SDL_fabsf(offset.y) == doctest::Approx(1.0f));
+
+        const glm::vec2 middle = (positions[2 * i] + positions[2 * i + 1]) * 0.5f;
+        CHECK(middle.x == doctest::Approx(square[i].x));
+        CHECK(middle.y == doctest::Approx(square[i].y));
+    }
+
+    build_outline(square, 1, 2.0f, positions, indices);
+    CHECK(positions.empty());
+    CHECK(indices.empty());
+}
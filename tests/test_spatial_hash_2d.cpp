@@ -0,0 +1,74 @@
+#include "core/component/logic/spatial_hash_2d.h"
+#include <doctest/doctest.h>
+
+namespace {
+
+    std::vector<Uint64> query(const SpatialHash2D& hash, const Rect2D& rect) {
+        std::vector<Uint64> found;
+        hash.query(rect, [&](Uint32 handle) { found.push_back(hash.get_user_data(handle)); });
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+} // namespace
+
+TEST_CASE("SpatialHash2D reports each overlapping item once") {
+    SpatialHash2D hash(100.0f);
+
+    const Uint32 small = hash.insert({{10, 10}, {20, 20}}, 1);
+    hash.insert({{50, 50}, {350, 150}}, 2); // spans several cells
+    hash.insert({{-500, -500}, {-450, -450}}, 3);
+
+    CHECK(hash.size() == 3);
+    CHECK(query(hash, {{0, 0}, {400, 400}}) == std::vector<Uint64>{1, 2});
+    CHECK(query(hash, {{-1000, -1000}, {1000, 1000}}) == std::vector<Uint64>{1, 2, 3});
+    CHECK(query(hash, {{25, 25}, {30, 30}}).empty());
+
+    MESSAGE("Moving an item follows it across cells");
+    hash.update(small, {{-480, -480}, {-470, -470}});
+    CHECK(query(hash, {{-500, -500}, {-400, -400}}) == std::vector<Uint64>{1, 3});
+    CHECK(query(hash, {{0, 0}, {30, 30}}).empty());
+
+    MESSAGE("Removed handles are reused");
+    hash.remove(small);
+    CHECK(hash.size() == 2);
+    CHECK(hash.insert({{0, 0}, {1, 1}}, 4) == small);
+}
+
+TEST_CASE("SpatialHash2D keeps huge items out of the grid") {
+    SpatialHash2D hash(10.0f);
+
+    hash.insert({glm::vec2(-FLT_MAX), glm::vec2(FLT_MAX)}, 1);
+    hash.insert({{0, 0}, {5, 5}}, 2);
+
+    std::vector<Uint32> handles;
+    hash.query_point({1000, -1000}, handles);
+
+    REQUIRE(handles.size() == 1);
+    CHECK(hash.get_user_data(handles[0]) == 1);
+}
+
+TEST_CASE("SpatialHash2D handles items unbounded along one axis") {
+    SpatialHash2D hash(10.0f);
+
+    // A line reaching far away on x only, its cell count does not fit an int
+    hash.insert({{0, 0}, {FLT_MAX, 5}}, 1);
+    hash.insert({{0, 0}, {5, 5}}, 2);
+
+    std::vector<Uint32> handles;
+    hash.query_point({1.0e9f, 2}, handles);
+
+    REQUIRE(handles.size() == 1);
+    CHECK(hash.get_user_data(handles[0]) == 1);
+
+    MESSAGE("NaN bounds are kept out of the grid and never reported");
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const Uint32 invalid = hash.insert({glm::vec2(nan), glm::vec2(nan)}, 3);
+
+    handles.clear();
+    hash.query_point({2, 2}, handles);
+    CHECK(handles.size() == 2);
+
+    hash.remove(invalid);
+    CHECK(hash.size() == 2);
+}
@@ -0,0 +1,52 @@
+#include "core/renderer/texture_atlas.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("AtlasPacker places rects without overlap") {
+    AtlasPacker packer(128, 128, 1);
+
+    std::vector<glm::ivec4> placed;
+    glm::ivec2 position;
+
+    for (int i = 0; i < 64; i++) {
+        const int width  = 4 + (i * 7) % 24;
+        const int height = 4 + (i * 13) % 24;
+
+        if (!packer.insert(width, height, position)) {
+            continue;
+        }
+
+        CHECK(position.x >= 0);
+        CHECK(position.y >= 0);
+        CHECK(position.x + width <= 128);
+        CHECK(position.y + height <= 128);
+
+        for (const auto& other : placed) {
+            const bool is_overlapping = position.x < other.x + other.z && other.x < position.x + width && position.y < other.y + other.w &&
+                                        other.y < position.y + height;
+            CHECK_FALSE(is_overlapping);
+        }
+
+        placed.push_back({position.x, position.y, width, height});
+    }
+
+    CHECK(placed.size() > 20);
+    CHECK(packer.get_occupancy() > 0.5f);
+}
+
+TEST_CASE("AtlasPacker rejects rects once full") {
+    AtlasPacker packer(64, 64, 0);
+    glm::ivec2 position;
+
+    CHECK_FALSE(packer.insert(65, 8, position));
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(packer.insert(32, 32, position));
+    }
+
+    CHECK(packer.get_occupancy() == doctest::Approx(1.0f));
+    CHECK_FALSE(packer.insert(1, 1, position));
+
+    packer.reset();
+    CHECK(packer.insert(64, 64, position));
+    CHECK(position == glm::ivec2(0, 0));
+}
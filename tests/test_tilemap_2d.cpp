@@ -0,0 +1,206 @@
+#include "core/component/logic/tilemap_2d.h"
+#include "core/io/file_system.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("TileMap2D stores tiles in lazily allocated chunks") {
+    TileMap2D map;
+    resize_tilemap(map, 100, 40);
+
+    CHECK(map.chunks_x == 4);
+    CHECK(map.chunks_y == 2);
+    REQUIRE(map.chunks.size() == 8);
+
+    // Nothing is allocated for empty chunks
+    for (const TileChunk2D& chunk : map.chunks) {
+        CHECK(chunk.tiles.empty());
+    }
+
+    set_tile(map, 99, 39, 7);
+    set_tile(map, 0, 0, TILE_EMPTY);
+
+    CHECK(get_tile(map, 99, 39) == 7);
+    CHECK(get_tile(map, 98, 39) == TILE_EMPTY);
+    CHECK(get_tile(map, 100, 0) == TILE_EMPTY);
+    CHECK(get_tile(map, -1, 0) == TILE_EMPTY);
+
+    CHECK(map.chunks[0].tiles.empty());
+    CHECK(map.chunks[7].tile_count == 1);
+
+    MESSAGE("Only the touched chunk is rebuilt");
+    for (TileChunk2D& chunk : map.chunks) {
+        chunk.is_dirty = false;
+    }
+
+    set_tile(map, 40, 5, 3);
+    CHECK(map.chunks[1].is_dirty);
+    CHECK_FALSE(map.chunks[0].is_dirty);
+
+    map.chunks[1].is_dirty = false;
+    set_tile(map, 40, 5, 3);
+    CHECK_FALSE(map.chunks[1].is_dirty);
+
+    set_tile(map, 40, 5, TILE_EMPTY);
+    CHECK(map.chunks[1].tile_count == 0);
+}
+
+TEST_CASE("TileMap2D chunks are built into tileset quads") {
+    TileMap2D map{.tile_size = {16, 16}};
+    resize_tilemap(map, 40, 40);
+
+    set_tile(map, 33, 2, 1);
+    set_tile(map, 34, 2, 6); // second row of a 4 columns tileset
+    set_tile(map, 35, 2, 99); // past the tileset, skipped
+
+    // 64x32 tileset at (64, 0) in a 128x128 texture
+    build_tile_chunk(map, 1, 0, {64, 0, 64, 32}, {128, 128});
+
+    const TileChunk2D& chunk = map.chunks[1];
+    CHECK_FALSE(chunk.is_dirty);
+    REQUIRE(chunk.positions.size() == 2 * 4);
+    REQUIRE(chunk.uvs.size() == 2 * 4);
+
+    CHECK(chunk.positions[0] == glm::vec2(33 * 16, 2 * 16));
+    CHECK(chunk.positions[2] == glm::vec2(34 * 16, 3 * 16));
+
+    CHECK(chunk.uvs[0] == glm::vec2(0.5f, 0.0f));
+    CHECK(chunk.uvs[2] == glm::vec2(0.625f, 0.125f));
+    CHECK(chunk.uvs[4] == glm::vec2(0.625f, 0.125f));
+}
+
+TEST_CASE("TileMap2D culls whole chunks against the view") {
+    TileMap2D map{.tile_size = {16, 16}};
+    resize_tilemap(map, 1000, 1000);
+
+    Transform2D t;
+    t.world_position = {100, 0};
+
+    glm::ivec2 min, max;
+
+    // One chunk is 512 world units wide
+    REQUIRE(get_visible_chunks(map, t, {{700, 10}, {1200, 500}}, min, max));
+    CHECK(min == glm::ivec2(1, 0));
+    CHECK(max == glm::ivec2(2, 0));
+
+    CHECK_FALSE(get_visible_chunks(map, t, {{-500, 0}, {50, 50}}, min, max));
+    CHECK_FALSE(get_visible_chunks(map, t, {{0, 20000}, {500, 20500}}, min, max));
+
+    MESSAGE("Scaled maps cover more chunks per view");
+    t.world_scale = {0.5f, 0.5f};
+    REQUIRE(get_visible_chunks(map, t, {{100, 0}, {612, 10}}, min, max));
+    CHECK(max.x == 2);
+
+    MESSAGE("An unbounded view sees the whole map");
+    REQUIRE(get_visible_chunks(map, t, {glm::vec2(-FLT_MAX), glm::vec2(FLT_MAX)}, min, max));
+    CHECK(max == glm::ivec2(map.chunks_x - 1, map.chunks_y - 1));
+}
+
+TEST_CASE("TileMap2D round-trips through the binary format") {
+    TileMap2D map{.texture_name = "tiles.png", .tile_size = {8, 12}};
+    resize_tilemap(map, 300, 70);
+
+    for (int x = 0; x < 300; x++) {
+        set_tile(map, x, 69, 2);
+    }
+    set_tile(map, 150, 10, 4);
+
+    REQUIRE(save_tilemap(map, "user://test_tilemap.etm"));
+
+    TileMap2D loaded;
+    REQUIRE(load_tilemap(loaded, "user://test_tilemap.etm"));
+
+    CHECK(loaded.texture_name == "tiles.png");
+    CHECK(loaded.tile_size == glm::vec2(8, 12));
+    CHECK(loaded.width == 300);
+    CHECK(loaded.height == 70);
+    CHECK(get_tile(loaded, 150, 10) == 4);
+    CHECK(get_tile(loaded, 299, 69) == 2);
+    CHECK(get_tile(loaded, 0, 0) == TILE_EMPTY);
+
+    size_t tiles = 0;
+    for (const TileChunk2D& chunk : loaded.chunks) {
+        tiles += chunk.tile_count;
+    }
+    CHECK(tiles == 301);
+}
+
+TEST_CASE("TileMap2D rejects truncated binary files") {
+    TileMap2D source{.texture_name = "tiles.png", .tile_size = {8, 8}};
+    resize_tilemap(source, 64, 64);
+
+    for (int x = 0; x < 64; x += 2) {
+        set_tile(source, x, 63, 3);
+    }
+
+    REQUIRE(save_tilemap(source, "user://test_tilemap.etm"));
+
+    std::string bytes;
+    {
+        FileAccess file("user://test_tilemap.etm", ModeFlags::READ);
+        bytes = file.get_file_as_str();
+    }
+    REQUIRE(bytes.size() > 8);
+
+    TileMap2D map{.texture_name = "old.png", .tile_size = {4, 4}};
+    resize_tilemap(map, 2, 2);
+    set_tile(map, 1, 1, 7);
+
+    const auto load_bytes = [&](const std::string& content) -> bool {
+        {
+            FileAccess file("user://test_tilemap_truncated.etm", ModeFlags::WRITE);
+            CHECK(file.store_string(content));
+        }
+        return load_tilemap(map, "user://test_tilemap_truncated.etm");
+    };
+
+    MESSAGE("Cut in the tile runs, in the header, and a NaN tile size");
+    CHECK_FALSE(load_bytes(bytes.substr(0, bytes.size() - 2)));
+    CHECK_FALSE(load_bytes(bytes.substr(0, 8)));
+
+    TileMap2D nan_size{.tile_size = {NAN, 8}};
+    REQUIRE(save_tilemap(nan_size, "user://test_tilemap.etm"));
+    {
+        FileAccess file("user://test_tilemap.etm", ModeFlags::READ);
+        CHECK_FALSE(load_bytes(file.get_file_as_str()));
+    }
+
+    CHECK(map.width == 2);
+    CHECK(map.texture_name == "old.png");
+    CHECK(map.tile_size == glm::vec2(4, 4));
+    CHECK(get_tile(map, 1, 1) == 7);
+
+    REQUIRE(load_bytes(bytes));
+    CHECK(map.width == 64);
+    CHECK(get_tile(map, 62, 63) == 3);
+}
+
+TEST_CASE("TileMap2D rejects malformed json without throwing") {
+    const auto load_text = [](TileMap2D& map, const std::string& text) -> bool {
+        {
+            FileAccess file("user://test_tilemap.json", ModeFlags::WRITE);
+            CHECK(file.store_string(text));
+        }
+        return load_tilemap(map, "user://test_tilemap.json");
+    };
+
+    TileMap2D map;
+    REQUIRE(load_text(map, R"({"width": 2, "height": 2, "tile_size": [8, 8], "texture": "tiles.png", "tiles": [1, 0, 0, 65535]})"));
+    CHECK(map.width == 2);
+    CHECK(get_tile(map, 1, 1) == 65535);
+
+    MESSAGE("Wrong types and out of range values leave the map as it was");
+    CHECK_FALSE(load_text(map, R"({"width": "2", "height": 2, "tiles": []})"));
+    CHECK_FALSE(load_text(map, R"({"width": -2, "height": 2, "tiles": []})"));
+    CHECK_FALSE(load_text(map, R"({"width": 100000, "height": 100000, "tiles": []})"));
+    CHECK_FALSE(load_text(map, R"({"width": 1, "height": 1, "tile_size": ["8", 8], "tiles": [1]})"));
+    CHECK_FALSE(load_text(map, R"({"width": 1, "height": 1, "tile_size": [0, 8], "tiles": [1]})"));
+    CHECK_FALSE(load_text(map, R"({"width": 1, "height": 1, "tile_size": [8, -1], "tiles": [1]})"));
+    CHECK_FALSE(load_text(map, R"({"width": 1, "height": 1, "texture": 3, "tiles": [1]})"));
+    CHECK_FALSE(load_text(map, R"({"width": 2, "height": 1, "tiles": [1, 65536]})"));
+    CHECK_FALSE(load_text(map, R"({"width": 2, "height": 1, "tiles": [1, -1]})"));
+    CHECK_FALSE(load_text(map, R"({"width": 2, "height": 1, "tiles": [1, "a"]})"));
+    CHECK_FALSE(load_text(map, R"([1, 2])"));
+
+    CHECK(map.width == 2);
+    CHECK(map.texture_name == "tiles.png");
+    CHECK(get_tile(map, 0, 0) == 1);
+}
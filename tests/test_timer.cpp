@@ -0,0 +1,24 @@
+#include "core/system/timer.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("Timer fixed step accumulator") {
+    Timer timer;
+    timer.start();
+    timer.fixed_delta     = 1.0 / 50.0;
+    timer.max_fixed_steps = 4;
+
+    MESSAGE("A short frame leaves the time in the accumulator");
+    timer.delta = 0.01;
+    CHECK(timer.consume_fixed_steps() == 0);
+    CHECK(timer.get_fixed_alpha() == doctest::Approx(0.5f));
+
+    MESSAGE("Leftover time carries over to the next frame");
+    timer.delta = 0.035;
+    CHECK(timer.consume_fixed_steps() == 2);
+    CHECK(timer.get_fixed_alpha() == doctest::Approx(0.25f).epsilon(0.001));
+
+    MESSAGE("Long frames are clamped to avoid the spiral of death");
+    timer.delta = 1.0;
+    CHECK(timer.consume_fixed_steps() == 4);
+    CHECK(timer.get_fixed_alpha() < 1.0f);
+}
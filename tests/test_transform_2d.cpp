@@ -0,0 +1,138 @@
+#include "core/component/logic/system_helper.h"
+#include <doctest/doctest.h>
+
+TEST_CASE("Transform2D propagation rotates the child offset by its parent") {
+    Transform2D parent{.position = {100, 50}, .scale = {2, 2}, .rotation = glm::half_pi<float>()};
+    Transform2D child{.position = {10, 0}, .rotation = 0.25f};
+
+    REQUIRE(propagate_transform_2d(parent, nullptr, nullptr, 1.0f));
+    REQUIRE(propagate_transform_2d(child, &parent, nullptr, 1.0f));
+
+    // (10, 0) scaled by 2 and rotated by 90 degrees
+    CHECK(child.world_position.x == doctest::Approx(100.0f));
+    CHECK(child.world_position.y == doctest::Approx(70.0f));
+    CHECK(child.world_scale.x == doctest::Approx(2.0f));
+    CHECK(child.world_scale.y == doctest::Approx(2.0f));
+    CHECK(child.world_rotation == doctest::Approx(glm::half_pi<float>() + 0.25f));
+}
+
+TEST_CASE("Transform2D propagation skips unchanged entities") {
+    Transform2D parent{.position = {5, 5}};
+    Transform2D child{.position = {1, 2}};
+
+    propagate_transform_2d(parent, nullptr, nullptr, 1.0f);
+    propagate_transform_2d(child, &parent, nullptr, 1.0f);
+
+    const Uint32 child_version = child.world_version;
+
+    MESSAGE("Nothing changed");
+    CHECK_FALSE(propagate_transform_2d(parent, nullptr, nullptr, 1.0f));
+    CHECK_FALSE(propagate_transform_2d(child, &parent, nullptr, 1.0f));
+    CHECK(child.world_version == child_version);
+
+    MESSAGE("Moving the parent dirties the child");
+    parent.position.x = 15;
+    CHECK(propagate_transform_2d(parent, nullptr, nullptr, 1.0f));
+    CHECK(propagate_transform_2d(child, &parent, nullptr, 1.0f));
+    CHECK(child.world_position.x == doctest::Approx(16.0f));
+
+    MESSAGE("is_dirty forces a recompute");
+    child.is_dirty = true;
+    CHECK(propagate_transform_2d(child, &parent, nullptr, 1.0f));
+    CHECK_FALSE(child.is_dirty);
+}
+
+TEST_CASE("Transform2D propagation follows a reparent between static parents") {
+    Transform2D left{.position = {-50, 0}};
+    Transform2D right{.position = {50, 0}};
+    Transform2D child{.position = {1, 0}};
+
+    propagate_transform_2d(left, nullptr, nullptr, 1.0f);
+    propagate_transform_2d(right, nullptr, nullptr, 1.0f);
+    REQUIRE(left.world_version == right.world_version);
+
+    CHECK(propagate_transform_2d(child, &left, nullptr, 1.0f, 1));
+    CHECK(child.world_position.x == doctest::Approx(-49.0f));
+    CHECK_FALSE(propagate_transform_2d(child, &left, nullptr, 1.0f, 1));
+
+    MESSAGE("Same parent version, different parent");
+    CHECK(propagate_transform_2d(child, &right, nullptr, 1.0f, 2));
+    CHECK(child.world_position.x == doctest::Approx(51.0f));
+
+    flecs::world world;
+
+    world.system<Transform2D>().kind(flecs::PreUpdate).without<Transform2D>().up().each([](Transform2D& t) {
+        propagate_transform_2d(t, nullptr, nullptr, 1.0f);
+    });
+    world.system<Transform2D, const Transform2D>().kind(flecs::PreUpdate).term_at(1).cascade().each(
+        [](flecs::iter& it, size_t, Transform2D& t, const Transform2D& parent) { propagate_transform_2d(t, &parent, nullptr, 1.0f, it.src(1)); });
+
+    auto first  = world.entity().set<Transform2D>({.position = {0, 100}});
+    auto second = world.entity().set<Transform2D>({.position = {0, 200}});
+    auto leaf   = world.entity().child_of(first).set<Transform2D>({.position = {1, 1}});
+
+    world.progress();
+    CHECK(leaf.get<Transform2D>().world_position.y == doctest::Approx(101.0f));
+
+    leaf.child_of(second);
+    world.progress();
+    CHECK(leaf.get<Transform2D>().world_position.y == doctest::Approx(201.0f));
+}
+
+TEST_CASE("Transform2D cascade systems resolve parents first") {
+    flecs::world world;
+
+    world.system<Transform2D>().kind(flecs::PreUpdate).without<Transform2D>().up().each([](Transform2D& t) {
+        propagate_transform_2d(t, nullptr, nullptr, 1.0f);
+    });
+    world.system<Transform2D, const Transform2D>().kind(flecs::PreUpdate).term_at(1).cascade().each(
+        [](Transform2D& t, const Transform2D& parent) { propagate_transform_2d(t, &parent, nullptr, 1.0f); });
+
+    auto root = world.entity().set<Transform2D>({.position = {10, 0}});
+    auto mid  = world.entity().child_of(root).set<Transform2D>({.position = {0, 10}});
+
+    auto leaf = world.entity().child_of(mid).set<Transform2D>({.position = {1, 1}});
+
+    world.progress();
+    CHECK(leaf.get<Transform2D>().world_position.x == doctest::Approx(11.0f));
+    CHECK(leaf.get<Transform2D>().world_position.y == doctest::Approx(11.0f));
+
+    root.get_mut<Transform2D>().position.y = 5;
+    world.progress();
+    CHECK(leaf.get<Transform2D>().world_position.y == doctest::Approx(16.0f));
+}
+
+TEST_CASE("Render interpolation blends rotations along the shortest arc") {
+    const float pi = glm::pi<float>();
+
+    MESSAGE("A 2D angle wrapped from just under 2pi to just over 0 stays close to 0");
+    CHECK(mix_angle(glm::two_pi<float>() - 0.1f, 0.1f, 0.5f) == doctest::Approx(0.0f).epsilon(1e-4));
+    CHECK(mix_angle(0.1f, glm::two_pi<float>() - 0.1f, 0.5f) == doctest::Approx(glm::two_pi<float>())); // same as 0, next to `to`
+    CHECK(mix_angle(0.5f, 1.5f, 0.5f) == doctest::Approx(1.0f));
+    CHECK(mix_angle(-3.0f * pi, 0.25f, 1.0f) == doctest::Approx(0.25f));
+
+    const Interpolation2D previous_2d{.rotation = glm::two_pi<float>() - 0.2f, .is_valid = true};
+    const Transform2D current_2d{.rotation = 0.0f};
+    CHECK(SDL_fabsf(interpolate_transform_2d(current_2d, previous_2d, 0.5f).rotation + 0.1f) < 1e-4f);
+
+    MESSAGE("A 3D rotation wrapped the same way turns by 0.1 rad, not by almost a full turn");
+    Interpolation3D previous_3d;
+    previous_3d.previous.rotation = {0.0f, glm::two_pi<float>() - 0.1f, 0.0f};
+    previous_3d.is_valid          = true;
+
+    Transform3D current_3d;
+    current_3d.rotation = {0.0f, 0.1f, 0.0f};
+
+    const Transform3D halfway = interpolate_transform_3d(current_3d, previous_3d, 0.5f);
+    const glm::mat4 expected  = glm::mat4(1.0f); // halfway between -0.1 and 0.1 around y
+
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            CHECK(halfway.get_model_matrix()[column][row] == doctest::Approx(expected[column][row]).epsilon(1e-4));
+        }
+    }
+
+    MESSAGE("Alpha 1 gives the current orientation");
+    const Transform3D end = interpolate_transform_3d(current_3d, previous_3d, 1.0f);
+    CHECK(end.get_model_matrix()[0][2] == doctest::Approx(current_3d.get_model_matrix()[0][2]).epsilon(1e-4));
+}
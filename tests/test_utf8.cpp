@@ -0,0 +1,66 @@
+#include "core/ember_utils.h"
+#include <doctest/doctest.h>
+
+namespace {
+
+    std::vector<std::pair<std::string, bool>> collect_runs(const std::string& text) {
+        std::vector<std::pair<std::string, bool>> runs;
+        for_each_text_run(text, [&](const TextRun& run) { runs.emplace_back(text.substr(run.offset, run.length), run.is_emoji); });
+        return runs;
+    }
+
+} // namespace
+
+TEST_CASE("utf8_decode never reads past the end") {
+    const char truncated[] = "\xE2\x82"; // first two bytes of U+20AC
+    size_t index           = 0;
+
+    CHECK(utf8_decode(truncated, 2, index) == UTF8_REPLACEMENT_CHARACTER);
+    CHECK(index == 1);
+
+    const std::string valid = "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"; // é € 😀
+    CHECK(utf8_to_utf32(valid) == std::vector<uint32_t>{0xE9, 0x20AC, 0x1F600});
+
+    MESSAGE("Overlong and surrogate encodings are rejected");
+    index = 0;
+    CHECK(utf8_decode("\xC0\xAF", 2, index) == UTF8_REPLACEMENT_CHARACTER);
+    index = 0;
+    CHECK(utf8_decode("\xED\xA0\x80", 3, index) == UTF8_REPLACEMENT_CHARACTER);
+}
+
+TEST_CASE("utf8_skip_ascii stops at the first multi-byte sequence") {
+    std::string text(100, 'a');
+    CHECK(utf8_skip_ascii(text.data(), text.size(), 0) == 100);
+
+    text[37] = '\xC3';
+    text[38] = '\xA9';
+    CHECK(utf8_skip_ascii(text.data(), text.size(), 0) == 37);
+    CHECK(utf8_skip_ascii(text.data(), text.size(), 39) == 100);
+}
+
+TEST_CASE("Text runs split emoji from text over the source bytes") {
+    CHECK(collect_runs("").empty());
+    CHECK(collect_runs("plain") == std::vector<std::pair<std::string, bool>>{{"plain", false}});
+
+    const auto runs = collect_runs("Hi \xF0\x9F\x92\x80 there \xE6\x97\xA5");
+    REQUIRE(runs.size() == 3);
+    CHECK(runs[0] == std::pair<std::string, bool>{"Hi ", false});
+    CHECK(runs[1] == std::pair<std::string, bool>{"\xF0\x9F\x92\x80", true});
+    CHECK(runs[2] == std::pair<std::string, bool>{" there \xE6\x97\xA5", false});
+
+    MESSAGE("Joiners stay inside the emoji run");
+    const auto family = collect_runs("\xF0\x9F\x91\xA8\xE2\x80\x8D\xF0\x9F\x91\xA9!");
+    REQUIRE(family.size() == 2);
+    CHECK(family[0].second);
+    CHECK(family[1] == std::pair<std::string, bool>{"!", false});
+}
+
+TEST_CASE("is_character_emoji matches the emoji font ranges") {
+    CHECK(is_character_emoji(0x1F600));
+    CHECK(is_character_emoji(0x1F480));
+    CHECK(is_character_emoji(0x2764));
+    CHECK(is_character_emoji(0x1FAFF));
+    CHECK_FALSE(is_character_emoji('a'));
+    CHECK_FALSE(is_character_emoji(0x1F650));
+    CHECK_FALSE(is_character_emoji(0x1FB00));
+}
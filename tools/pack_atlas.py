@@ -0,0 +1,227 @@
+"""Packs the PNGs of a folder into texture atlas pages and writes the manifest read by TextureAtlas::load_manifest.
+
+Region names are the image paths relative to the input folder, without extension ("ui/icons/play").
+Uses the same skyline bottom-left packer as the engine (engine/private/core/renderer/texture_atlas.cpp).
+
+    python tools/pack_atlas.py <input_folder> <output_folder> [--page-size 2048] [--padding 1] [--max-size 256]
+"""
+import argparse, json, os, struct, sys, zlib
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}  # color type -> samples per pixel
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """Decodes an 8-bit, non-interlaced PNG to (width, height, RGBA bytearray)."""
+    data = open(path, "rb").read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError("not a PNG")
+
+    pos, idat, palette, alpha = 8, b"", None, None
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = chunk
+        elif kind == b"tRNS":
+            alpha = chunk
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+
+    if depth != 8 or interlace != 0 or color not in CHANNELS:
+        raise ValueError("only 8-bit non-interlaced PNGs are supported")
+
+    bpp = CHANNELS[color]
+    stride = width * bpp
+    raw = zlib.decompress(idat)
+    rows, previous = [], bytearray(stride)
+
+    for y in range(height):
+        filter_type = raw[y * (stride + 1)]
+        row = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            left = row[i - bpp] if i >= bpp else 0
+            up = previous[i]
+            up_left = previous[i - bpp] if i >= bpp else 0
+            if filter_type == 1:
+                row[i] = (row[i] + left) & 0xFF
+            elif filter_type == 2:
+                row[i] = (row[i] + up) & 0xFF
+            elif filter_type == 3:
+                row[i] = (row[i] + ((left + up) >> 1)) & 0xFF
+            elif filter_type == 4:
+                row[i] = (row[i] + paeth(left, up, up_left)) & 0xFF
+        rows.append(row)
+        previous = row
+
+    rgba = bytearray(width * height * 4)
+    for y, row in enumerate(rows):
+        for x in range(width):
+            o = (y * width + x) * 4
+            if color == 6:
+                rgba[o:o + 4] = row[x * 4:x * 4 + 4]
+            elif color == 2:
+                rgba[o:o + 4] = row[x * 3:x * 3 + 3] + b"\xff"
+            elif color == 4:
+                rgba[o:o + 4] = bytes((row[x * 2],) * 3 + (row[x * 2 + 1],))
+            elif color == 0:
+                rgba[o:o + 4] = bytes((row[x],) * 3 + (255,))
+            else:
+                index = row[x]
+                a = alpha[index] if alpha and index < len(alpha) else 255
+                rgba[o:o + 4] = palette[index * 3:index * 3 + 3] + bytes((a,))
+    return width, height, rgba
+
+
+def write_png(path, width, height, rgba):
+    def chunk(kind, payload):
+        return struct.pack(">I", len(payload)) + kind + payload + struct.pack(">I", zlib.crc32(kind + payload) & 0xFFFFFFFF)
+
+    stride = width * 4
+    raw = b"".join(b"\x00" + bytes(rgba[y * stride:(y + 1) * stride]) for y in range(height))
+
+    with open(path, "wb") as out:
+        out.write(PNG_SIGNATURE)
+        out.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)))
+        out.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        out.write(chunk(b"IEND", b""))
+
+
+class SkylinePacker:
+    """Skyline bottom-left, padding on the right/bottom of every rect (same as AtlasPacker)."""
+
+    def __init__(self, width, height, padding):
+        self.width, self.height, self.padding = width, height, padding
+        self.skyline = [[0, 0, width]]  # x, y, width
+
+    def fit(self, index, w, h):
+        x, y = self.skyline[index][0], self.skyline[index][1]
+        if x + w > self.width:
+            return -1
+        width_left, i = w, index
+        while width_left > 0:
+            y = max(y, self.skyline[i][1])
+            if y + h > self.height:
+                return -1
+            width_left -= self.skyline[i][2]
+            i += 1
+        return y
+
+    def insert(self, w, h):
+        if w > self.width or h > self.height:
+            return None
+        pw, ph = min(w + self.padding, self.width), min(h + self.padding, self.height)
+
+        best = None  # (bottom, node width, index, y)
+        for i, node in enumerate(self.skyline):
+            y = self.fit(i, pw, ph)
+            if y >= 0 and (best is None or (y + ph, node[2]) < best[:2]):
+                best = (y + ph, node[2], i, y)
+        if best is None:
+            return None
+
+        _, _, index, y = best
+        x = self.skyline[index][0]
+        self.skyline.insert(index, [x, y + ph, pw])
+
+        i = index + 1
+        while i < len(self.skyline):
+            prev, node = self.skyline[i - 1], self.skyline[i]
+            overlap = prev[0] + prev[2] - node[0]
+            if overlap <= 0:
+                break
+            node[0] += overlap
+            node[2] -= overlap
+            if node[2] > 0:
+                break
+            del self.skyline[i]
+
+        i = 0
+        while i + 1 < len(self.skyline):
+            if self.skyline[i][1] == self.skyline[i + 1][1]:
+                self.skyline[i][2] += self.skyline[i + 1][2]
+                del self.skyline[i + 1]
+            else:
+                i += 1
+        return x, y
+
+
+def pack(folder, out_folder, page_size, padding, max_size):
+    images = []
+    for root, _, files in os.walk(folder):
+        for f in sorted(files):
+            if not f.lower().endswith(".png"):
+                continue
+            path = os.path.join(root, f)
+            name = os.path.splitext(os.path.relpath(path, folder).replace("\\", "/"))[0]
+            try:
+                width, height, rgba = read_png(path)
+            except ValueError as e:
+                print(f"⚠️  Skipped {name}: {e}")
+                continue
+            if width > max_size or height > max_size:
+                print(f"⚠️  Skipped {name}: {width}x{height} exceeds --max-size {max_size}")
+                continue
+            images.append((name, width, height, rgba))
+
+    # Tallest first keeps the skyline flat
+    images.sort(key=lambda image: (-image[2], -image[1]))
+
+    packers, pages, regions = [], [], {}
+    for name, width, height, rgba in images:
+        for page, packer in enumerate(packers):
+            position = packer.insert(width, height)
+            if position:
+                break
+        else:
+            packers.append(SkylinePacker(page_size, page_size, padding))
+            pages.append(bytearray(page_size * page_size * 4))
+            page, position = len(packers) - 1, packers[-1].insert(width, height)
+
+        x, y = position
+        for row in range(height):
+            o = ((y + row) * page_size + x) * 4
+            pages[page][o:o + width * 4] = rgba[row * width * 4:(row + 1) * width * 4]
+        regions[name] = {"page": page, "x": x, "y": y, "w": width, "h": height}
+
+    os.makedirs(out_folder, exist_ok=True)
+    manifest = {"version": 1, "page_size": page_size, "padding": padding, "pages": [], "regions": regions}
+
+    for page, pixels in enumerate(pages):
+        file = f"atlas_{page}.png"
+        write_png(os.path.join(out_folder, file), page_size, page_size, pixels)
+        manifest["pages"].append({"file": file, "width": page_size, "height": page_size})
+
+    with open(os.path.join(out_folder, "atlas.json"), "w") as out:
+        json.dump(manifest, out, indent=2)
+
+    print(f"✅ Packed {len(regions)} images into {len(pages)} page(s)")
+    print(f"✅ Manifest: {os.path.join(out_folder, 'atlas.json')}")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Pack PNGs into texture atlas pages")
+    parser.add_argument("input_folder")
+    parser.add_argument("output_folder")
+    parser.add_argument("--page-size", type=int, default=2048)
+    parser.add_argument("--padding", type=int, default=1)
+    parser.add_argument("--max-size", type=int, default=256)
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.input_folder):
+        sys.exit(f"Input folder not found: {args.input_folder}")
+
+    pack(args.input_folder, args.output_folder, args.page_size, args.padding, args.max_size)